@@ -41,10 +41,19 @@
 #include <sstream>
 #include <random>
 #include <unordered_map>
+#include <list>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <fstream>
 
 #ifndef _WIN32
 #include <netinet/in.h>
 #include <resolv.h>
+#include <poll.h>
+#include <sys/socket.h>
 #else
 #include <winsock2.h>
 #include <windns.h>
@@ -278,14 +287,35 @@ void DBC::set_charset(std::string charset)
   }
 }
 
+/**
+  The character set the connection uses with the given DSN options.
+*/
+const char *DBC::connection_charset(DataSource *dsrc)
+{
+  const char *charset = dsrc->opt_CHARSET;
+
+  // For unicode driver always use UTF8MB4
+  if (unicode)
+    return transport_charset;
+
+  // For ANSI use default charset (latin1) if no chaset
+  // option was specified.
+  if (!charset || !charset[0])
+    return ansi_default_charset;
+
+  return charset;
+}
+
 /**
  If it was specified, set the character set for the connection and
  other internal charset properties.
 
- @param[in]  dbc      Database connection
- @param[in]  charset  Character set name
+ @param[in]  dbc        Database connection
+ @param[in]  charset    Character set name
+ @param[in]  handshake  The session was just opened, asking for the
+                        character set in the handshake
 */
-SQLRETURN DBC::set_charset_options(const char *charset)
+SQLRETURN DBC::set_charset_options(const char *charset, bool handshake)
 try
 {
   SQLRETURN rc = SQL_SUCCESS;
@@ -310,7 +340,10 @@ try
     charset = ansi_default_charset;
   }
 
-  set_charset(charset);
+  // The handshake has set the character set already, unless the server
+  // did not know it. A reset session needs SET NAMES again.
+  if (!handshake || myodbc_strcasecmp(mysql_character_set_name(mysql), charset))
+    set_charset(charset);
   MY_CHARSET_INFO my_charset;
   mysql_get_character_set_info(mysql, &my_charset);
   cxn_charset_info = myodbc::get_charset(my_charset.number, MYF(0));
@@ -348,31 +381,388 @@ catch (const MYERROR& e)
   return e.retcode;
 }
 
-/*
-  Retrieve DNS+SRV list.
+static const char *txn_isolation_name(int txn_isolation)
+{
+  if (txn_isolation & SQL_TXN_SERIALIZABLE)
+    return "SERIALIZABLE";
+  else if (txn_isolation & SQL_TXN_REPEATABLE_READ)
+    return "REPEATABLE READ";
+  else if (txn_isolation & SQL_TXN_READ_COMMITTED)
+    return "READ COMMITTED";
+  return "READ UNCOMMITTED";
+}
 
-  @param[in]  hostname  Full DNS+SRV address (ex: _mysql._tcp.example.com)
-  @param[out]  total_weight   Retrieve sum of total weight.
 
-  @return multimap containing list of SRV records
+/**
+  Bring the session of a connection taken from the pool back to the state
+  DBC::connect() leaves it in. Both mysql_reset_connection() and
+  mysql_change_user() reset the session variables to the global defaults,
+  so only the settings made by the driver are applied again.
 */
+SQLRETURN DBC::restore_session()
+{
+  /* Session variables are the server defaults now */
+  sql_select_limit = (SQLULEN)-1;
+  result_cache_session.clear();
+  result_cache_unsafe = false;
+
+  if (set_charset_options(ds.opt_CHARSET) == SQL_ERROR)
+    return SQL_ERROR;
+
+  if (!SQL_SUCCEEDED(run_initstmt(this, &ds)))
+    return SQL_ERROR;
+
+  /* The current database survives the reset, unless it was changed */
+  const char *opt_db = ds.opt_DATABASE;
+  if (opt_db && (!mysql->db || strcmp(mysql->db, opt_db)))
+  {
+    if (mysql_select_db(mysql, opt_db))
+      return set_error("HY000", mysql_error(mysql), mysql_errno(mysql));
+  }
+  database = opt_db ? opt_db : (mysql->db ? mysql->db : "");
 
+  return set_session_vars();
+}
 
-struct Prio
+
+/**
+  Make the session settings that follow from the connection options and
+  attributes with a single SET statement, instead of one round trip for
+  each of SQL_AUTO_IS_NULL, autocommit and the transaction isolation.
+
+  The statement also turns on schema change tracking, so that the client
+  library keeps mysql->db current and reget_current_catalog() does not
+  need to ask the server.
+*/
+SQLRETURN DBC::set_session_vars()
 {
-  uint16_t prio;
-  uint16_t weight;
-  operator uint16_t() const
+  std::string query;
+  auto add = [&query](const std::string &assignment)
+  {
+    query.append(query.empty() ? "SET " : ", ").append(assignment);
+  };
+
+  /*
+    The MySQL server has a workaround for old versions of Microsoft Access
+    (and possibly other products) that is no longer necessary, but is
+    unfortunately enabled by default. We have to turn it off, or it causes
+    other problems.
+  */
+  if (!ds.opt_AUTO_IS_NULL)
+    add("SQL_AUTO_IS_NULL = 0");
+
+  if (transactions_supported())
+  {
+    if (commit_flag == CHECK_AUTOCOMMIT_OFF && autocommit_is_on() &&
+        !ds.opt_NO_TRANSACTIONS)
+      add("autocommit = 0");
+    else if (commit_flag == CHECK_AUTOCOMMIT_ON && !autocommit_is_on())
+      add("autocommit = 1");
+
+    if (txn_isolation != DEFAULT_TXN_ISOLATION)
+    {
+      std::string level = txn_isolation_name(txn_isolation);
+      std::replace(level.begin(), level.end(), ' ', '-');
+      add((is_minimum_version(mysql->server_version, "5.7.20") ?
+           "transaction_isolation = '" : "tx_isolation = '") + level + "'");
+    }
+  }
+
+  /* A reconnect would lose the setting without the driver noticing */
+  bool track_schema = (mysql->client_flag & CLIENT_SESSION_TRACK) &&
+                      !ds.opt_AUTO_RECONNECT;
+  if (track_schema)
+    add("session_track_schema = ON");
+
+  schema_tracked = false;
+  if (query.empty())
+    return SQL_SUCCESS;
+
+  if (execute_query(query.c_str(), query.length(), true) != SQL_SUCCESS)
+    return SQL_ERROR;
+
+  schema_tracked = track_schema;
+  return SQL_SUCCESS;
+}
+
+
+enum class socket_state { idle, closed, unknown };
+
+/*
+  Look at the socket without blocking or consuming anything. An idle
+  connection has nothing to read, so a readable socket means either the
+  peer has closed it or it sent something nobody asked for, most likely
+  an error just before closing.
+*/
+static socket_state peek_socket(my_socket fd)
+{
+  char c;
+#ifdef _WIN32
+  if (fd == INVALID_SOCKET)
+    return socket_state::idle;
+
+  fd_set rd;
+  timeval tv = {0, 0};
+  FD_ZERO(&rd);
+  FD_SET(fd, &rd);
+  if (select(0, &rd, nullptr, nullptr, &tv) != 1)
+    return socket_state::idle;
+
+  int n = recv(fd, &c, 1, MSG_PEEK);
+#else
+  if (fd < 0)
+    return socket_state::idle;
+
+  pollfd pfd = {fd, POLLIN, 0};
+  int rc = poll(&pfd, 1, 0);
+  if (rc == 0)
+    return socket_state::idle;
+  if (rc < 0)
+    return socket_state::unknown;
+
+  ssize_t n = recv(fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+#endif
+  return n == 0 ? socket_state::closed : socket_state::unknown;
+}
+
+
+/*
+  Sessions parked by SQLDisconnect() on connections with the POOLING
+  option, so that the next connect with the same connection string skips
+  the network, TLS and authentication round trips.
+
+  Sessions are reset before they are parked. The most recently parked
+  session is handed out first, which lets the surplus age out: a
+  background thread closes the sessions that outlived POOL_MAX_LIFETIME
+  and the ones idle for more than POOL_IDLE_TIMEOUT beyond the first
+  POOL_MIN_IDLE.
+*/
+
+class session_pool
+{
+  struct session
+  {
+    MYSQL  *mysql;
+    time_t created;
+    time_t parked;
+  };
+
+  struct bucket
+  {
+    std::list<session> idle;
+    size_t min_idle = 0;
+    time_t max_lifetime = 0;
+  };
+
+  /*
+    Everything the eviction thread touches. The thread holds a reference
+    of its own, so a thread that could not be joined never outlives it.
+  */
+  struct state
+  {
+    std::mutex mtx;
+    std::condition_variable wakeup;
+    std::map<SQLWSTRING, bucket> buckets;
+    bool stopping = false;    // Never reset, clear() starts a new state
+  };
+
+  std::shared_ptr<state> st = std::make_shared<state>();
+  std::thread evictor;
+#ifdef _WIN32
+  // Keeps the driver loaded while the thread runs, see put()
+  HMODULE module = nullptr;
+#endif
+
+  static bool expired(const bucket &b, const session &s, time_t now)
+  {
+    return b.max_lifetime && now - s.created >= b.max_lifetime;
+  }
+
+  static void evict(std::shared_ptr<state> st)
+  {
+    mysql_thread_init();
+    std::unique_lock<std::mutex> lock(st->mtx);
+
+    while (!st->stopping)
+    {
+      st->wakeup.wait_for(lock, std::chrono::seconds(POOL_EVICT_INTERVAL));
+      if (st->stopping)
+        break;
+
+      std::vector<MYSQL*> victims;
+      time_t now = time(nullptr);
+
+      for (auto &el : st->buckets)
+      {
+        bucket &b = el.second;
+        size_t kept = 0;
+        for (auto s = b.idle.begin(); s != b.idle.end();)
+        {
+          if (expired(b, *s, now) ||
+              (kept >= b.min_idle && now - s->parked >= POOL_IDLE_TIMEOUT))
+          {
+            victims.push_back(s->mysql);
+            s = b.idle.erase(s);
+          }
+          else
+          {
+            ++kept;
+            ++s;
+          }
+        }
+      }
+
+      // Closing sends COM_QUIT, don't hold up connects meanwhile
+      lock.unlock();
+      for (MYSQL *m : victims)
+        mysql_close(m);
+      lock.lock();
+    }
+
+    lock.unlock();
+    mysql_thread_end();
+  }
+
+  /* Stop the eviction thread, it only uses its own reference to st then */
+  void stop_evictor()
+  {
+    {
+      std::lock_guard<std::mutex> guard(st->mtx);
+      st->stopping = true;
+    }
+    st->wakeup.notify_all();
+  }
+
+  public:
+
+  ~session_pool()
+  {
+    // Only reached if the driver was never unloaded properly, the
+    // process is exiting then and the thread may be gone already.
+    stop_evictor();
+    if (evictor.joinable())
+      evictor.detach();
+  }
+
+  /*
+    Take an idle session for the given connection string. Sessions that
+    are past their lifetime or whose socket is not idle any more (closed
+    by the server after wait_timeout, for example) are dropped.
+  */
+  MYSQL *get(const SQLWSTRING &key, time_t &created)
   {
-    return prio;
+    std::vector<MYSQL*> victims;
+    MYSQL *found = nullptr;
+    {
+      std::lock_guard<std::mutex> guard(st->mtx);
+      auto it = st->buckets.find(key);
+      if (it == st->buckets.end())
+        return nullptr;
+
+      bucket &b = it->second;
+      time_t now = time(nullptr);
+      while (!found && !b.idle.empty())
+      {
+        session s = b.idle.front();
+        b.idle.pop_front();
+
+        if (expired(b, s, now) ||
+            peek_socket(s.mysql->net.fd) != socket_state::idle)
+        {
+          victims.push_back(s.mysql);
+          continue;
+        }
+
+        found = s.mysql;
+        created = s.created;
+      }
+    }
+
+    for (MYSQL *m : victims)
+      mysql_close(m);
+    return found;
   }
 
-  bool operator < (const Prio &other) const
+  /*
+    Park a session. Returns false if the pool already holds max_idle
+    sessions for the connection string, the caller closes it then.
+  */
+  bool put(const SQLWSTRING &key, MYSQL *mysql, time_t created,
+           const DataSource &ds)
   {
-    return prio < other.prio;
+    std::lock_guard<std::mutex> guard(st->mtx);
+    if (st->stopping)
+      return false;
+
+    bucket &b = st->buckets[key];
+    b.min_idle = (size_t)ds.opt_POOL_MIN_IDLE;
+    b.max_lifetime = (time_t)ds.opt_POOL_MAX_LIFETIME;
+
+    if (b.idle.size() >= (size_t)ds.opt_POOL_MAX_IDLE)
+      return false;
+
+    b.idle.push_front({mysql, created, time(nullptr)});
+
+    if (!evictor.joinable())
+    {
+#ifdef _WIN32
+      /*
+        FreeLibrary() can't unload the driver under the thread. DllMain
+        can't wait for it, clear() stops it before the driver is unloaded.
+      */
+      GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS,
+                         reinterpret_cast<LPCWSTR>(&session_pool::evict),
+                         &module);
+#endif
+      evictor = std::thread(&session_pool::evict, st);
+    }
+    return true;
+  }
+
+  /*
+    Close all parked sessions, stop the eviction thread and wait for it.
+    Called with no handles left to use the pool: when the last environment
+    handle is freed on Windows, where the driver may be unloaded next, and
+    when the driver is shut down.
+  */
+  void clear()
+  {
+    std::vector<MYSQL*> victims;
+    {
+      std::lock_guard<std::mutex> guard(st->mtx);
+      for (auto &el : st->buckets)
+        for (auto &s : el.second.idle)
+          victims.push_back(s.mysql);
+      st->buckets.clear();
+    }
+
+    stop_evictor();
+    if (evictor.joinable())
+      evictor.join();
+#ifdef _WIN32
+    if (module)
+    {
+      // The caller is in the driver, its own reference keeps it loaded
+      FreeLibrary(module);
+      module = nullptr;
+    }
+#endif
+
+    for (MYSQL *m : victims)
+      mysql_close(m);
+
+    // The driver may be initialized again, with a thread of its own
+    st = std::make_shared<state>();
   }
 };
 
+static session_pool global_session_pool;
+
+void clear_session_pool() {
+  global_session_pool.clear();
+}
+
+
 struct Srv_host_detail
 {
   std::string name;
@@ -416,102 +806,889 @@ std::vector<Srv_host_detail> parse_host_list(const char* hosts_str,
         by cheking if end pointer was updated.
       */
 
-      if ((val == 0 && tmp_port.length()==0) ||
-          (val > 65535 || val < 0))
+      if ((val == 0 && tmp_port.length()==0) ||
+          (val > 65535 || val < 0))
+      {
+        std::stringstream err;
+        err << "Invalid port value in " << hosts;
+        throw err.str();
+      }
+
+      host_detail.port = static_cast<uint16_t>(val);
+    }
+    else
+    {
+      host_detail.port = default_port;
+    }
+
+    pos_i = pos_f+1;
+
+    list.push_back(host_detail);
+  }while (pos_f < hosts.size());
+
+  return list;
+}
+
+
+class dbc_guard
+{
+  DBC *m_dbc;
+  bool m_success = false;
+  public:
+
+  dbc_guard(DBC *dbc) : m_dbc(dbc) {}
+  void set_success(bool success) { m_success = success; }
+  ~dbc_guard() { if (!m_success) m_dbc->close(); }
+};
+
+
+MYSQL *new_mysql()
+{
+  static struct init
+  {
+    init(){ mysql_library_init(0, nullptr, nullptr); }
+  }
+  do_init;
+
+  return mysql_init(nullptr);
+}
+
+
+/*
+  Tell whether a failed connect is the fault of the host or the network,
+  in which case another host of a MULTI_HOST list is worth a try.
+*/
+static bool is_network_error(unsigned int native_error, const char *sqlstate)
+{
+  switch (native_error)
+  {
+  case ER_CON_COUNT_ERROR:
+  case CR_SOCKET_CREATE_ERROR:
+  case CR_CONNECTION_ERROR:
+  case CR_CONN_HOST_ERROR:
+  case CR_IPSOCK_ERROR:
+  case CR_UNKNOWN_HOST:
+    return true;
+  }
+  // SQLSTATE 08xxx is used for network errors
+  return sqlstate && strncmp(sqlstate, "08", 2) == 0;
+}
+
+
+/*
+  What the process learned from connecting to the hosts of MULTI_HOST
+  lists. A host that failed is tried last for a while, longer after each
+  consecutive failure, and hosts much slower than the fastest one are
+  tried after the others.
+*/
+
+class host_health_cache
+{
+  struct health
+  {
+    time_t failed_at = 0;
+    unsigned int failures = 0;
+    double latency = 0;   // Smoothed connect time in milliseconds
+  };
+
+  std::mutex mtx;
+  std::map<std::string, health> hosts;
+
+  static std::string key(const Srv_host_detail &host)
+  {
+    return host.name + ":" + std::to_string(host.port);
+  }
+
+  static bool backing_off(const health &h, time_t now)
+  {
+    if (!h.failures)
+      return false;
+    time_t backoff = (time_t)HOST_BACKOFF_MIN << std::min(h.failures - 1, 6u);
+    return now - h.failed_at < std::min(backoff, (time_t)HOST_BACKOFF_MAX);
+  }
+
+  public:
+
+  void success(const Srv_host_detail &host, double msec)
+  {
+    std::lock_guard<std::mutex> guard(mtx);
+    health &h = hosts[key(host)];
+    h.failures = 0;
+    h.latency = h.latency ? 0.7 * h.latency + 0.3 * msec : msec;
+  }
+
+  void failure(const Srv_host_detail &host)
+  {
+    std::lock_guard<std::mutex> guard(mtx);
+    health &h = hosts[key(host)];
+    h.failed_at = time(nullptr);
+    ++h.failures;
+  }
+
+  /*
+    Put the hosts in the order to try them. With `balance` the order is
+    random, as it always was, to spread the load, and slow hosts go after
+    the fast ones. Otherwise the given order is the preference, as for
+    DNS SRV targets. Either way hosts that failed recently come last.
+  */
+  void order(std::vector<Srv_host_detail> &list, bool balance)
+  {
+    if (balance)
+    {
+      std::random_device rd;
+      std::mt19937 generator(rd());
+      std::shuffle(list.begin(), list.end(), generator);
+    }
+
+    std::vector<int> rank(list.size(), 0);
+    {
+      std::lock_guard<std::mutex> guard(mtx);
+      time_t now = time(nullptr);
+      double best = 0;
+      std::vector<const health*> known(list.size(), nullptr);
+
+      for (size_t i = 0; i < list.size(); ++i)
+      {
+        auto it = hosts.find(key(list[i]));
+        if (it == hosts.end())
+          continue;
+        if (backing_off(it->second, now))
+        {
+          rank[i] = 2;
+          continue;
+        }
+        known[i] = &it->second;
+        if (known[i]->latency && (!best || known[i]->latency < best))
+          best = known[i]->latency;
+      }
+
+      for (size_t i = 0; balance && i < list.size(); ++i)
+      {
+        if (known[i] && known[i]->latency > 2 * best)
+          rank[i] = 1;
+      }
+    }
+
+    std::vector<size_t> idx(list.size());
+    for (size_t i = 0; i < idx.size(); ++i)
+      idx[i] = i;
+    std::stable_sort(idx.begin(), idx.end(),
+                     [&rank](size_t a, size_t b) { return rank[a] < rank[b]; });
+
+    std::vector<Srv_host_detail> sorted;
+    for (size_t i : idx)
+      sorted.push_back(list[i]);
+    list.swap(sorted);
+  }
+};
+
+static host_health_cache host_health;
+
+
+/*
+  TLS sessions to resume, by server and TLS settings. Resuming a session
+  saves the certificate exchange and key agreement of a full handshake.
+*/
+
+class tls_session_cache
+{
+  std::mutex mtx;
+  std::map<std::string, std::string> sessions;
+
+  public:
+
+  static std::string key(DataSource *ds, const char *host, unsigned int port)
+  {
+    std::string key = std::string(host ? host : "") + ":" +
+                      std::to_string(port);
+    for (const char *opt : { (const char*)ds->opt_SSL_MODE,
+                             (const char*)ds->opt_SSL_KEY,
+                             (const char*)ds->opt_SSL_CERT,
+                             (const char*)ds->opt_SSL_CA,
+                             (const char*)ds->opt_SSL_CAPATH,
+                             (const char*)ds->opt_SSL_CIPHER,
+                             (const char*)ds->opt_SSL_CRL,
+                             (const char*)ds->opt_SSL_CRLPATH,
+                             (const char*)ds->opt_TLS_VERSIONS })
+    {
+      key.append("|").append(opt ? opt : "");
+    }
+    key.append(ds->opt_NO_TLS_1_2 ? "|1" : "|0");
+    key.append(ds->opt_NO_TLS_1_3 ? "|1" : "|0");
+    return key;
+  }
+
+  /* Let the handle resume the session cached for the key, if any */
+  void offer(MYSQL *mysql, const std::string &key)
+  {
+#if MYSQL_VERSION_ID >= 80029
+    std::lock_guard<std::mutex> guard(mtx);
+    auto it = sessions.find(key);
+    if (it != sessions.end())
+      mysql_options(mysql, MYSQL_OPT_SSL_SESSION_DATA, it->second.c_str());
+#endif
+  }
+
+  /*
+    Cache the session of a new connection for the next one.
+
+    @return true if the connection resumed a cached session.
+  */
+  bool save(MYSQL *mysql, const std::string &key)
+  {
+#if MYSQL_VERSION_ID >= 80029
+    if (!mysql_get_ssl_cipher(mysql))
+      return false;
+
+    unsigned int len = 0;
+    void *data = mysql_get_ssl_session_data(mysql, 0, &len);
+    if (data)
+    {
+      std::lock_guard<std::mutex> guard(mtx);
+      sessions[key].assign((const char*)data, len);
+      mysql_free_ssl_session_data(mysql, data);
+    }
+    return mysql_get_ssl_session_reused(mysql);
+#else
+    return false;
+#endif
+  }
+};
+
+static tls_session_cache tls_sessions;
+
+void offer_tls_session(MYSQL *mysql, DataSource *ds, const char *host,
+                       unsigned int port)
+{
+  tls_sessions.offer(mysql, tls_session_cache::key(ds, host, port));
+}
+
+bool save_tls_session(MYSQL *mysql, DataSource *ds, const char *host,
+                      unsigned int port)
+{
+  return tls_sessions.save(mysql, tls_session_cache::key(ds, host, port));
+}
+
+
+/*
+  Threads the driver leaves running in the background: connect attempts
+  that lost a MULTI_HOST race and DNS SRV refreshes. They are joined
+  before the driver may be unloaded, see join_background_threads(). On
+  Windows they hold a reference to the driver meanwhile, so FreeLibrary()
+  can't unload it under them.
+*/
+static class background_thread_set
+{
+  std::mutex mtx;
+  std::map<std::thread::id, std::thread> threads;
+  std::vector<std::thread::id> finished;    // Called leave(), to be joined
+#ifdef _WIN32
+  HMODULE module = nullptr;
+#endif
+
+  /* Join the threads that are done, with mtx held */
+  void reap()
+  {
+    for (std::thread::id id : finished)
+    {
+      auto it = threads.find(id);
+      it->second.join();
+      threads.erase(it);
+    }
+    finished.clear();
+  }
+
+  public:
+
+  ~background_thread_set()
+  {
+    // Only reached if the driver was never shut down, the process is
+    // exiting then.
+    for (auto &el : threads)
+      el.second.detach();
+  }
+
+  template <typename F, typename... Args>
+  void start(F &&f, Args&&... args)
+  {
+    std::lock_guard<std::mutex> guard(mtx);
+    reap();
+#ifdef _WIN32
+    if (!module)
+      GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS,
+                         reinterpret_cast<LPCWSTR>(this), &module);
+#endif
+    std::thread t(std::forward<F>(f), std::forward<Args>(args)...);
+    std::thread::id id = t.get_id();
+    threads.emplace(id, std::move(t));
+  }
+
+  /* The last thing a thread started by start() does */
+  void leave()
+  {
+    std::lock_guard<std::mutex> guard(mtx);
+    if (threads.count(std::this_thread::get_id()))
+      finished.push_back(std::this_thread::get_id());
+  }
+
+  void join()
+  {
+    std::map<std::thread::id, std::thread> running;
+#ifdef _WIN32
+    HMODULE held;
+#endif
+    {
+      std::lock_guard<std::mutex> guard(mtx);
+      running.swap(threads);
+      finished.clear();
+#ifdef _WIN32
+      held = module;
+      module = nullptr;
+#endif
+    }
+
+    for (auto &el : running)
+      el.second.join();
+
+#ifdef _WIN32
+    // The caller is in the driver, its own reference keeps it loaded
+    if (held)
+      FreeLibrary(held);
+#endif
+  }
+} background_threads;
+
+/*
+  Wait for the background threads to finish. Called with no handles left,
+  before the driver may be unloaded: when the last environment handle is
+  freed on Windows and when the driver is shut down otherwise. Never from
+  DllMain, where a thread can't exit. A connect attempt can take up to
+  its connect timeout.
+*/
+void join_background_threads()
+{
+  background_threads.join();
+}
+
+
+/* Outcome of connecting to one of several hosts */
+struct connect_attempt
+{
+  MYSQL *mysql = nullptr;
+  Srv_host_detail host;
+  std::string tls_key;            // See tls_session_cache
+  bool tls_reused = false;
+  bool fatal = false;             // Not worth trying another host
+  unsigned int native_error = 0;
+  std::string message;
+};
+
+
+/*
+  State shared by the connecting DBC and the threads of its connect
+  attempts. It is reference counted because losing attempts may still
+  run when the DBC is done.
+*/
+struct connect_race
+{
+  struct param
+  {
+    bool null;
+    std::string val;
+    param(const char *v) : null(!v), val(v ? v : "") {}
+    const char *get() const { return null ? nullptr : val.c_str(); }
+  };
+
+  param user, pwd, db, socket;
+  unsigned long flags;
+
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::vector<connect_attempt> attempts;
+  size_t running = 0;
+  size_t failed = 0;
+  int winner = -1;
+  int fatal = -1;
+  bool abandoned = false;   // Nobody is waiting for the outcome
+
+  connect_race(DataSource *dsrc, unsigned long f) :
+    user((const char*)dsrc->opt_UID), pwd((const char*)dsrc->opt_PWD),
+    db((const char*)dsrc->opt_DATABASE), socket((const char*)dsrc->opt_SOCKET),
+    flags(f)
+  {}
+};
+
+
+static void run_connect_attempt(std::shared_ptr<connect_race> race,
+                                size_t idx)
+{
+  mysql_thread_init();
+
+  // Nobody else touches the attempt before it is marked as done
+  connect_attempt &a = race->attempts[idx];
+  auto start = std::chrono::steady_clock::now();
+  bool ok = mysql_real_connect(a.mysql, a.host.name.c_str(),
+                               race->user.get(), race->pwd.get(),
+                               race->db.get(), a.host.port,
+                               race->socket.get(), race->flags) != nullptr;
+  bool network_error = !ok && is_network_error(mysql_errno(a.mysql),
+                                               mysql_sqlstate(a.mysql));
+  if (ok)
+  {
+    std::chrono::duration<double, std::milli> msec =
+      std::chrono::steady_clock::now() - start;
+    host_health.success(a.host, msec.count());
+    a.tls_reused = tls_sessions.save(a.mysql, a.tls_key);
+  }
+  else if (network_error)
+  {
+    host_health.failure(a.host);
+  }
+
+  MYSQL *unwanted = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(race->mtx);
+    --race->running;
+
+    if (ok && race->winner < 0 && !race->abandoned)
+    {
+      race->winner = (int)idx;
+    }
+    else
+    {
+      if (!ok)
+      {
+        a.native_error = mysql_errno(a.mysql);
+        a.message = mysql_error(a.mysql);
+        a.fatal = !network_error;
+        ++race->failed;
+        if (a.fatal && race->fatal < 0)
+          race->fatal = (int)idx;
+      }
+      unwanted = a.mysql;
+      a.mysql = nullptr;
+    }
+  }
+  race->cv.notify_all();
+
+  if (unwanted)
+    mysql_close(unwanted);
+  mysql_thread_end();
+
+  background_threads.leave();
+}
+
+
+/*
+  Connect to the first host of the list that accepts the connection.
+
+  The hosts are tried in the given order, but a host doesn't have to fail
+  first before the next one is tried: if it doesn't answer within
+  MULTI_HOST_STAGGER milliseconds, the next attempt starts in parallel.
+  The first attempt to succeed wins. A host refusing the connection for
+  other than network reasons (wrong password, for example) ends the
+  race, as it did when hosts were only tried one by one.
+
+  @param[in]  hosts     Hosts to try
+  @param[in]  handles   Unconnected handles, one per host. They are taken
+                        over by the function.
+  @param[in]  dsrc      Data source information
+  @param[in]  flags     Client flags
+  @param[out] outcome   The host connected to, or the error
+
+  @return The connected handle or nullptr.
+*/
+static MYSQL *race_connect(const std::vector<Srv_host_detail> &hosts,
+                           std::vector<MYSQL*> &handles,
+                           DataSource *dsrc, unsigned long flags,
+                           connect_attempt &outcome)
+{
+  auto race = std::make_shared<connect_race>(dsrc, flags);
+  race->attempts.resize(hosts.size());
+  for (size_t i = 0; i < hosts.size(); ++i)
+  {
+    connect_attempt &a = race->attempts[i];
+    a.host = hosts[i];
+    a.mysql = handles[i];
+    a.tls_key = tls_session_cache::key(dsrc, a.host.name.c_str(),
+                                       a.host.port);
+    tls_sessions.offer(a.mysql, a.tls_key);
+  }
+  handles.clear();
+
+  std::unique_lock<std::mutex> lock(race->mtx);
+  size_t started = 0, failed = 0;
+
+  auto start_next = [&race, &started]()
+  {
+    ++race->running;
+    background_threads.start(run_connect_attempt, race, started++);
+  };
+
+  start_next();
+
+  while (race->winner < 0 && race->fatal < 0)
+  {
+    bool more = started < hosts.size();
+
+    if (!race->running && !more)
+      break;
+
+    // Don't wait for the stagger delay once an attempt failed
+    if (race->failed > failed)
+    {
+      failed = race->failed;
+      if (more)
+        start_next();
+      continue;
+    }
+
+    if (!more)
+      race->cv.wait(lock);
+    else if (race->cv.wait_for(lock,
+               std::chrono::milliseconds(MULTI_HOST_STAGGER)) ==
+             std::cv_status::timeout)
+      start_next();
+  }
+
+  race->abandoned = true;
+
+  // Handles of the hosts that were not tried
+  for (size_t i = started; i < hosts.size(); ++i)
+    mysql_close(race->attempts[i].mysql);
+
+  if (race->winner >= 0)
+  {
+    connect_attempt &won = race->attempts[race->winner];
+    outcome.host = won.host;
+    outcome.tls_reused = won.tls_reused;
+    return won.mysql;
+  }
+
+  // Report the host that ended the race, or else the last one tried
+  int last = race->fatal;
+  for (size_t i = 0; race->fatal < 0 && i < started; ++i)
+  {
+    if (!race->attempts[i].message.empty())
+      last = (int)i;
+  }
+  if (last >= 0)
+    outcome = race->attempts[last];
+  return nullptr;
+}
+
+
+/* A DNS SRV record, RFC 2782 */
+struct Srv_record
+{
+  std::string target;
+  unsigned int port;
+  unsigned int prio;
+  unsigned int weight;
+};
+
+
+/*
+  Take the records for `name` from the file named by the
+  MYODBC_DNS_SRV_FILE environment variable instead of asking DNS. The
+  file has zone file style lines:
+
+    _mysql._tcp.example.com. 60 IN SRV 10 5 3306 db1.example.com.
+
+  @return false if there is no such file to use.
+*/
+static bool srv_file_lookup(const std::string &name,
+                            std::vector<Srv_record> &records, uint32_t &ttl)
+{
+  const char *file = getenv("MYODBC_DNS_SRV_FILE");
+  if (!file || !file[0])
+    return false;
+
+  std::ifstream in(file);
+  if (!in)
+    throw std::string("Can't read DNS SRV records from ") + file;
+
+  auto strip_dot = [](std::string str)
+  {
+    if (!str.empty() && str.back() == '.')
+      str.pop_back();
+    return str;
+  };
+
+  std::string line;
+  while (std::getline(in, line))
+  {
+    std::istringstream fields(line);
+    std::string owner, cls, type, target;
+    uint32_t rec_ttl;
+    Srv_record rec;
+
+    if (!(fields >> owner >> rec_ttl >> cls >> type >> rec.prio >>
+          rec.weight >> rec.port >> target) ||
+        owner[0] == ';' || owner[0] == '#' ||
+        myodbc_strcasecmp(strip_dot(owner).c_str(), strip_dot(name).c_str()) ||
+        myodbc_strcasecmp(cls.c_str(), "IN") ||
+        myodbc_strcasecmp(type.c_str(), "SRV"))
+      continue;
+
+    rec.target = strip_dot(target);
+    ttl = records.empty() ? rec_ttl : std::min(ttl, rec_ttl);
+    records.push_back(rec);
+  }
+  return true;
+}
+
+
+/*
+  Look up the SRV records of a service.
+
+  @param[in]   name   Service name, like _mysql._tcp.example.com
+  @param[out]  ttl    Time to live of the records in seconds
+
+  @return The records, except the ones saying there is no service.
+*/
+static std::vector<Srv_record> srv_lookup(const std::string &name,
+                                          uint32_t &ttl)
+{
+  std::vector<Srv_record> records;
+  const std::string error = "Unable to locate any hosts for " + name;
+  ttl = 0;
+
+  if (!srv_file_lookup(name, records, ttl))
+  {
+#ifdef _WIN32
+    PDNS_RECORDA res = nullptr;
+    if (DnsQuery_A(name.c_str(), DNS_TYPE_SRV, DNS_QUERY_STANDARD, nullptr,
+                   (PDNS_RECORD*)&res, nullptr) != ERROR_SUCCESS)
+      throw error;
+
+    for (PDNS_RECORDA r = res; r; r = r->pNext)
+    {
+      if (r->wType != DNS_TYPE_SRV)
+        continue;
+      records.push_back({r->Data.SRV.pNameTarget, r->Data.SRV.wPort,
+                         r->Data.SRV.wPriority, r->Data.SRV.wWeight});
+      ttl = records.size() == 1 ? r->dwTtl : std::min(ttl, (uint32_t)r->dwTtl);
+    }
+    DnsRecordListFree(res, DnsFreeRecordList);
+#else
+    struct __res_state state;
+    std::vector<unsigned char> answer(NS_MAXMSG);
+    ns_msg msg;
+
+    memset(&state, 0, sizeof(state));
+    if (res_ninit(&state))
+      throw error;
+    int len = res_nsearch(&state, name.c_str(), ns_c_in, ns_t_srv,
+                          answer.data(), (int)answer.size());
+    res_nclose(&state);
+
+    if (len < 0 || ns_initparse(answer.data(), len, &msg))
+      throw error;
+
+    for (int i = 0; i < ns_msg_count(msg, ns_s_an); ++i)
+    {
+      ns_rr rr;
+      char target[NS_MAXDNAME];
+
+      if (ns_parserr(&msg, ns_s_an, i, &rr) || ns_rr_type(rr) != ns_t_srv ||
+          ns_rr_rdlen(rr) < 7)
+        continue;
+
+      // Priority, weight and port, followed by the target name
+      const unsigned char *p = ns_rr_rdata(rr);
+      if (dn_expand(ns_msg_base(msg), ns_msg_end(msg), p + 6, target,
+                    sizeof(target)) < 0)
+        continue;
+
+      records.push_back({target, (unsigned int)(p[4] << 8 | p[5]),
+                         (unsigned int)(p[0] << 8 | p[1]),
+                         (unsigned int)(p[2] << 8 | p[3])});
+      ttl = records.size() == 1 ? ns_rr_ttl(rr) :
+                                  std::min(ttl, (uint32_t)ns_rr_ttl(rr));
+    }
+#endif
+  }
+
+  // A target of "." means the service is not available there
+  records.erase(std::remove_if(records.begin(), records.end(),
+                  [](const Srv_record &r)
+                  { return r.target.empty() || r.target == "."; }),
+                records.end());
+  return records;
+}
+
+
+/*
+  DNS SRV records by service name, kept for their TTL. Records used in
+  the last quarter of their TTL are refreshed in the background, so a
+  busy service doesn't wait for DNS. If a lookup fails the records from
+  the last one that didn't are used.
+*/
+
+class srv_cache
+{
+  struct entry
+  {
+    std::vector<Srv_record> records;
+    time_t fetched = 0;
+    time_t expires = 0;
+    bool refreshing = false;
+  };
+
+  std::mutex mtx;
+  std::map<std::string, entry> entries;
+
+  void store(const std::string &name, const std::vector<Srv_record> &records,
+             uint32_t ttl)
+  {
+    std::lock_guard<std::mutex> guard(mtx);
+    entry &e = entries[name];
+    e.records = records;
+    e.fetched = time(nullptr);
+    e.expires = e.fetched + ttl;
+    e.refreshing = false;
+  }
+
+  void refresh(std::string name)
+  {
+    try
+    {
+      uint32_t ttl;
+      std::vector<Srv_record> records = srv_lookup(name, ttl);
+      store(name, records, ttl);
+    }
+    catch (std::string &)
+    {
+      std::lock_guard<std::mutex> guard(mtx);
+      entries[name].refreshing = false;
+    }
+    background_threads.leave();
+  }
+
+  public:
+
+  std::vector<Srv_record> get(const std::string &name)
+  {
+    {
+      std::lock_guard<std::mutex> guard(mtx);
+      auto it = entries.find(name);
+      time_t now = time(nullptr);
+
+      if (it != entries.end() && now < it->second.expires)
       {
-        std::stringstream err;
-        err << "Invalid port value in " << hosts;
-        throw err.str();
+        entry &e = it->second;
+        if (!e.refreshing && now >= e.expires - (e.expires - e.fetched) / 4)
+        {
+          e.refreshing = true;
+          background_threads.start(&srv_cache::refresh, this, name);
+        }
+        return e.records;
       }
+    }
 
-      host_detail.port = static_cast<uint16_t>(val);
+    try
+    {
+      uint32_t ttl;
+      std::vector<Srv_record> records = srv_lookup(name, ttl);
+      store(name, records, ttl);
+      return records;
     }
-    else
+    catch (std::string &)
     {
-      host_detail.port = default_port;
+      std::lock_guard<std::mutex> guard(mtx);
+      auto it = entries.find(name);
+      if (it == entries.end() || it->second.records.empty())
+        throw;
+      return it->second.records;
     }
+  }
+};
 
-    pos_i = pos_f+1;
-
-    list.push_back(host_detail);
-  }while (pos_f < hosts.size());
-
-  return list;
-}
+static srv_cache dns_srv;
 
 
-class dbc_guard
+/*
+  Order SRV targets as RFC 2782 says: by priority, and within the same
+  priority randomly, with the chance of a target to come first
+  proportional to its weight.
+*/
+static std::vector<Srv_host_detail> srv_order(std::vector<Srv_record> records)
 {
-  DBC *m_dbc;
-  bool m_success = false;
-  public:
-
-  dbc_guard(DBC *dbc) : m_dbc(dbc) {}
-  void set_success(bool success) { m_success = success; }
-  ~dbc_guard() { if (!m_success) m_dbc->close(); }
-};
+  std::random_device rd;
+  std::mt19937 generator(rd());
+  std::vector<Srv_host_detail> list;
 
+  std::stable_sort(records.begin(), records.end(),
+                   [](const Srv_record &a, const Srv_record &b)
+                   { return a.prio < b.prio; });
 
-MYSQL *new_mysql()
-{
-  static struct init
+  auto next = records.begin();
+  while (next != records.end())
   {
-    init(){ mysql_library_init(0, nullptr, nullptr); }
+    auto group_end = std::find_if(next, records.end(),
+                       [&next](const Srv_record &r)
+                       { return r.prio != next->prio; });
+
+    // Zero weight targets go first, so they are picked only by chance 0
+    std::stable_partition(next, group_end,
+                          [](const Srv_record &r) { return r.weight == 0; });
+
+    for (; next != group_end; ++next)
+    {
+      unsigned long total = 0;
+      for (auto it = next; it != group_end; ++it)
+        total += it->weight;
+
+      unsigned long pick =
+        std::uniform_int_distribution<unsigned long>(0, total)(generator);
+
+      auto it = next;
+      for (unsigned long sum = it->weight; sum < pick; sum += it->weight)
+        ++it;
+
+      std::rotate(next, it, it + 1);
+      Srv_host_detail host;
+      host.name = next->target;
+      host.port = next->port;
+      list.push_back(host);
+    }
   }
-  do_init;
 
-  return mysql_init(nullptr);
+  return list;
 }
 
 
 /**
-  Try to establish a connection to a MySQL server based on the data source
-  configuration.
+  Set the client library options for a connection handle as configured
+  by the data source. Takes the handle as a parameter because a
+  MULTI_HOST connect tries several hosts at once, each on its own handle.
 
-  @param[in]  ds   Data source information
+  @param[in]  mysql  Connection handle, not connected yet
+  @param[in]  dsrc   Data source information
+  @param[out] err_out  Where errors are reported, the DBC diagnostics if
+                       NULL. SQLCancel() passes its own, it runs while
+                       another thread uses the DBC.
 
-  @return Standard SQLRETURN code. If it is @c SQL_SUCCESS or @c
-  SQL_SUCCESS_WITH_INFO, a connection has been established.
+  @return Standard SQLRETURN code.
 */
-SQLRETURN DBC::connect(DataSource *dsrc)
+SQLRETURN DBC::set_connect_options(MYSQL *mysql, DataSource *dsrc,
+                                   MYERROR *err_out)
 {
-  SQLRETURN rc = SQL_SUCCESS;
-  unsigned long flags;
+  auto options_error = [this, err_out](const char *message,
+                                       uint errcode) -> SQLRETURN
+  {
+    if (!err_out)
+      return set_error("HY000", message, errcode);
+    *err_out = MYERROR("HY000", message, errcode, MYODBC_ERROR_PREFIX);
+    return SQL_ERROR;
+  };
+
   /* Use 'int' and fill all bits to avoid alignment Bug#25920 */
   unsigned int opt_ssl_verify_server_cert = ~0;
   const my_bool on = 1;
   unsigned int on_int = 1;
   unsigned long max_long = ~0L;
-  bool initstmt_executed = false;
-
-  dbc_guard guard(this);
-
-#ifdef WIN32
-  /*
-   Detect if we are running with ADO present, and force on the
-   FLAG_COLUMN_SIZE_S32 option if we are.
-  */
-  if (GetModuleHandle("msado15.dll") != NULL)
-    dsrc->opt_COLUMN_SIZE_S32 = true;
-
-  /* Detect another problem specific to MS Access */
-  if (GetModuleHandle("msaccess.exe") != NULL)
-    dsrc->opt_DFLT_BIGINT_BIND_STR = true;
-
-  /* MS SQL Likes when the CHAR columns are padded */
-  if (GetModuleHandle("sqlservr.exe") != NULL)
-    dsrc->opt_PAD_SPACE = true;
-
-#endif
-
-  mysql = new_mysql();
-
-  if (!mysql)
-    return set_error("HY001", "Memory allocation error", MYERR_S1001);
-
-  flags = get_client_flags(dsrc);
-
-  /* Set other connection options */
 
   if (dsrc->opt_BIG_PACKETS || dsrc->opt_SAFE)
 #if MYSQL_VERSION_ID >= 50709
@@ -578,13 +1755,13 @@ SQLRETURN DBC::connect(DataSource *dsrc)
     switch (err.type) \
     { \
       case plugin_error::PLUGIN: \
-        return set_error("HY000", msgplug ? msgplug : err.message.c_str(), 0); \
+        return options_error(msgplug ? msgplug : err.message.c_str(), 0); \
       break;\
       case plugin_error::OPTION: \
-        return set_error("HY000", MSGOPT, 0); \
+        return options_error(MSGOPT, 0); \
       break;\
       default: \
-        return set_error("HY000", err.message.c_str(), 0); \
+        return options_error(err.message.c_str(), 0); \
     } \
   }
 
@@ -656,7 +1833,7 @@ SQLRETURN DBC::connect(DataSource *dsrc)
     myodbc_strcasecmp("GSSAPI",
     (const char *)dsrc->opt_AUTHENTICATION_KERBEROS_MODE))
   {
-    return set_error("HY000",
+    return options_error(
       "Invalid value for authentication-kerberos-mode. "
       "Only GSSAPI is supported.", 0);
   }
@@ -680,7 +1857,7 @@ SQLRETURN DBC::connect(DataSource *dsrc)
 #define SSL_SET(X, Y) \
    if (dsrc->opt_##X && mysql_options(mysql, MYSQL_OPT_##X,         \
                                       (const char *)dsrc->opt_##X)) \
-     return set_error("HY000", "Failed to set " Y, 0);
+     return options_error("Failed to set " Y, 0);
 
 #define SSL_OPTIONS_LIST(X) \
   X(SSL_KEY, "the path name of the client private key file") \
@@ -737,12 +1914,43 @@ SQLRETURN DBC::connect(DataSource *dsrc)
     if (!tls_options.length() ||
         mysql_options(mysql, MYSQL_OPT_TLS_VERSION, tls_options.c_str()))
     {
-      return set_error("HY000",
+      return options_error(
         "SSL connection error: No valid TLS version available", 0);
     }
   }
 #endif
 
+#if MYSQL_VERSION_ID >= 80018
+  /*
+    Without an explicit list COMPRESSED_PROTO asks for zlib through
+    CLIENT_COMPRESS, see get_client_flags().
+  */
+  if (dsrc->opt_COMPRESSION_ALGORITHMS &&
+      mysql_options(mysql, MYSQL_OPT_COMPRESSION_ALGORITHMS,
+                    (const char*)dsrc->opt_COMPRESSION_ALGORITHMS))
+  {
+    return options_error(
+      "Failed to set the list of compression algorithms", 0);
+  }
+
+  if (dsrc->opt_ZSTD_COMPRESSION_LEVEL)
+  {
+    unsigned int level = (unsigned int)dsrc->opt_ZSTD_COMPRESSION_LEVEL;
+    if (level < 1 || level > 22 ||
+        mysql_options(mysql, MYSQL_OPT_ZSTD_COMPRESSION_LEVEL, &level))
+    {
+      return options_error(
+        "ZSTD-COMPRESSION-LEVEL must be between 1 and 22", 0);
+    }
+  }
+#else
+  if (dsrc->opt_COMPRESSION_ALGORITHMS || dsrc->opt_ZSTD_COMPRESSION_LEVEL)
+  {
+    return options_error(
+      "Compression algorithms are not supported by the client library", 0);
+  }
+#endif
+
 #if MYSQL_VERSION_ID >= 80004
   if (dsrc->opt_GET_SERVER_PUBLIC_KEY)
   {
@@ -765,81 +1973,221 @@ SQLRETURN DBC::connect(DataSource *dsrc)
   }
 #endif
 
-  if (dsrc->opt_ENABLE_LOCAL_INFILE)
-  {
-    mysql_options(mysql, MYSQL_OPT_LOCAL_INFILE, &on_int);
-  }
+  if (dsrc->opt_ENABLE_LOCAL_INFILE)
+  {
+    mysql_options(mysql, MYSQL_OPT_LOCAL_INFILE, &on_int);
+  }
+
+  if (dsrc->opt_LOAD_DATA_LOCAL_DIR)
+  {
+    mysql_options(mysql, MYSQL_OPT_LOAD_DATA_LOCAL_DIR,
+                  (const char*)dsrc->opt_LOAD_DATA_LOCAL_DIR);
+  }
+
+  // Set the connector identification attributes.
+  std::string attr_list[][2] = {
+    {"_connector_license", MYODBC_LICENSE},
+    {"_connector_name", "mysql-connector-odbc"},
+    {"_connector_type", MYODBC_STRDRIVERTYPE},
+    {"_connector_version", MYODBC_CONN_ATTR_VER}
+  };
+
+  for (auto &val : attr_list)
+  {
+    mysql_options4(mysql, MYSQL_OPT_CONNECT_ATTR_ADD,
+      val[0].c_str(), val[1].c_str());
+  }
+
+#if MFA_ENABLED
+  if(dsrc->pwd1 && dsrc->pwd1[0])
+  {
+    ds_get_utf8attr(dsrc->pwd1, &dsrc->pwd18);
+    int fator = 1;
+    mysql_options4(mysql, MYSQL_OPT_USER_PASSWORD,
+                   &fator,
+                   dsrc->pwd18);
+  }
+
+  if(dsrc->pwd2 && dsrc->pwd2[0])
+  {
+    ds_get_utf8attr(dsrc->pwd2, &dsrc->pwd28);
+    int fator = 2;
+    mysql_options4(mysql, MYSQL_OPT_USER_PASSWORD,
+                   &fator,
+                   dsrc->pwd28);
+  }
+
+  if(dsrc->pwd3 && dsrc->pwd3[0])
+  {
+    ds_get_utf8attr(dsrc->pwd3, &dsrc->pwd38);
+    int fator = 3;
+    mysql_options4(mysql, MYSQL_OPT_USER_PASSWORD,
+                   &fator,
+                   dsrc->pwd38);
+  }
+#endif
+#if MYSQL_VERSION_ID >= 50711
+  if (dsrc->opt_SSL_MODE)
+  {
+    unsigned int mode = 0;
+    if (!myodbc_strcasecmp(ODBC_SSL_MODE_DISABLED, dsrc->opt_SSL_MODE))
+      mode = SSL_MODE_DISABLED;
+    if (!myodbc_strcasecmp(ODBC_SSL_MODE_PREFERRED, dsrc->opt_SSL_MODE))
+      mode = SSL_MODE_PREFERRED;
+    if (!myodbc_strcasecmp(ODBC_SSL_MODE_REQUIRED, dsrc->opt_SSL_MODE))
+      mode = SSL_MODE_REQUIRED;
+    if (!myodbc_strcasecmp(ODBC_SSL_MODE_VERIFY_CA, dsrc->opt_SSL_MODE))
+      mode = SSL_MODE_VERIFY_CA;
+    if (!myodbc_strcasecmp(ODBC_SSL_MODE_VERIFY_IDENTITY, dsrc->opt_SSL_MODE))
+      mode = SSL_MODE_VERIFY_IDENTITY;
+
+    // Don't do anything if there is no match with any of the available modes
+    if (mode)
+      mysql_options(mysql, MYSQL_OPT_SSL_MODE, &mode);
+  }
+#endif
+
+  /*
+    Ask for the connection character set in the handshake, so that
+    setup_session() does not need SET NAMES when the server agrees to it.
+  */
+  mysql_options(mysql, MYSQL_SET_CHARSET_NAME, connection_charset(dsrc));
+
+  int protocol;
+  if (dsrc->opt_SOCKET)
+  {
+#ifdef _WIN32
+    protocol = MYSQL_PROTOCOL_PIPE;
+#else
+    protocol = MYSQL_PROTOCOL_SOCKET;
+#endif
+  }
+  else
+  {
+    protocol = MYSQL_PROTOCOL_TCP;
+  }
+  mysql_options(mysql, MYSQL_OPT_PROTOCOL, &protocol);
+
+  return SQL_SUCCESS;
+}
+
+
+/*
+  Key of the driver pool for this connection: the connection string and
+  the attributes set with SQLSetConnectAttr() before connecting that shape
+  the session.
+*/
+SQLWSTRING DBC::session_pool_key(DataSource *dsrc)
+{
+  std::stringstream attrs;
+  attrs << ";\x01LOGIN_TIMEOUT=" << login_timeout
+        << ";\x01AUTOCOMMIT=" << commit_flag
+        << ";\x01TXN_ISOLATION=" << txn_isolation
+        << ";\x01FIDO_CALLBACK=" << (void*)fido_callback;
+
+  const std::string tail = attrs.str();
+  return dsrc->to_kvpair(';') + SQLWSTRING(tail.begin(), tail.end());
+}
+
+
+/**
+  Try to establish a connection to a MySQL server based on the data source
+  configuration.
+
+  @param[in]  ds   Data source information
+
+  @return Standard SQLRETURN code. If it is @c SQL_SUCCESS or @c
+  SQL_SUCCESS_WITH_INFO, a connection has been established.
+*/
+SQLRETURN DBC::connect(DataSource *dsrc)
+{
+  SQLRETURN rc = SQL_SUCCESS;
+  unsigned long flags;
+  bool initstmt_executed = false;
+
+  dbc_guard guard(this);
+
+#ifdef WIN32
+  /*
+   Detect if we are running with ADO present, and force on the
+   FLAG_COLUMN_SIZE_S32 option if we are.
+  */
+  if (GetModuleHandle("msado15.dll") != NULL)
+    dsrc->opt_COLUMN_SIZE_S32 = true;
+
+  /* Detect another problem specific to MS Access */
+  if (GetModuleHandle("msaccess.exe") != NULL)
+    dsrc->opt_DFLT_BIGINT_BIND_STR = true;
+
+  /* MS SQL Likes when the CHAR columns are padded */
+  if (GetModuleHandle("sqlservr.exe") != NULL)
+    dsrc->opt_PAD_SPACE = true;
+
+#endif
+
+  // Handle OPENTELEMETRY option.
+
+  // Note: Using while() instead of if() to be able to get out of it with
+  // `break` statement.
+
+  while (dsrc->opt_OPENTELEMETRY)
+  {
+#ifndef TELEMETRY
+
+    return set_error("HY000",
+      "OPENTELEMETRY option is not supported on this platform."
+    ,0);
+
+#else
+
+#define SET_OTEL_MODE(X,N) \
+    if (!myodbc_strcasecmp(#X, dsrc->opt_OPENTELEMETRY)) \
+    { telemetry.set_mode(OTEL_ ## X); break; }
+
+    ODBC_OTEL_MODE(SET_OTEL_MODE)
 
-  if (dsrc->opt_LOAD_DATA_LOCAL_DIR)
-  {
-    mysql_options(mysql, MYSQL_OPT_LOAD_DATA_LOCAL_DIR,
-                  (const char*)dsrc->opt_LOAD_DATA_LOCAL_DIR);
-  }
+    // If we are here then option was not recognized above.
 
-  // Set the connector identification attributes.
-  std::string attr_list[][2] = {
-    {"_connector_license", MYODBC_LICENSE},
-    {"_connector_name", "mysql-connector-odbc"},
-    {"_connector_type", MYODBC_STRDRIVERTYPE},
-    {"_connector_version", MYODBC_CONN_ATTR_VER}
-  };
+    return set_error("HY000",
+      "OPENTELEMETRY option can be set only to DISABLED or PREFERRED"
+    , 0);
 
-  for (auto &val : attr_list)
-  {
-    mysql_options4(mysql, MYSQL_OPT_CONNECT_ATTR_ADD,
-      val[0].c_str(), val[1].c_str());
+#endif
   }
 
-#if MFA_ENABLED
-  if(dsrc->pwd1 && dsrc->pwd1[0])
-  {
-    ds_get_utf8attr(dsrc->pwd1, &dsrc->pwd18);
-    int fator = 1;
-    mysql_options4(mysql, MYSQL_OPT_USER_PASSWORD,
-                   &fator,
-                   dsrc->pwd18);
-  }
+  telemetry.span_start(this);
 
-  if(dsrc->pwd2 && dsrc->pwd2[0])
+  pool_key.clear();
+  if (dsrc->opt_POOLING)
   {
-    ds_get_utf8attr(dsrc->pwd2, &dsrc->pwd28);
-    int fator = 2;
-    mysql_options4(mysql, MYSQL_OPT_USER_PASSWORD,
-                   &fator,
-                   dsrc->pwd28);
+    // The host list is overwritten by the connected host below, so the
+    // key has to be taken first.
+    pool_key = session_pool_key(dsrc);
+    mysql = global_session_pool.get(pool_key, session_created);
+    if (mysql)
+    {
+      telemetry.set_attribs(this, dsrc);
+      rc = setup_session(dsrc);
+      if (SQL_SUCCEEDED(rc))
+      {
+        guard.set_success(true);
+        return rc;
+      }
+      // Fall back to a new session if the parked one can't be set up
+      close();
+      rc = SQL_SUCCESS;
+    }
   }
 
-  if(dsrc->pwd3 && dsrc->pwd3[0])
-  {
-    ds_get_utf8attr(dsrc->pwd3, &dsrc->pwd38);
-    int fator = 3;
-    mysql_options4(mysql, MYSQL_OPT_USER_PASSWORD,
-                   &fator,
-                   dsrc->pwd38);
-  }
-#endif
-#if MYSQL_VERSION_ID >= 50711
-  if (dsrc->opt_SSL_MODE)
-  {
-    unsigned int mode = 0;
-    if (!myodbc_strcasecmp(ODBC_SSL_MODE_DISABLED, dsrc->opt_SSL_MODE))
-      mode = SSL_MODE_DISABLED;
-    if (!myodbc_strcasecmp(ODBC_SSL_MODE_PREFERRED, dsrc->opt_SSL_MODE))
-      mode = SSL_MODE_PREFERRED;
-    if (!myodbc_strcasecmp(ODBC_SSL_MODE_REQUIRED, dsrc->opt_SSL_MODE))
-      mode = SSL_MODE_REQUIRED;
-    if (!myodbc_strcasecmp(ODBC_SSL_MODE_VERIFY_CA, dsrc->opt_SSL_MODE))
-      mode = SSL_MODE_VERIFY_CA;
-    if (!myodbc_strcasecmp(ODBC_SSL_MODE_VERIFY_IDENTITY, dsrc->opt_SSL_MODE))
-      mode = SSL_MODE_VERIFY_IDENTITY;
+  mysql = new_mysql();
 
-    // Don't do anything if there is no match with any of the available modes
-    if (mode)
-      mysql_options(mysql, MYSQL_OPT_SSL_MODE, &mode);
-  }
-#endif
+  if (!mysql)
+    return set_error("HY001", "Memory allocation error", MYERR_S1001);
+
+  flags = get_client_flags(dsrc);
 
-  uint16_t total_weight = 0;
+  if (set_connect_options(mysql, dsrc) != SQL_SUCCESS)
+    return SQL_ERROR;
 
   std::vector<Srv_host_detail> hosts;
   try {
@@ -878,6 +2226,15 @@ SQLRETURN DBC::connect(DataSource *dsrc)
                     0);
     }
 
+    try
+    {
+      hosts = srv_order(dns_srv.get(hosts[0].name));
+    }
+    catch (std::string &)
+    {
+      hosts.clear();
+    }
+
     if(hosts.empty())
     {
       std::stringstream err;
@@ -887,178 +2244,157 @@ SQLRETURN DBC::connect(DataSource *dsrc)
 
   }
 
-  // Handle OPENTELEMETRY option.
-
-  // Note: Using while() instead of if() to be able to get out of it with
-  // `break` statement.
-
-  while (dsrc->opt_OPENTELEMETRY)
+  auto connect_error = [this,&dsrc](unsigned int native_error,
+                                    const char *message) -> SQLRETURN
   {
-#ifndef TELEMETRY
-
-    return set_error("HY000",
-      "OPENTELEMETRY option is not supported on this platform."
-    ,0);
-
-#else
-
-#define SET_OTEL_MODE(X,N) \
-    if (!myodbc_strcasecmp(#X, dsrc->opt_OPENTELEMETRY)) \
-    { telemetry.set_mode(OTEL_ ## X); break; }
-
-    ODBC_OTEL_MODE(SET_OTEL_MODE)
+    /* Before 5.6.11 error returned by server was ER_MUST_CHANGE_PASSWORD(1820).
+     In 5.6.11 it changed to ER_MUST_CHANGE_PASSWORD_LOGIN(1862)
+     We must to change error for old servers in order to set correct sqlstate */
+    if (native_error == 1820 && ER_MUST_CHANGE_PASSWORD_LOGIN != 1820)
+    {
+      native_error= ER_MUST_CHANGE_PASSWORD_LOGIN;
+    }
 
-    // If we are here then option was not recognized above.
+#if MYSQL_VERSION_ID < 50610
+    /* In that special case when the driver was linked against old version of libmysql*/
+    if (native_error == ER_MUST_CHANGE_PASSWORD_LOGIN
+        && dsrc->CAN_HANDLE_EXP_PWD)
+    {
+      /* The password has expired, application said it knows how to deal with
+       that, but the driver was linked  that
+       does not support this option. Thus we change native error. */
+      /* TODO: enum/defines for driver specific errors */
+      return set_conn_error(dbc, MYERR_08004,
+                            "Your password has expired, but underlying library doesn't support "
+                            "this functionlaity", 0);
+    }
+#endif
+    set_error("HY000", message, native_error);
 
-    return set_error("HY000",
-      "OPENTELEMETRY option can be set only to DISABLED or PREFERRED"
-    , 0);
+    translate_error(error.sqlstate, MYERR_S1000, native_error);
 
-#endif
-  }
+    return SQL_ERROR;
+  };
 
-  telemetry.span_start(this);
+  // SERVER keeps the service name when connecting to DNS SRV targets
+  const bool srv = dsrc->opt_ENABLE_DNS_SRV;
+  const std::string srv_error = srv ?
+    std::string("Unable to connect to any of the hosts of ") +
+    (const char*)dsrc->opt_SERVER + " SRV" : "";
 
-  auto do_connect = [this,&dsrc,&flags](
+  auto do_connect = [this,&dsrc,&flags,&connect_error,srv](
                     const char *host,
                     unsigned int port
                     ) -> short
   {
-    int protocol;
-    if(dsrc->opt_SOCKET)
-    {
-#ifdef _WIN32
-      protocol = MYSQL_PROTOCOL_PIPE;
-#else
-      protocol = MYSQL_PROTOCOL_SOCKET;
-#endif
-    } else
+    if (!srv)
     {
-      protocol = MYSQL_PROTOCOL_TCP;
+      //Setting server and port
+      dsrc->opt_SERVER = host;
+      dsrc->opt_PORT = port;
     }
-    mysql_options(mysql, MYSQL_OPT_PROTOCOL, &protocol);
-
-    //Setting server and port
-    dsrc->opt_SERVER = host;
-    dsrc->opt_PORT = port;
-
-    MYSQL *connect_result = dsrc->opt_ENABLE_DNS_SRV ?
-                            mysql_real_connect_dns_srv(mysql,
-                              host,
-                              dsrc->opt_UID,
-                              dsrc->opt_PWD,
-                              dsrc->opt_DATABASE,
-                              flags)
-                            :
-                            mysql_real_connect(mysql,
-                              host,
-                              dsrc->opt_UID,
-                              dsrc->opt_PWD,
-                              dsrc->opt_DATABASE,
-                              port,
-                              dsrc->opt_SOCKET,
-                              flags);
-    if (!connect_result)
-    {
-      unsigned int native_error= mysql_errno(mysql);
-
-      /* Before 5.6.11 error returned by server was ER_MUST_CHANGE_PASSWORD(1820).
-       In 5.6.11 it changed to ER_MUST_CHANGE_PASSWORD_LOGIN(1862)
-       We must to change error for old servers in order to set correct sqlstate */
-      if (native_error == 1820 && ER_MUST_CHANGE_PASSWORD_LOGIN != 1820)
-      {
-        native_error= ER_MUST_CHANGE_PASSWORD_LOGIN;
-      }
-
-#if MYSQL_VERSION_ID < 50610
-      /* In that special case when the driver was linked against old version of libmysql*/
-      if (native_error == ER_MUST_CHANGE_PASSWORD_LOGIN
-          && dsrc->CAN_HANDLE_EXP_PWD)
-      {
-        /* The password has expired, application said it knows how to deal with
-         that, but the driver was linked  that
-         does not support this option. Thus we change native error. */
-        /* TODO: enum/defines for driver specific errors */
-        return set_conn_error(dbc, MYERR_08004,
-                              "Your password has expired, but underlying library doesn't support "
-                              "this functionlaity", 0);
-      }
-#endif
-      set_error("HY000", mysql_error(mysql), native_error);
 
-      translate_error((char*)error.sqlstate.c_str(), MYERR_S1000, native_error);
+    offer_tls_session(mysql, dsrc, host, port);
 
-      return SQL_ERROR;
-    }
+    if (!mysql_real_connect(mysql,
+                            host,
+                            dsrc->opt_UID,
+                            dsrc->opt_PWD,
+                            dsrc->opt_DATABASE,
+                            port,
+                            dsrc->opt_SOCKET,
+                            flags))
+      return connect_error(mysql_errno(mysql), mysql_error(mysql));
 
+    tls_session_reused = save_tls_session(mysql, dsrc, host, port);
     return SQL_SUCCESS;
   };
 
-  //Connect loop
+  if (hosts.size() == 1)
   {
-    bool connected = false;
-    std::random_device rd;
-    std::mt19937 generator(rd()); // seed the generator
-
-
-    while(!hosts.empty() && !connected)
+    if (do_connect(hosts[0].name.c_str(), hosts[0].port) != SQL_SUCCESS)
     {
-      std::uniform_int_distribution<int> distribution(
-            0, (int)hosts.size() - 1); // define the range of random numbers
-
-      int pos = distribution(generator);
-      auto el = hosts.begin();
-
-      std::advance(el, pos);
-
-      if(do_connect(el->name.c_str(), el->port) == SQL_SUCCESS)
+      if (srv && is_network_error(mysql_errno(mysql), mysql_sqlstate(mysql)))
       {
-        connected = true;
-        telemetry.set_attribs(this, dsrc);
-        break;
+        host_health.failure(hosts[0]);
+        set_error("HY000", srv_error.c_str(), 0);
       }
-      else
+      //The others will retrieve the error from connect
+      return SQL_ERROR;
+    }
+  }
+  else
+  {
+    // Each host gets its own handle, they may be tried at the same time
+    std::vector<MYSQL*> handles;
+    for (size_t i = 0; i < hosts.size(); ++i)
+    {
+      MYSQL *m = new_mysql();
+      if (!m || set_connect_options(m, dsrc) != SQL_SUCCESS)
       {
-        switch (mysql_errno(mysql))
-        {
-        case ER_CON_COUNT_ERROR:
-        case CR_SOCKET_CREATE_ERROR:
-        case CR_CONNECTION_ERROR:
-        case CR_CONN_HOST_ERROR:
-        case CR_IPSOCK_ERROR:
-        case CR_UNKNOWN_HOST:
-          //On Network errors, continue
-          break;
-        default:
-          //If SQLSTATE not 08xxx, which is used for network errors
-          if(strncmp(mysql_sqlstate(mysql), "08", 2) != 0)
-          {
-            //Return error and do not try another host
-            return SQL_ERROR;
-          }
-        }
+        if (m)
+          mysql_close(m);
+        for (MYSQL *h : handles)
+          mysql_close(h);
+        return m ? SQL_ERROR :
+          set_error("HY001", "Memory allocation error", MYERR_S1001);
       }
-      hosts.erase(el);
+      handles.push_back(m);
     }
 
-    if(!connected)
+    // DNS SRV targets come in the order of RFC 2782 already
+    host_health.order(hosts, !srv);
+
+    connect_attempt outcome;
+    MYSQL *connected = race_connect(hosts, handles, dsrc, flags, outcome);
+
+    if (!connected)
     {
-      if(dsrc->opt_ENABLE_DNS_SRV)
-      {
-        std::string err =
-          std::string("Unable to connect to any of the hosts of ") +
-          (const char*)dsrc->opt_SERVER + " SRV";
-        set_error("HY000", err.c_str(), 0);
-      }
-      else if (dsrc->opt_MULTI_HOST && hosts.size() > 1) {
-        set_error("HY000", "Unable to connect to any of the hosts", 0);
-      }
-      //The others will retrieve the error from connect
-      return SQL_ERROR;
+      if (outcome.fatal)
+        return connect_error(outcome.native_error, outcome.message.c_str());
+
+      return set_error("HY000", srv ? srv_error.c_str() :
+                       "Unable to connect to any of the hosts", 0);
+    }
+
+    mysql_close(mysql);
+    mysql = connected;
+    tls_session_reused = outcome.tls_reused;
+    if (!srv)
+    {
+      dsrc->opt_SERVER = outcome.host.name;
+      dsrc->opt_PORT = outcome.host.port;
     }
   }
 
+  telemetry.set_attribs(this, dsrc);
+
+  session_created = time(nullptr);
+  rc = setup_session(dsrc);
+
+  guard.set_success(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO);
+  return rc;
+}
+
+
+/**
+  Prepare a freshly established session for use by the driver: check the
+  server version, set the character set, run INITSTMT and apply the
+  connection attributes. Also used for sessions taken from the driver
+  pool, which are reset when parked.
+
+  @param[in]  dsrc   Data source information
+
+  @return Standard SQLRETURN code.
+*/
+SQLRETURN DBC::setup_session(DataSource *dsrc)
+{
+  SQLRETURN rc = SQL_SUCCESS;
+  const my_bool on = 1;
+
   has_query_attrs = mysql->server_capabilities & CLIENT_QUERY_ATTRIBUTES;
+  result_cache_session.clear();
+  result_cache_unsafe = false;
 
   if (!is_minimum_version(mysql->server_version, "4.1.1"))
   {
@@ -1066,7 +2402,7 @@ SQLRETURN DBC::connect(DataSource *dsrc)
     return set_error("08001", "Driver does not support server versions under 4.1.1", 0);
   }
 
-  rc = set_charset_options(dsrc->opt_CHARSET);
+  rc = set_charset_options(dsrc->opt_CHARSET, true);
 
   // It could be an error with expired password in which case we
   // still try to execute init statements and retry below.
@@ -1089,18 +2425,6 @@ SQLRETURN DBC::connect(DataSource *dsrc)
     return SQL_ERROR;
   }
 
-  /*
-    The MySQL server has a workaround for old versions of Microsoft Access
-    (and possibly other products) that is no longer necessary, but is
-    unfortunately enabled by default. We have to turn it off, or it causes
-    other problems.
-  */
-  if (!dsrc->opt_AUTO_IS_NULL &&
-      execute_query("SET SQL_AUTO_IS_NULL = 0", SQL_NTS, true) != SQL_SUCCESS)
-  {
-    return SQL_ERROR;
-  }
-
   ds = *dsrc;
   /* init all needed UTF-8 strings */
   const char *opt_db = ds.opt_DATABASE;
@@ -1109,6 +2433,9 @@ SQLRETURN DBC::connect(DataSource *dsrc)
   if (ds.opt_LOG_QUERY && !query_log)
     query_log = init_query_log();
 
+  perf.reset(ds.opt_PERF_COUNTERS ? new PERF_COUNTERS() : nullptr);
+  perf_dumped = time(nullptr);
+
   /* Set the statement error prefix based on the server version. */
   myodbc::strxmov(st_error_prefix, MYODBC_ERROR_PREFIX, "[mysqld-",
           mysql->server_version, "]", NullS);
@@ -1131,65 +2458,28 @@ SQLRETURN DBC::connect(DataSource *dsrc)
   set_reconnect_result = 1;
 #endif
 
-  /* Make sure autocommit is set as configured. */
-  if (commit_flag == CHECK_AUTOCOMMIT_OFF)
-  {
-    if (!transactions_supported() || ds.opt_NO_TRANSACTIONS)
-    {
-      commit_flag = CHECK_AUTOCOMMIT_ON;
-      rc = set_error(MYERR_01S02,
-             "Transactions are not enabled, option value "
-             "SQL_AUTOCOMMIT_OFF changed to SQL_AUTOCOMMIT_ON",
-             SQL_SUCCESS_WITH_INFO);
-    }
-    else if (autocommit_is_on() && mysql_autocommit(mysql, FALSE))
-    {
-      /** @todo set error */
-      return SQL_ERROR;
-    }
-  }
-  else if ((commit_flag == CHECK_AUTOCOMMIT_ON) &&
-           transactions_supported() && !autocommit_is_on())
+  /* Autocommit and transaction isolation as configured. */
+  if (commit_flag == CHECK_AUTOCOMMIT_OFF &&
+      (!transactions_supported() || ds.opt_NO_TRANSACTIONS))
   {
-    if (mysql_autocommit(mysql, TRUE))
-    {
-      /** @todo set error */
-      return SQL_ERROR;
-    }
+    commit_flag = CHECK_AUTOCOMMIT_ON;
+    rc = set_error(MYERR_01S02,
+           "Transactions are not enabled, option value "
+           "SQL_AUTOCOMMIT_OFF changed to SQL_AUTOCOMMIT_ON",
+           SQL_SUCCESS_WITH_INFO);
   }
 
-  /* Set transaction isolation as configured. */
-  if (txn_isolation != DEFAULT_TXN_ISOLATION)
+  if (txn_isolation != DEFAULT_TXN_ISOLATION && !transactions_supported())
   {
-    char buff[80];
-    const char *level;
-
-    if (txn_isolation & SQL_TXN_SERIALIZABLE)
-      level= "SERIALIZABLE";
-    else if (txn_isolation & SQL_TXN_REPEATABLE_READ)
-      level= "REPEATABLE READ";
-    else if (txn_isolation & SQL_TXN_READ_COMMITTED)
-      level= "READ COMMITTED";
-    else
-      level= "READ UNCOMMITTED";
-
-    if (transactions_supported())
-    {
-      sprintf(buff, "SET SESSION TRANSACTION ISOLATION LEVEL %s", level);
-      if (execute_query(buff, SQL_NTS, true) != SQL_SUCCESS)
-      {
-        return SQL_ERROR;
-      }
-    }
-    else
-    {
-      txn_isolation = SQL_TXN_READ_UNCOMMITTED;
-      rc = set_error(MYERR_01S02,
-             "Transactions are not enabled, so transaction isolation "
-             "was ignored.", SQL_SUCCESS_WITH_INFO);
-    }
+    txn_isolation = SQL_TXN_READ_UNCOMMITTED;
+    rc = set_error(MYERR_01S02,
+           "Transactions are not enabled, so transaction isolation "
+           "was ignored.", SQL_SUCCESS_WITH_INFO);
   }
 
+  if (set_session_vars() != SQL_SUCCESS)
+    return SQL_ERROR;
+
   /*
     AUTO_RECONNECT option needs to be handled with the following
     considerations:
@@ -1222,7 +2512,8 @@ SQLRETURN DBC::connect(DataSource *dsrc)
 
   mysql_get_option(mysql, MYSQL_OPT_NET_BUFFER_LENGTH, &net_buffer_len);
 
-  guard.set_success(rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO);
+  track_io(0);
+
   return rc;
 }
 
@@ -1284,7 +2575,7 @@ SQLRETURN SQL_API MySQLConnect(SQLHDBC   hdbc,
   rc= dbc->connect(&ds);
 
   if (!SQL_SUCCEEDED(rc))
-    dbc->telemetry.set_error(dbc, dbc->error.message);
+    dbc->telemetry.set_error(dbc, dbc->error.message());
 
   return rc;
 #endif
@@ -1398,7 +2689,7 @@ SQLRETURN SQL_API MySQLDriverConnect(SQLHDBC hdbc, SQLHWND hwnd,
     rc = dbc->connect(&ds);
 
     if (!SQL_SUCCEEDED(rc))
-      dbc->telemetry.set_error(dbc, dbc->error.message);
+      dbc->telemetry.set_error(dbc, dbc->error.message());
 
     if (rc == SQL_SUCCESS || rc == SQL_SUCCESS_WITH_INFO)
       goto connected;
@@ -1627,7 +2918,7 @@ connected:
 error:
 
   if (!SQL_SUCCEEDED(rc))
-    dbc->telemetry.set_error(dbc, dbc->error.message);
+    dbc->telemetry.set_error(dbc, dbc->error.message());
   if (hModule)
     FreeLibrary(hModule);
 
@@ -1637,13 +2928,19 @@ error:
 
 void DBC::free_connection_stmts()
 {
-  for (auto it = stmt_list.begin(); it != stmt_list.end(); )
+  while (!stmt_list.empty())
   {
-      STMT *stmt = *it;
-      it = stmt_list.erase(it);
+      STMT *stmt = stmt_list.front();
+      remove_stmt(stmt);
       my_SQLFreeStmt((SQLHSTMT)stmt, SQL_DROP);
   }
-  stmt_list.clear();
+
+  while (!free_stmts.empty())
+  {
+    STMT *stmt = free_stmts.front();
+    free_stmts.pop_front();
+    delete stmt;
+  }
 }
 
 
@@ -1665,7 +2962,8 @@ SQLRETURN SQL_API SQLDisconnect(SQLHDBC hdbc)
 
   dbc->free_connection_stmts();
 
-  dbc->close();
+  if (!dbc->park_session())
+    dbc->close();
 
   if (dbc->ds.opt_LOG_QUERY)
     end_query_log(dbc->query_log);
@@ -1677,6 +2975,92 @@ SQLRETURN SQL_API SQLDisconnect(SQLHDBC hdbc)
 }
 
 
+/**
+  Hand the session over to the driver pool instead of closing it. The
+  session is reset first, so nothing done on this connection leaks into
+  the next one.
+
+  @return true if the session was parked, the connection no longer owns
+          it then.
+*/
+bool DBC::park_session()
+{
+  if (!ds.opt_POOLING || pool_key.empty() || link_lost || !is_connected(this))
+    return false;
+
+  if (mysql_reset_connection(mysql))
+    return false;
+
+  // The reset keeps the current database, put back the configured one
+  const char *opt_db = ds.opt_DATABASE;
+  if (opt_db)
+  {
+    if ((!mysql->db || strcmp(mysql->db, opt_db)) &&
+        mysql_select_db(mysql, opt_db))
+      return false;
+  }
+  else if (mysql->db)
+  {
+    // A database can't be deselected
+    return false;
+  }
+
+  if (!global_session_pool.put(pool_key, mysql, session_created, ds))
+    return false;
+
+  mysql = nullptr;
+  return true;
+}
+
+
+/* Record the outcome of a round trip to the server */
+void DBC::track_io(unsigned int errcode)
+{
+  perf_count(this, PERF_ROUND_TRIPS);
+
+  if (!errcode)
+  {
+    last_io_time = time(nullptr);
+    link_lost = false;
+  }
+  else if (is_connection_lost(errcode))
+    link_lost = true;
+}
+
+
+/**
+  Tell whether the connection is gone for SQL_ATTR_CONNECTION_DEAD.
+
+  The answer comes from what is already known about the connection: the
+  outcome of the last calls and the state of the socket. The server is
+  pinged only if the socket has unexpected data or nothing was heard from
+  the server for more than PING_INTERVAL seconds.
+*/
+bool DBC::connection_is_dead()
+{
+  if (!is_connected(this) || link_lost)
+    return true;
+
+  switch (peek_socket(mysql->net.fd))
+  {
+  case socket_state::closed:
+    link_lost = true;
+    return true;
+
+  case socket_state::idle:
+    if (time(nullptr) - last_io_time < (time_t)ds.opt_PING_INTERVAL)
+      return false;
+    break;
+
+  case socket_state::unknown:
+    break;
+  }
+
+  track_io(mysql_ping(mysql) ? mysql_errno(mysql) : 0);
+  return link_lost;
+}
+
+
 SQLRETURN DBC::execute_query(const char* query,
   SQLULEN query_length, my_bool req_lock)
 {
@@ -1693,12 +3077,15 @@ SQLRETURN DBC::execute_query(const char* query,
     query_length = strlen(query);
   }
 
+  perf_count(this, PERF_BYTES_OUT, query_length);
   if (check_if_server_is_alive(this) ||
     mysql_real_query(mysql, query, (unsigned long)query_length))
   {
     result = set_error(MYERR_S1000, mysql_error(mysql),
       mysql_errno(mysql));
   }
+  track_io(result == SQL_SUCCESS ? 0 : mysql_errno(mysql));
+  result_cache_invalidate(this, query, query_length);
 
   return result;
 
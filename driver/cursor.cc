@@ -44,6 +44,7 @@
 
 #include "driver.h"
 #include <locale.h>
+#include <algorithm>
 
 
 /* Sets affected rows everewhere where SQLRowCOunt could look for */
@@ -103,6 +104,64 @@ static const char *find_used_table(STMT *stmt)
 }
 
 
+static std::string cursor_key(const char *name)
+{
+  std::string key(name);
+  std::transform(key.begin(), key.end(), key.begin(),
+                 [](unsigned char c) { return (char)tolower(c); });
+  return key;
+}
+
+
+/**
+  Give a statement a cursor name, unless another statement of the
+  connection uses it.
+
+  @return false if the name belongs to another statement.
+*/
+bool DBC::set_cursor_name(STMT *stmt, const std::string &name)
+{
+  LOCK_DBC(this);
+
+  std::string key = cursor_key(name.c_str());
+  auto it = cursors.find(key);
+  if (it != cursors.end() && it->second != stmt)
+    return false;
+
+  clear_cursor_name(stmt);
+  cursors[key] = stmt;
+  stmt->cursor.name = name;
+  return true;
+}
+
+
+void DBC::clear_cursor_name(STMT *stmt)
+{
+  LOCK_DBC(this);
+
+  if (stmt->cursor.name.empty())
+    return;
+
+  auto it = cursors.find(cursor_key(stmt->cursor.name.c_str()));
+  if (it != cursors.end() && it->second == stmt)
+    cursors.erase(it);
+  stmt->cursor.name.clear();
+}
+
+
+/**
+  Statement with the given cursor name (compared without regard to case),
+  or NULL.
+*/
+STMT *DBC::find_cursor(const char *name)
+{
+  LOCK_DBC(this);
+
+  auto it = cursors.find(cursor_key(name));
+  return it == cursors.end() ? nullptr : it->second;
+}
+
+
 /**
   Check if a statement involves a positioned cursor using the WHERE CURRENT
   OF syntax.
@@ -130,27 +189,17 @@ char *check_if_positioned_cursor_exists(STMT *pStmt, STMT **pStmtCursor)
     }
 
     /*
-      Scan the list of statements for this connection and see if we
-      can find the cursor name this statement is referring to - it
-      must have a result set to count.
+      Find the statement with the cursor name this statement is referring
+      to. Even if the cursor name matches, the statement must have a
+      result set to count.
     */
-
-    for (STMT *stmt : dbc->stmt_list)
+    STMT *stmt = dbc->find_cursor(cursorName);
+    if (stmt && stmt->result)
     {
       *pStmtCursor= stmt;
-
-      /*
-        Even if the cursor name matches, the statement must have a
-        result set to count.
-      */
-      if ((*pStmtCursor)->result &&
-          (*pStmtCursor)->cursor.name.size() &&
-          !myodbc_strcasecmp((*pStmtCursor)->cursor.name.c_str(),
-                             cursorName))
-      {
-        return (char *)wherePos;
-      }
+      return (char *)wherePos;
     }
+    *pStmtCursor= pStmt;
 
     /* Did we run out of statements without finding a viable cursor? */
     {
@@ -324,6 +373,11 @@ bool set_current_cursor_data(STMT *stmt, SQLUINTEGER irow)
 
     stmt->cursor_row= row_pos;
   }
+
+  /* Positioned operations use all values of the row */
+  if (ssps_used(stmt) && ssps_fetch_lobs(stmt) != SQL_SUCCESS)
+    return false;
+
   return true;
 }
 
@@ -336,7 +390,9 @@ bool set_current_cursor_data(STMT *stmt, SQLUINTEGER irow)
 
 static void set_dynamic_cursor_name(STMT *stmt)
 {
-  stmt->cursor.name = "SQL_CUR" + std::to_string(stmt->dbc->cursor_count++);
+  LOCK_DBC(stmt->dbc);
+  stmt->dbc->set_cursor_name(stmt, "SQL_CUR" +
+                             std::to_string(stmt->dbc->cursor_count++));
 }
 
 
@@ -1476,7 +1532,8 @@ static SQLRETURN batch_insert_std( STMT *stmt, SQLULEN irow, std::string &query
               We have a limited capacity to shove data across the wire, but
               we handle this by sending in multiple calls to exec_stmt_query()
             */
-            if (query.size() + length >= (SQLULEN) stmt->buf_len())
+            if (query.size() + length >=
+                (SQLULEN) std::max(stmt->buf_len(), (size_t)16384))
             {
                 break_insert= TRUE;
                 break;
@@ -1849,7 +1906,9 @@ MySQLSetCursorName(SQLHSTMT hstmt, SQLCHAR *name, SQLSMALLINT len)
       myodbc_casecmp((char *)name, "SQL_CUR", 7) == 0)
     return stmt->set_error( MYERR_34000, NULL, 0);
 
-  stmt->cursor.name= std::string((char*)name, len);
+  if (!stmt->dbc->set_cursor_name(stmt, std::string((char*)name, len)))
+    return stmt->set_error("3C000", "Duplicate cursor name", 0);
+
   return SQL_SUCCESS;
 }
 
@@ -712,8 +712,8 @@ MySQLGetDescField(SQLHDESC hdesc, SQLSMALLINT recnum, SQLSMALLINT fldid,
 
 SQLRETURN DESC::set_error(char *state, const char *message, uint errcode)
 {
-  error.sqlstate = state ? state : "";
-  error.message = std::string(stmt->dbc->st_error_prefix) + message;
+  error.set_state(state);
+  error.set_message(stmt->dbc->st_error_prefix, message);
   error.native_error = errcode;
 
   return SQL_ERROR;
@@ -37,6 +37,8 @@
 std::string thousands_sep, decimal_point, default_locale;
 static int myodbc_inited=0;
 static int mysys_inited=0;
+/* myodbc_end() is called from DllMain, see LibMain() */
+static bool dll_detach= false;
 
 std::string current_dll_location;
 std::string default_plugin_location;
@@ -121,6 +123,7 @@ void myodbc_init(void)
 }
 
 extern void clear_plugin_pool();
+extern void join_background_threads();
 
 /*
   @type    : myodbc3 internal
@@ -147,6 +150,15 @@ void myodbc_end()
     */
     my_thread_end_wait_time= 0;
 #endif
+    /* Parked sessions can't outlive the client library */
+    clear_session_pool();
+    /*
+      In DllMain the threads are gone already: they were joined by
+      SQLFreeEnv(), the process is exiting, or they keep the driver loaded.
+    */
+    if (!dll_detach)
+      join_background_threads();
+
     /*
       When driver is unloaded the plugin pool must be cleared.
       This is because libmysqlclient is unloaded with the driver.
@@ -204,7 +216,9 @@ int APIENTRY LibMain(HANDLE inst, DWORD ul_reason_being_called,
       // Process is about to detach. All has to be deinited to avoid
       // memory leaks even if initialized multiple times (myodbc_inited > 1).
       myodbc_inited = 1;
+      dll_detach = true;
       myodbc_end();
+      dll_detach = false;
     }
     break;
 
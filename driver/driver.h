@@ -72,6 +72,11 @@ using std::nullptr_t;
 #include <vector>
 #include <list>
 #include <mutex>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include <memory>
+#include <chrono>
 
 #define LOCK_STMT(S) CHECK_HANDLE(S); \
   std::unique_lock<std::recursive_mutex> slock(((STMT*)S)->lock)
@@ -83,8 +88,6 @@ using std::nullptr_t;
 #define LOCK_DBC_DEFER(D) std::unique_lock<std::recursive_mutex> dlock(((DBC*)D)->lock, std::defer_lock)
 #define DO_LOCK_DBC() dlock.lock();
 
-#define LOCK_ENV(E) std::unique_lock<std::mutex> elock(E->lock)
-
 // SQL_DRIVER_CONNECT_ATTR_BASE is not defined in all driver managers.
 // Therefore use a custom constant until it becomes a standard.
 #define MYSQL_DRIVER_CONNECT_ATTR_BASE 0x00004000
@@ -92,6 +95,18 @@ using std::nullptr_t;
 #define CB_FIDO_GLOBAL MYSQL_DRIVER_CONNECT_ATTR_BASE + 0x00001000
 #define CB_FIDO_CONNECTION MYSQL_DRIVER_CONNECT_ATTR_BASE + 0x00001001
 
+// Read-only: whether the connection resumed a cached TLS session
+#define MYSQL_ATTR_TLS_SESSION_REUSED MYSQL_DRIVER_CONNECT_ATTR_BASE + 0x00002000
+// Seconds results of the statement are kept in the result cache,
+// overrides RESULT_CACHE_TTL when set on a connection or statement
+#define MYSQL_ATTR_RESULT_CACHE_TTL MYSQL_DRIVER_CONNECT_ATTR_BASE + 0x00002001
+// Read-only: bytes of client memory held by the statement, or by all
+// statements of the connection
+#define MYSQL_ATTR_MEMORY_USED MYSQL_DRIVER_CONNECT_ATTR_BASE + 0x00002002
+// Read-only: performance counters of the connection, or of the process when
+// read with SQLGetEnvAttr(), as "name=value;" pairs
+#define MYSQL_ATTR_PERF_COUNTERS MYSQL_DRIVER_CONNECT_ATTR_BASE + 0x00002003
+
 #if defined(_WIN32) || defined(WIN32)
 # define INTFUNC  __stdcall
 # define EXPFUNC  __stdcall
@@ -138,6 +153,18 @@ using std::nullptr_t;
 
 #define MYSQL_3_21_PROTOCOL 10	  /* OLD protocol */
 #define CHECK_IF_ALIVE	    1800  /* Seconds between queries for ping */
+#define DEFAULT_MAX_LOB_BUFFER (1024*1024) /* LOB bytes kept between rows */
+#define DEFAULT_RESULT_CACHE_SIZE (16*1024*1024) /* Bytes in the result cache */
+#define RESULT_CACHE_MAX_SETS 64 /* SET statements of a session in the key */
+#define POOL_IDLE_TIMEOUT   60    /* Seconds a surplus pooled session waits */
+#define POOL_EVICT_INTERVAL 5     /* Seconds between pool eviction passes */
+#define MULTI_HOST_STAGGER  250   /* Milliseconds before the next host is tried */
+#define HOST_BACKOFF_MIN    5     /* Seconds a failed host is tried last */
+#define HOST_BACKOFF_MAX    300
+#define STMT_FREE_LIST_SIZE 16    /* Dropped statements a connection keeps */
+#define STMT_RECYCLE_MAX_BUF (64*1024) /* Buffer bytes a dropped statement keeps */
+#define ENV_CONN_SHARDS     16    /* Separately locked connection lists */
+#define PERF_SHARDS         16    /* Process counters threads are spread over */
 
 #define MYSQL_MAX_CURSOR_LEN 18   /* Max cursor name length */
 #define MYSQL_STMT_LEN 1024	  /* Max statement length */
@@ -366,12 +393,26 @@ struct DESCREC{
     /* Whether this parameter has been bound by the application
      * (if not, was created by dummy execution) */
     my_bool real_param_done;
-
-    par_struct() : tempbuf(0), is_dae(0), real_param_done(false)
+    /*
+      Data-at-exec value goes to the server chunk by chunk through
+      mysql_stmt_send_long_data() instead of being collected in tempbuf.
+    */
+    bool streamed;
+    /* Something has been sent for the streamed value */
+    bool stream_started;
+    /* Read by libmysql at execution when SQL_NULL_DATA was put */
+    my_bool stream_null;
+    /* Bytes of an incomplete UTF-16 character held back from the last chunk */
+    char pending[2 * sizeof(SQLWCHAR)];
+    unsigned int pending_len;
+
+    par_struct() : tempbuf(0), is_dae(0), real_param_done(false),
+      streamed(false), stream_started(false), stream_null(0), pending_len(0)
     {}
 
     par_struct(const par_struct& p) :
-      tempbuf(p.tempbuf), is_dae(p.is_dae), real_param_done(p.real_param_done)
+      tempbuf(p.tempbuf), is_dae(p.is_dae), real_param_done(p.real_param_done),
+      streamed(false), stream_started(false), stream_null(0), pending_len(0)
     { }
 
     void add_param_data(const char *chunk, unsigned long length);
@@ -391,6 +432,9 @@ struct DESCREC{
     {
       tempbuf.reset();
       is_dae = 0;
+      streamed = stream_started = false;
+      stream_null = 0;
+      pending_len = 0;
     }
 
   }par;
@@ -402,14 +446,32 @@ struct DESCREC{
     /* TODO ugly, but easiest way to handle memory */
     SQLCHAR type_name[40];
 
+    /*
+      UTF-16 copy of a name for the W functions, made on first use. src is
+      the string it was converted from.
+    */
+    struct wide_name {
+      const SQLCHAR *src = nullptr;
+      SQLWSTRING value;
+    };
+    wide_name wname, wtable_name, wbase_column_name, wbase_table_name;
+
     row_struct() : field(nullptr), datalen(0)
     {}
 
+    /* The names have been pointed at new result metadata */
+    void clear_wide_names()
+    {
+      wname.src = wtable_name.src = nullptr;
+      wbase_column_name.src = wbase_table_name.src = nullptr;
+    }
+
     void reset()
     {
       field = nullptr;
       datalen = 0;
       type_name[0] = 0;
+      clear_wide_names();
     }
   }row;
 
@@ -493,6 +555,7 @@ struct DESC {
 
   /* SQL_DESC_ALLOC_USER-specific */
     std::list<STMT*> stmt_list;
+    std::list<DESC*>::iterator dbc_pos; // In DBC::desc_list
 
 
   void stmt_list_remove(STMT *stmt)
@@ -544,6 +607,58 @@ struct STMT_OPTIONS
   SQLUINTEGER     bookmarks = 0;
   void            *bookmark_ptr = nullptr;
   bool            bookmark_insert = false;
+  SQLLEN          result_cache_ttl = -1; /* -1 takes RESULT_CACHE_TTL */
+};
+
+
+/* Counts of PERF_COUNTERS, see perf_counters.cc */
+enum perf_counter
+{
+  PERF_ROUND_TRIPS,
+  PERF_PREPARES,
+  PERF_EXECUTES,
+  PERF_STMT_CACHE_HITS,     /* Statement handles taken from the free list */
+  PERF_RESULT_CACHE_HITS,
+  PERF_BYTES_OUT,           /* Statement text and long data sent */
+  PERF_BYTES_IN,            /* Values of the rows fetched */
+  PERF_ROWS_FETCHED,
+  PERF_CONVERSIONS,
+  PERF_COUNTERS_NUM
+};
+
+/* Time histograms of PERF_COUNTERS */
+enum perf_timer
+{
+  PERF_TIME_QUERY,          /* do_query() */
+  PERF_TIME_GET_RESULT,     /* Storing or starting to read a result */
+  PERF_TIME_FETCH,          /* my_SQLExtendedFetch(), myodbc_single_fetch() */
+  PERF_TIME_CONVERSION,     /* sql_get_data() and the column-wise loops */
+  PERF_TIMERS_NUM
+};
+
+#define PERF_BUCKETS      24  /* Histogram buckets, powers of 2 microseconds */
+#define PERF_MYSQL_TYPES  36  /* Rows of the conversion matrix */
+#define PERF_C_TYPES      39  /* Columns of the conversion matrix */
+
+/*
+  Performance counters of a connection (PERF_COUNTERS option) or of a
+  shard of the process. They are only added to, with relaxed atomics.
+*/
+struct PERF_COUNTERS
+{
+  typedef std::atomic<unsigned long long> counter;
+
+  struct timer
+  {
+    counter calls{0};
+    counter nanos{0};
+    counter buckets[PERF_BUCKETS] = {};
+  };
+
+  counter counts[PERF_COUNTERS_NUM] = {};
+  timer timers[PERF_TIMERS_NUM];
+  /* Conversions by MySQL type and C type, see perf_counters.cc */
+  counter conversions[PERF_MYSQL_TYPES][PERF_C_TYPES] = {};
 };
 
 
@@ -552,9 +667,20 @@ struct STMT_OPTIONS
 struct	ENV
 {
   SQLINTEGER   odbc_ver;
-  std::list<DBC*> conn_list;
   MYERROR      error;
-  std::mutex lock;
+
+  /*
+    Connections of the environment. They are spread over shards with a lock
+    each, so that threads allocating and freeing connections at the same
+    time rarely wait for each other.
+  */
+  struct conn_shard
+  {
+    std::mutex lock;
+    std::list<DBC*> conns;
+  };
+  conn_shard   conn_shards[ENV_CONN_SHARDS];
+  std::atomic<unsigned int> next_shard{0};
 
   ENV(SQLINTEGER ver) : odbc_ver(ver)
   {}
@@ -562,6 +688,7 @@ struct	ENV
   void add_dbc(DBC* dbc);
   void remove_dbc(DBC* dbc);
   bool has_connections();
+  void for_each_dbc(const std::function<void(DBC*)> &func);
 
   ~ENV()
   {}
@@ -574,7 +701,13 @@ struct DBC
   ENV           *env;
   MYSQL         *mysql;
   std::list<STMT*> stmt_list;
+  std::list<STMT*> free_stmts; // Dropped statements, see DBC::new_stmt()
   std::list<DESC*> desc_list; // Explicit descriptors
+  // Statements by cursor name in lower case, see DBC::find_cursor()
+  std::unordered_map<std::string, STMT*> cursors;
+  // Position in the ENV connection list
+  unsigned int  env_shard = 0;
+  std::list<DBC*>::iterator env_pos;
   STMT_OPTIONS  stmt_options;
   MYERROR       error;
   FILE          *query_log = nullptr;
@@ -601,6 +734,29 @@ struct DBC
   SQLULEN       sql_select_limit = -1;
   // Connection have been put to the pool
   int           need_to_wakeup = 0;
+  // Passive connection health, see DBC::connection_is_dead()
+  time_t        last_io_time = 0;   // Last time the server answered
+  bool          link_lost = false;  // A call failed with the link gone
+  // Driver session pool (POOLING option), see DBC::park_session()
+  SQLWSTRING    pool_key;           // Connection string the session is for
+  time_t        session_created = 0;
+  // The TLS handshake resumed a cached session
+  bool          tls_session_reused = false;
+  // The server reports schema changes, so mysql->db is current
+  bool          schema_tracked = false;
+  // Data was changed in the open transaction, see result_cache_invalidate()
+  bool          result_cache_dirty = false;
+  // SET statements run on the session, part of the result cache key
+  std::vector<std::string> result_cache_session;
+  // The session may have changed in ways the key can't tell, see
+  // result_cache_invalidate(), nothing of it is cached
+  bool          result_cache_unsafe = false;
+  // Sum of STMT::mem_held of the statements, see DBC::memory_used()
+  std::atomic<size_t> mem_total{0};
+  // Performance counters, with the PERF_COUNTERS option only
+  std::unique_ptr<PERF_COUNTERS> perf;
+  std::string   perf_text;          // MYSQL_ATTR_PERF_COUNTERS value
+  time_t        perf_dumped = 0;    // Last dump to the query log
   fido_callback_func fido_callback = nullptr;
 
   telemetry::Telemetry<DBC> telemetry;
@@ -608,11 +764,28 @@ struct DBC
   DBC(ENV *p_env);
   void free_explicit_descriptors();
   void free_connection_stmts();
+  STMT *new_stmt();
+  bool keep_stmt(STMT *stmt);
+  size_t memory_used() { return mem_total; }
+  size_t account_memory();
   void add_desc(DESC* desc);
   void remove_desc(DESC *desc);
+  void add_stmt(STMT *stmt);
+  void remove_stmt(STMT *stmt);
+  bool set_cursor_name(STMT *stmt, const std::string &name);
+  void clear_cursor_name(STMT *stmt);
+  STMT *find_cursor(const char *name);
   SQLRETURN set_error(char *state, const char *message, uint errcode);
   SQLRETURN set_error(char *state);
+  SQLRETURN set_connect_options(MYSQL *mysql, DataSource *ds,
+                                MYERROR *err_out = nullptr);
   SQLRETURN connect(DataSource *ds);
+  SQLWSTRING session_pool_key(DataSource *ds);
+  SQLRETURN setup_session(DataSource *ds);
+  SQLRETURN restore_session();
+  bool park_session();
+  void track_io(unsigned int errcode);
+  bool connection_is_dead();
   void execute_prep_stmt(MYSQL_STMT *pstmt, std::string &query,
     std::vector<MYSQL_BIND> &param_bind, MYSQL_BIND *result_bind);
 
@@ -626,7 +799,9 @@ struct DBC
   ~DBC();
 
   void set_charset(std::string charset);
-  SQLRETURN set_charset_options(const char* charset);
+  const char *connection_charset(DataSource *ds);
+  SQLRETURN set_charset_options(const char* charset, bool handshake = false);
+  SQLRETURN set_session_vars();
   SQLRETURN set_error(myodbc_errid errid, const char* errtext,
     SQLINTEGER errcode);
   SQLRETURN execute_query(const char *query,
@@ -659,7 +834,7 @@ struct MY_LIMIT_SCROLLER
    unsigned long long start_offset;
    unsigned long long next_offset, total_rows, query_len;
 
-   MY_LIMIT_SCROLLER() : buf(1024), query(buf.buf), offset_pos(query),
+   MY_LIMIT_SCROLLER() : buf(0), query(buf.buf), offset_pos(query),
                          row_count(0), start_offset(0), next_offset(0),
                          total_rows(0), query_len(0)
    {}
@@ -748,6 +923,80 @@ struct GETDATA{
   {}
 };
 
+/*
+  Rows of a block fetched into buffers bound by column, kept until the
+  block is converted column by column, see fill_fetch_columns().
+*/
+struct FETCH_BLOCK
+{
+  std::vector<MYSQL_ROW> rows;
+  std::vector<unsigned long> lengths; /* field_count lengths per row */
+  std::vector<SQLRETURN> results;
+
+  void resize(size_t row_count, size_t field_count)
+  {
+    rows.resize(row_count);
+    lengths.resize(row_count * field_count);
+    results.resize(row_count);
+  }
+};
+
+/*
+  Value of a variable length column of a server-side prepared statement
+  that did not fit into its bind buffer. It stays in the client library
+  until something asks for it, see ssps_fetch_lob().
+*/
+struct SSPS_LOB
+{
+  bool pending = false;         /* Not read for the current row yet */
+  char *bind_buffer = nullptr;  /* Bind buffer while data replaces it */
+  unsigned long bind_length = 0;
+  std::vector<char> data;       /* The value once it has been read */
+};
+
+/*
+  What the IRD and the result binds of a server-side prepared statement
+  were made from, compared with the fields of the next execution.
+*/
+struct SSPS_FIELD_META
+{
+  enum enum_field_types type;
+  unsigned int flags;
+  unsigned int decimals;
+  unsigned int charsetnr;
+  unsigned long length;
+};
+
+/*
+  Result of a read-only query kept by the result cache. A statement the
+  result is served to holds a reference, so its rows stay valid after the
+  cache has dropped them.
+*/
+struct CACHED_RESULT
+{
+  std::vector<MYSQL_FIELD> fields;
+  std::vector<char*> rows;            /* Never empty, see result_cache.cc */
+  std::vector<unsigned long> lengths;
+  std::string data;                   /* Strings the above point to */
+  my_ulonglong row_count = 0;
+
+  size_t size() const
+  {
+    return sizeof(*this) + data.capacity() +
+           fields.size() * sizeof(MYSQL_FIELD) +
+           rows.size() * (sizeof(char*) + sizeof(unsigned long));
+  }
+};
+
+/* What do_query() found out about a query in the result cache */
+struct RESULT_CACHE_LOOKUP
+{
+  std::string key;                  /* Empty if the query is not cached */
+  std::vector<std::string> tables;  /* Tables the query reads */
+  unsigned long ttl = 0;
+  unsigned long long generation = 0;
+};
+
 struct ODBC_RESULTSET
 {
   MYSQL_RES *res = nullptr;
@@ -1000,6 +1249,7 @@ struct STMT
   charPtrBuf        array;
   charPtrBuf        result_array;
   MYSQL_ROW         current_values;
+  FETCH_BLOCK       fetch_block;
   MYSQL_ROW         (*fix_fields)(STMT *stmt, MYSQL_ROW row);
   MYSQL_FIELD	      *fields;
   MYSQL_ROW_OFFSET  end_of_set;
@@ -1025,6 +1275,11 @@ struct STMT
   long              current_row;
   long              cursor_row;
   char              dae_type; /* data-at-exec type */
+  /*
+    Parameters are bound on the server handle and the data-at-exec ones are
+    being streamed, execution must not bind them again.
+  */
+  bool              long_data_bound;
 
   GETDATA           getdata;
 
@@ -1041,7 +1296,29 @@ struct STMT
   SQLUSMALLINT setpos_op;
 
   MYSQL_STMT *ssps;
+  /*
+    Prepared on the server only to describe the result of a statement that
+    runs through the text protocol, kept for the text in meta_query.
+    meta_described is set while stmt->result holds that metadata.
+  */
+  MYSQL_STMT *meta_ssps;
+  std::string meta_query;
+  bool meta_described;
   MYSQL_BIND *result_bind;
+  /* Rows of a fake result served from the result cache */
+  std::shared_ptr<CACHED_RESULT> cached_result;
+  /*
+    Columns the IRD and result_bind were set up for. While it is not empty
+    they are kept over executions of ssps, see ssps_same_result_meta().
+  */
+  std::vector<SSPS_FIELD_META> result_meta;
+  /*
+    The result metadata while the cursor is closed. result stays NULL
+    until the next execution takes it back.
+  */
+  MYSQL_RES *kept_result;
+  std::vector<SSPS_LOB> lobs;
+  bool defer_lobs; /* LOBs of the current row can be read on demand */
 
   MY_LIMIT_SCROLLER scroller;
 
@@ -1059,6 +1336,24 @@ struct STMT
   std::recursive_mutex lock;
   telemetry::Telemetry<STMT> telemetry;
 
+  /* Position in DBC::stmt_list, or DBC::free_stmts when not listed */
+  std::list<STMT*>::iterator dbc_pos;
+  bool listed = false;
+
+  /*
+    Memory accounting, see STMT::memory_used(). mem_held is what the
+    statement held when it was last accounted, its part of DBC::mem_total.
+  */
+  std::atomic<size_t> mem_held{0};
+  MYSQL_ROWS *counted_rows = nullptr;   /* Stored rows rows_bytes is for */
+  my_ulonglong counted_row_count = 0;
+  size_t rows_bytes = 0;
+  /* Past MEMORY_SOFT_LIMIT the result is read as it is fetched */
+  bool stream_result = false;
+  /* The rows are read one by one up to MEMORY_HARD_LIMIT, see
+     store_result_capped() */
+  bool capped_result = false;
+
   telemetry::Telemetry<DBC>& conn_telemetry()
   {
     assert(dbc);
@@ -1076,7 +1371,8 @@ struct STMT
   size_t buf_pos() { return tempbuf.cur_pos; }
   size_t buf_len() { return tempbuf.buf_len; }
   size_t field_count();
-  MYSQL_ROW fetch_row(bool read_unbuffered = false);
+  size_t memory_used();
+  MYSQL_ROW fetch_row(bool read_unbuffered = false, bool lazy_lobs = false);
   void buf_set_pos(size_t pos) { tempbuf.cur_pos = pos; }
   void buf_add_pos(size_t pos) { tempbuf.cur_pos += pos; }
   void buf_remove_trail_zeroes() { tempbuf.remove_trail_zeroes(); }
@@ -1089,6 +1385,7 @@ struct STMT
 
   SQLRETURN bind_query_attrs(bool use_ssps);
   void reset();
+  void recycle();
 
   void free_unbind();
   void free_reset_out_params();
@@ -1116,14 +1413,16 @@ struct STMT
 
   STMT(DBC *d) : dbc(d), result(NULL), fake_result(false), array(), result_array(),
     current_values(NULL), fields(NULL), end_of_set(NULL),
-    tempbuf(),
+    tempbuf(0),
     stmt_options(dbc->stmt_options), lengths(nullptr), affected_rows(0),
-    current_row(0), cursor_row(0), dae_type(0),
+    current_row(0), cursor_row(0), dae_type(0), long_data_bound(false),
     param_count(0), current_param(0),
     rows_found_in_set(0),
     state(ST_UNKNOWN), dummy_state(ST_DUMMY_UNKNOWN),
     setpos_row(0), setpos_lock(0), setpos_op(0),
-    ssps(NULL), result_bind(NULL), out_params_state(OPS_UNKNOWN),
+    ssps(NULL), meta_ssps(NULL), meta_described(false),
+    result_bind(NULL), kept_result(NULL), defer_lobs(false),
+    out_params_state(OPS_UNKNOWN),
 
     m_ard(this, SQL_DESC_ALLOC_AUTO, DESC_APP, DESC_ROW),
     ard(&m_ard),
@@ -1138,7 +1437,7 @@ struct STMT
     allocate_param_bind(10);
 
     LOCK_DBC(dbc);
-    dbc->stmt_list.emplace_back(this);
+    dbc->add_stmt(this);
   }
 
   ~STMT();
@@ -99,6 +99,7 @@ static MYODBC3_ERR_STR myodbc3_errors[]=
   {"42S22","Column not found", SQL_ERROR},
   {"08S01","Communication link failure", SQL_ERROR},
   {"08004","Server rejected the connection", SQL_ERROR},
+  {"01S07","Fractional truncation", SQL_SUCCESS_WITH_INFO},
 };
 
 
@@ -156,22 +157,24 @@ void myodbc_sqlstate3_init(void)
 MYERROR::MYERROR(myodbc_errid errid, const char* errtext, SQLINTEGER errcode,
   const char* prefix)
 {
-  std::string errmsg;
-
-  errmsg = (errtext ? errtext : myodbc3_errors[errid].message);
   native_error = errcode ? (myodbc_errid)errcode : errid + MYODBC_ERROR_CODE_START;
 
   retcode = myodbc3_errors[errid].retcode;
-  sqlstate = myodbc3_errors[errid].sqlstate;
-  message = prefix + errmsg;
+  set_state(myodbc3_errors[errid].sqlstate);
+  if (errtext)
+    set_message(prefix, errtext);
+  else
+    set_static_message(prefix, myodbc3_errors[errid].message);
 }
 
 MYERROR::MYERROR(const char* state, const char* msg, SQLINTEGER errcode,
   const char* prefix)
 {
-  sqlstate = state ? state : "";
-  message = std::string(prefix ? prefix : MYODBC_ERROR_PREFIX) +
-    (msg ? msg : "");
+  set_state(state);
+  if (msg)
+    set_message(prefix ? prefix : MYODBC_ERROR_PREFIX, msg);
+  else
+    set_static_message(prefix ? prefix : MYODBC_ERROR_PREFIX, "");
   native_error = errcode;
   retcode = SQL_ERROR;
 }
@@ -395,7 +398,7 @@ MySQLGetDiagRec(SQLSMALLINT handle_type, SQLHANDLE handle, SQLSMALLINT record,
   else
     return SQL_INVALID_HANDLE;
 
-  if (error->message.empty())
+  if (error->message().empty())
   {
     *message= (SQLCHAR *)"";
     *sqlstate= (SQLCHAR *)"00000";
@@ -403,15 +406,15 @@ MySQLGetDiagRec(SQLSMALLINT handle_type, SQLHANDLE handle, SQLSMALLINT record,
     return SQL_NO_DATA_FOUND;
   }
 
-  *message= (SQLCHAR *)error->message.c_str();
-  *sqlstate= (SQLCHAR *)error->sqlstate.c_str();
+  *message= (SQLCHAR *)error->message().c_str();
+  *sqlstate= (SQLCHAR *)error->sqlstate;
   *native= error->native_error;
 
   return SQL_SUCCESS;
 }
 
 
-bool is_odbc3_subclass(std::string sqlstate)
+bool is_odbc3_subclass(const char *sqlstate)
 {
   const char *states[]= { "01S00", "01S01", "01S02", "01S06", "01S07", "07S01",
     "08S01", "21S01", "21S02", "25S01", "25S02", "25S03", "42S01", "42S02",
@@ -421,11 +424,11 @@ bool is_odbc3_subclass(std::string sqlstate)
     "IM008", "IM010", "IM011", "IM012"};
   size_t i;
 
-  if (sqlstate.empty())
+  if (!sqlstate || !*sqlstate)
     return false;
 
   for (i= 0; i < sizeof(states) / sizeof(states[0]); ++i)
-    if (sqlstate.compare(states[i]) == 0)
+    if (strcmp(sqlstate, states[i]) == 0)
       return true;
 
   return false;
@@ -514,9 +517,9 @@ MySQLGetDiagField(SQLSMALLINT handle_type, SQLHANDLE handle, SQLSMALLINT record,
     {
       if (record <= 0)
         return SQL_ERROR;
-      auto &sqlstate = error->sqlstate;
+      const char *sqlstate = error->sqlstate;
 
-      if (!sqlstate.empty() && sqlstate[0] == 'I' && sqlstate[1] == 'M')
+      if (sqlstate[0] == 'I' && sqlstate[1] == 'M')
         *char_value= (SQLCHAR *)"ODBC 3.0";
       else
         *char_value= (SQLCHAR *)"ISO 9075";
@@ -552,7 +555,7 @@ MySQLGetDiagField(SQLSMALLINT handle_type, SQLHANDLE handle, SQLSMALLINT record,
   case SQL_DIAG_MESSAGE_TEXT:
     if (record <= 0)
       return SQL_ERROR;
-    *char_value = (SQLCHAR *)error->message.c_str();
+    *char_value = (SQLCHAR *)error->message().c_str();
     return SQL_SUCCESS;
 
   case SQL_DIAG_NATIVE:
@@ -588,7 +591,7 @@ MySQLGetDiagField(SQLSMALLINT handle_type, SQLHANDLE handle, SQLSMALLINT record,
   case SQL_DIAG_SQLSTATE:
     if (record <= 0)
       return SQL_ERROR;
-    *char_value= (SQLCHAR *)error->sqlstate.c_str();
+    *char_value= (SQLCHAR *)error->sqlstate;
     return SQL_SUCCESS;
 
   case SQL_DIAG_SUBCLASS_ORIGIN:
@@ -598,7 +601,7 @@ MySQLGetDiagField(SQLSMALLINT handle_type, SQLHANDLE handle, SQLSMALLINT record,
       if (record <= 0)
         return SQL_ERROR;
 
-      if (is_odbc3_subclass((char*)error->sqlstate.c_str()))
+      if (is_odbc3_subclass(error->sqlstate))
         *char_value= (SQLCHAR *)"ODBC 3.0";
       else
         *char_value= (SQLCHAR *)"ISO 9075";
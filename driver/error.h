@@ -125,18 +125,24 @@ typedef enum myodbc_errid
     MYERR_08S01,
     /* Please add new errors to the end of enum, and not in alphabet order */
     MYERR_08004,
+    MYERR_01S07,
 } myodbc_errid;
 
 /*
   error handler structure
+
+  Only the parts of a diagnostic are kept: SQLSTATE, native code, prefix and
+  text. Static text (the error table, a missing message) is referenced, not
+  copied, and the full message is put together when the application asks
+  for it. Routine warnings like 01004 on every chunk of SQLGetData then
+  don't allocate.
 */
 struct MYERROR
 {
   SQLRETURN   retcode = 0;
   char        current = 0;
-  std::string message;
   SQLINTEGER  native_error = 0;
-  std::string sqlstate;
+  char        sqlstate[SQL_SQLSTATE_SIZE + 1] = { 0 };
 
   MYERROR()
   {}
@@ -164,21 +170,61 @@ struct MYERROR
 
     if (drc == SQL_SUCCESS || drc == SQL_SUCCESS_WITH_INFO)
     {
-      sqlstate = (const char*)state;
-      message = (const char*)msg;
+      set_state((const char*)state);
+      set_message("", (const char*)msg);
     }
     else
     {
-      sqlstate = (const char*)"00000";
-      message = (const char*)"Did not get expected diagnostics";
+      set_state("00000");
+      set_static_message("", "Did not get expected diagnostics");
     }
 
     retcode = rc;
   }
 
+  /* The full message text, formatted on first use */
+  const std::string &message() const
+  {
+    if (!formatted)
+    {
+      full_message.assign(prefix).append(text());
+      formatted = true;
+    }
+    return full_message;
+  }
+
+  const char *text() const
+  {
+    return static_text ? static_text : own_text.c_str();
+  }
+
+  void set_state(const char *state)
+  {
+    strncpy(sqlstate, state ? state : "", SQL_SQLSTATE_SIZE);
+    sqlstate[SQL_SQLSTATE_SIZE] = '\0';
+  }
+
+  /* Keeps a copy of msg */
+  void set_message(const char *pfx, const char *msg)
+  {
+    prefix = pfx;
+    static_text = nullptr;
+    own_text.assign(msg ? msg : "");
+    formatted = false;
+  }
+
+  /* msg must outlive the error: a literal or the error table */
+  void set_static_message(const char *pfx, const char *msg)
+  {
+    prefix = pfx;
+    static_text = msg ? msg : "";
+    own_text.clear();
+    formatted = false;
+  }
+
   operator std::string() const
   {
-    return message;
+    return message();
   }
 
   operator bool() const
@@ -189,10 +235,10 @@ struct MYERROR
   void clear()
   {
     retcode = 0;
-    message.clear();
     current = 0;
     native_error = 0;
-    sqlstate.clear();
+    sqlstate[0] = '\0';
+    set_static_message("", "");
   }
 
   MYERROR(const char* state, MYSQL* mysql) :
@@ -203,6 +249,17 @@ struct MYERROR
   MYERROR(const char* state, std::string errmsg) :
     MYERROR(state, errmsg.c_str(), 0, MYODBC_ERROR_PREFIX)
   {}
+
+private:
+  /*
+    Static, or owned by the DBC whose st_error_prefix it is, which outlives
+    the errors of its statements and descriptors.
+  */
+  const char  *prefix = "";
+  const char  *static_text = "";
+  std::string own_text;
+  mutable std::string full_message;
+  mutable bool formatted = false;
 };
 
 /*
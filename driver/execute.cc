@@ -33,6 +33,7 @@
 
 #include "driver.h"
 #include <locale.h>
+#include <algorithm>
 
 /*
   @type    : myodbc3 internal
@@ -43,7 +44,9 @@ SQLRETURN do_query(STMT *stmt, std::string query)
 {
     int error= SQL_ERROR, native_error= 0;
     SQLULEN query_length = query.length();
+    RESULT_CACHE_LOOKUP cache_lookup;
     assert(stmt);
+    PERF_SCOPE perf_scope(stmt->dbc, PERF_TIME_QUERY);
     LOCK_STMT_DEFER(stmt);
 
     if (query.empty())
@@ -56,8 +59,8 @@ SQLRETURN do_query(STMT *stmt, std::string query)
                       stmt->stmt_options.max_rows, TRUE)))
     {
       /* The error is set for DBC, copy it into STMT */
-      stmt->set_error(stmt->dbc->error.sqlstate.c_str(),
-                     stmt->dbc->error.message.c_str(),
+      stmt->set_error(stmt->dbc->error.sqlstate,
+                     stmt->dbc->error.message().c_str(),
                      stmt->dbc->error.native_error);
 
       /* if setting sql_select_limit fails, the query will probably fail anyway too */
@@ -66,13 +69,21 @@ SQLRETURN do_query(STMT *stmt, std::string query)
 
     MYLOG_QUERY(stmt, query.c_str());
     DO_LOCK_STMT();
+
+    if (result_cache_lookup(stmt, query, cache_lookup))
+    {
+      perf_count(stmt->dbc, PERF_RESULT_CACHE_HITS);
+      error= SQL_SUCCESS;
+      goto exit;
+    }
+
     if ( check_if_server_is_alive( stmt->dbc ) )
     {
       stmt->set_error("08S01" /* "HYT00" */,
                       mysql_error(stmt->dbc->mysql),
                       mysql_errno(stmt->dbc->mysql));
 
-      translate_error((char*)stmt->error.sqlstate.c_str(), MYERR_08S01 /* S1000 */,
+      translate_error(stmt->error.sqlstate, MYERR_08S01 /* S1000 */,
                       mysql_errno(stmt->dbc->mysql));
       goto exit;
     }
@@ -104,17 +115,25 @@ SQLRETURN do_query(STMT *stmt, std::string query)
 
       native_error = mysql_real_query(stmt->dbc->mysql, stmt->scroller.query,
                                   (unsigned long)stmt->scroller.query_len);
+      perf_count(stmt->dbc, PERF_BYTES_OUT, stmt->scroller.query_len);
     }
       /* Not using ssps for scroller so far. Relaxing a bit condition
        if MULTI_STATEMENTS option selected by primitive check if
        this is a batch of queries */
     else if (ssps_used(stmt))
     {
-
-      native_error = stmt->bind_query_attrs(true);
-      if (native_error == SQL_ERROR) {
-        error = stmt->error.retcode;
-        goto exit;
+      if (stmt->long_data_bound)
+      {
+        /* Binding again would discard the long data sent so far */
+        stmt->long_data_bound= false;
+      }
+      else
+      {
+        native_error = stmt->bind_query_attrs(true);
+        if (native_error == SQL_ERROR) {
+          error = stmt->error.retcode;
+          goto exit;
+        }
       }
 
       native_error = mysql_stmt_execute(stmt->ssps);
@@ -136,21 +155,49 @@ SQLRETURN do_query(STMT *stmt, std::string query)
 
       native_error= mysql_real_query(stmt->dbc->mysql, query.c_str(),
         (unsigned long)query_length);
+      perf_count(stmt->dbc, PERF_BYTES_OUT, query_length);
     }
 
     MYLOG_QUERY(stmt, "query has been executed");
+    stmt->dbc->track_io(!native_error ? 0 : ssps_used(stmt) ?
+                        mysql_stmt_errno(stmt->ssps) :
+                        mysql_errno(stmt->dbc->mysql));
 
     if (native_error)
     {
       error = stmt->set_error("HY000");
-      MYLOG_QUERY(stmt, stmt->error.message.c_str());
+      MYLOG_QUERY(stmt, stmt->error.message().c_str());
 
       /* For some errors - translating to more appropriate status */
-      translate_error((char*)stmt->error.sqlstate.c_str(), MYERR_S1000,
+      translate_error(stmt->error.sqlstate, MYERR_S1000,
                       stmt->error.native_error);
       goto exit;
     }
 
+    result_cache_invalidate(stmt->dbc, query.c_str(), query_length);
+
+    /* Result metadata kept from the previous execution of the statement */
+    if (!stmt->result_meta.empty())
+    {
+      if (ssps_same_result_meta(stmt))
+      {
+        if (get_result(stmt))
+        {
+          error = stmt->set_error(MYERR_S1000);
+          goto exit;
+        }
+        if (memory_check_result(stmt))
+        {
+          error = SQL_ERROR;
+          goto exit;
+        }
+        stmt->state= ST_EXECUTED;
+        error= SQL_SUCCESS;
+        goto exit;
+      }
+      ssps_free_result_meta(stmt);
+    }
+
     if (!get_result_metadata(stmt, FALSE))
     {
       /* Query was supposed to return result, but result is NULL*/
@@ -175,9 +222,16 @@ SQLRETURN do_query(STMT *stmt, std::string query)
         error = stmt->set_error(MYERR_S1000);
         goto exit;
     }
+    if (memory_check_result(stmt))
+    {
+      error = SQL_ERROR;
+      goto exit;
+    }
     /* Caching row counts for queries returning resultset as well */
     //update_affected_rows(stmt);
     fix_result_types(stmt);
+    ssps_save_result_meta(stmt);
+    result_cache_store(stmt, cache_lookup);
 
     /* If the only resultset is OUT params, then we can only detect
        corresponding server_status right after execution.
@@ -200,9 +254,11 @@ SQLRETURN do_query(STMT *stmt, std::string query)
 exit:
 
     if (!SQL_SUCCEEDED(error)) {
-      stmt->telemetry.set_error(stmt, stmt->error.message);
+      stmt->telemetry.set_error(stmt, stmt->error.message());
     }
 
+    perf_dump(stmt->dbc);
+
     /*
       If the original query was modified, we reset stmt->query so that the
       next execution re-starts with the original query.
@@ -658,7 +714,7 @@ SQLRETURN convert_c_type2str(STMT *stmt, SQLSMALLINT ctype, DESCREC *iprec,
         /* TODO no way to return an error here? */
         if (trunc == SQLNUM_TRUNC_FRAC)
         {/* 01S07 SQL_SUCCESS_WITH_INFO */
-          stmt->set_error("01S07", "Fractional truncation", 0);
+          stmt->set_error(MYERR_01S07, NULL, 0);
           return SQL_SUCCESS_WITH_INFO;
         }
         else if (trunc == SQLNUM_TRUNC_WHOLE)
@@ -765,6 +821,39 @@ const char *get_date_time_substr(const char *data, long &len)
   @param[in]      aprec The APD record of the parameter
   @param[in]      iprec The IPD record of the parameter
 */
+/*
+  Whether a data-at-exec parameter can be streamed to the server in chunks
+  rather than assembled on the client: character and binary data for a
+  character or binary column of a server side prepared statement.
+*/
+static bool is_streamable_param(STMT *stmt, DESCREC *aprec, DESCREC *iprec)
+{
+  return ssps_used(stmt) && stmt->dae_type == DAE_NORMAL &&
+         stmt->setpos_op == 0 && iprec != NULL &&
+         (aprec->concise_type == SQL_C_BINARY ||
+          aprec->concise_type == SQL_C_CHAR ||
+          aprec->concise_type == SQL_C_WCHAR) &&
+         (is_binary_sql_type(iprec->concise_type) ||
+          is_char_sql_type(iprec->concise_type) ||
+          is_wchar_sql_type(iprec->concise_type));
+}
+
+
+/* The type insert_param() would bind the assembled value with */
+static enum enum_field_types long_data_type(STMT *stmt, DESCREC *aprec,
+                                            DESCREC *iprec)
+{
+  if (!is_binary_sql_type(iprec->concise_type) &&
+      aprec->concise_type == SQL_C_WCHAR &&
+      stmt->dbc->cxn_charset_info->number != UTF8_CHARSET_NUMBER)
+  {
+    return MYSQL_TYPE_BLOB;
+  }
+
+  return MYSQL_TYPE_STRING;
+}
+
+
 SQLRETURN insert_param(STMT *stmt, MYSQL_BIND *bind, DESC* apd,
                        DESCREC *aprec, DESCREC *iprec, SQLULEN row)
 {
@@ -854,6 +943,17 @@ SQLRETURN insert_param(STMT *stmt, MYSQL_BIND *bind, DESC* apd,
     }
     else if (IS_DATA_AT_EXEC(octet_length_ptr))
     {
+        if (aprec->par.streamed && bind != NULL)
+        {
+          /* The value goes to the server through mysql_stmt_send_long_data() */
+          if (bind_param(bind, "", 0, long_data_type(stmt, aprec, iprec)))
+          {
+            return stmt->set_error(MYERR_S1001, NULL, 4001);
+          }
+          bind->is_null= &aprec->par.stream_null;
+          return SQL_SUCCESS;
+        }
+
         length = (long)aprec->par.val_length();
         if ( !(data= aprec->par.val()) )
         {
@@ -1302,6 +1402,511 @@ BOOL map_error_to_param_status( SQLUSMALLINT *param_status_ptr, SQLRETURN rc)
 }
 
 
+/*
+  Whether the sets of an array of parameters can go to the server a window at
+  a time, as one multi-statement query: the statement returns no results
+  (CALL results are discarded), it is a single statement and it has no
+  output parameters.
+*/
+static bool use_pipeline(STMT *stmt, bool is_select_stmt)
+{
+  if (stmt->apd->array_size < 2 || stmt->dbc->ds.opt_PIPELINE_WINDOW < 2 ||
+      is_select_stmt ||
+      (stmt->query.returns_result() && stmt->query.query_type != myqtCall) ||
+      !single_statement_length(GET_QUERY(&stmt->query),
+                               GET_QUERY_LENGTH(&stmt->query)))
+  {
+    return false;
+  }
+
+  for (uint i= 0; i < stmt->param_count; ++i)
+  {
+    DESCREC *iprec= desc_get_rec(stmt->ipd, i, FALSE);
+
+    if (iprec && iprec->parameter_type != SQL_PARAM_INPUT)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+/*
+  Sends queries[first..] as one multi-statement query and reads the results.
+  The server stops at the first failing statement. Returns the number of
+  statements executed including a failed one, whose error is set on the
+  statement and returned in *rc.
+*/
+static size_t send_pipeline(STMT *stmt,
+                            const std::vector<std::pair<std::string, SQLUSMALLINT*>> &queries,
+                            size_t first, SQLRETURN *rc)
+{
+  MYSQL *mysql= stmt->dbc->mysql;
+  std::string batch;
+  size_t done= 0;
+  int status;
+
+  /* Without the ';' and comments the statements may end with */
+  for (size_t i= first; i < queries.size(); ++i)
+  {
+    const std::string &query= queries[i].first;
+
+    if (i > first)
+      batch.append(";");
+    batch.append(query, 0, single_statement_length(query.c_str(),
+                                                   query.length()));
+  }
+
+  *rc= SQL_SUCCESS;
+  MYLOG_QUERY(stmt, batch.c_str());
+
+  if (stmt->bind_query_attrs(false) == SQL_ERROR)
+  {
+    *rc= SQL_ERROR;
+    return 1;
+  }
+
+  status= mysql_real_query(mysql, batch.c_str(),
+                           (unsigned long)batch.length()) ? 1 : 0;
+  perf_count(stmt->dbc, PERF_BYTES_OUT, batch.length());
+
+  while (status == 0)
+  {
+    MYSQL_RES *res= mysql_store_result(mysql);
+
+    if (res)
+    {
+      mysql_free_result(res);
+    }
+    else if (mysql_field_count(mysql))
+    {
+      status= 1;
+      break;
+    }
+    else
+    {
+      stmt->affected_rows+= mysql_affected_rows(mysql);
+      ++done;
+    }
+
+    status= mysql_next_result(mysql);
+  }
+
+  stmt->dbc->track_io(status > 0 ? mysql_errno(mysql) : 0);
+
+  if (status > 0)
+  {
+    *rc= stmt->set_error("HY000");
+    translate_error(stmt->error.sqlstate, MYERR_S1000,
+                    stmt->error.native_error);
+    ++done;
+  }
+
+  /* Never more than the sets sent, whatever statuses came back */
+  return std::min(done, queries.size() - first);
+}
+
+
+/*
+  For INSERT INTO t [(cols)] VALUES (?, ...) with nothing else in it, gets
+  the table and the column list LOAD DATA needs.
+*/
+static bool bulk_load_target(STMT *stmt, std::string &table,
+                             std::string &columns)
+{
+  const char *insert= stmt->query.get_token(0);
+  const char *into= stmt->query.get_token(1);
+  const char *target= stmt->query.get_token(2);
+  const char *end= GET_QUERY_END(&stmt->query);
+  const char *pos, *head_end;
+
+  if (!target || stmt->param_count == 0 ||
+      myodbc_casecmp(insert, "INSERT", 6) || !isspace((uchar)insert[6]) ||
+      myodbc_casecmp(into, "INTO", 4) || !isspace((uchar)into[4]))
+  {
+    return false;
+  }
+
+  /* Nothing but markers, commas and spaces inside VALUES ( ... ) */
+  for (uint i= 0; i < stmt->param_count; ++i)
+  {
+    pos= stmt->query.get_param_pos(i) + 1;
+    const char *next= i + 1 < stmt->param_count ?
+                      stmt->query.get_param_pos(i + 1) : end;
+    bool sep= false;
+
+    for (; pos < next; ++pos)
+    {
+      if (isspace((uchar)*pos))
+        continue;
+      if (sep || *pos != (i + 1 < stmt->param_count ? ',' : ')'))
+        break;
+      sep= true;
+    }
+
+    if (i + 1 == stmt->param_count)
+    {
+      while (pos < end && (isspace((uchar)*pos) || *pos == ';'))
+        ++pos;
+    }
+
+    if (pos != next || !sep)
+    {
+      return false;
+    }
+  }
+
+  head_end= stmt->query.get_param_pos(0);
+  while (head_end > target && isspace((uchar)head_end[-1]))
+    --head_end;
+  if (head_end == target || *--head_end != '(')
+  {
+    return false;
+  }
+  while (head_end > target && isspace((uchar)head_end[-1]))
+    --head_end;
+
+  if (head_end - target > 6 && !myodbc_casecmp(head_end - 6, "VALUES", 6))
+    head_end-= 6;
+  else if (head_end - target > 5 && !myodbc_casecmp(head_end - 5, "VALUE", 5))
+    head_end-= 5;
+  else
+    return false;
+
+  if (!isspace((uchar)head_end[-1]) && head_end[-1] != ')' &&
+      head_end[-1] != '`')
+  {
+    return false;
+  }
+
+  /* The column list starts at the first parenthesis outside of quotes */
+  char quote= 0;
+  for (pos= target; pos < head_end; ++pos)
+  {
+    if (quote)
+    {
+      if (*pos == quote)
+        quote= 0;
+    }
+    else if (*pos == '`' || *pos == '"')
+      quote= *pos;
+    else if (*pos == '(')
+      break;
+  }
+
+  table.assign(target, pos);
+  columns.assign(pos, head_end);
+  while (!columns.empty() && isspace((uchar)columns.back()))
+    columns.pop_back();
+  while (!table.empty() && isspace((uchar)table.back()))
+    table.pop_back();
+
+  return !table.empty() && (columns.empty() || columns.back() == ')');
+}
+
+
+/*
+  Appends a value insert_param() wrote for the query text as a LOAD DATA
+  field. Returns false for what a field can't carry, like DEFAULT.
+*/
+static bool append_load_data_field(std::string &stream, const char *lit,
+                                   size_t len)
+{
+  if (len == 4 && !memcmp(lit, "NULL", 4))
+  {
+    stream.append("\\N");
+    return true;
+  }
+
+  if (len > 7 && !memcmp(lit, "_binary", 7))
+  {
+    lit+= 7;
+    len-= 7;
+  }
+
+  if (len >= 2 && lit[0] == '\'' && lit[len - 1] == '\'')
+  {
+    stream.append(lit, len);
+    return true;
+  }
+
+  if (len == 0 || (len == 7 && !myodbc_casecmp(lit, "DEFAULT", 7)))
+  {
+    return false;
+  }
+
+  for (size_t i= 0; i < len; ++i)
+  {
+    if (!isalnum((uchar)lit[i]) && !strchr(".+-:", lit[i]))
+      return false;
+  }
+
+  stream.append(lit, len);
+  return true;
+}
+
+
+/*
+  Whether LOAD DATA LOCAL stores the sets as separate INSERTs would. LOCAL
+  makes the server carry on past bad rows: in strict SQL mode data errors
+  become warnings and the rows are stored truncated or coerced, and rows
+  with a duplicate key are skipped without saying which. An INSERT of such
+  a set fails instead. So only tables without unique keys are bulk loaded,
+  outside strict mode.
+*/
+static bool bulk_load_keeps_errors(STMT *stmt, const std::string &table)
+{
+  DBC *dbc= stmt->dbc;
+  MYSQL_RES *res;
+  MYSQL_ROW row;
+  bool strict= true, unique= true;
+
+  if (!SQL_SUCCEEDED(dbc->execute_query("SELECT @@SESSION.sql_mode",
+                                        SQL_NTS, TRUE)))
+    return false;
+
+  if ((res= mysql_store_result(dbc->mysql)))
+  {
+    if ((row= mysql_fetch_row(res)) && row[0])
+      strict= strstr(row[0], "STRICT_TRANS_TABLES") ||
+              strstr(row[0], "STRICT_ALL_TABLES");
+    mysql_free_result(res);
+  }
+  if (strict)
+    return false;
+
+  std::string query= "SHOW INDEX FROM " + table + " WHERE Non_unique = 0";
+  if (!SQL_SUCCEEDED(dbc->execute_query(query.c_str(), query.length(), TRUE)))
+    return false;
+
+  if ((res= mysql_store_result(dbc->mysql)))
+  {
+    unique= mysql_num_rows(res) > 0;
+    mysql_free_result(res);
+  }
+
+  return !unique;
+}
+
+
+struct load_data_stream
+{
+  const std::string *data;
+  size_t pos;
+};
+
+static int load_data_init(void **ptr, const char *, void *userdata)
+{
+  *ptr= userdata;
+  return 0;
+}
+
+static int load_data_read(void *ptr, char *buf, unsigned int buf_len)
+{
+  load_data_stream *in= (load_data_stream *)ptr;
+  size_t len= myodbc_min((size_t)buf_len, in->data->size() - in->pos);
+
+  memcpy(buf, in->data->data() + in->pos, len);
+  in->pos+= len;
+
+  return (int)len;
+}
+
+static void load_data_end(void *)
+{
+}
+
+static int load_data_error(void *, char *msg, unsigned int msg_len)
+{
+  if (msg_len)
+    *msg= '\0';
+  return 0;
+}
+
+
+/*
+  Inserts an array of parameters for a plain INSERT ... VALUES with one
+  LOAD DATA LOCAL INFILE, fed from the values serialized in memory. Returns
+  false if the statement or the values don't qualify or the server refuses
+  local files, nothing has been inserted then. Otherwise puts the result of
+  every set in row_rc, SQL_NO_DATA for the ignored ones.
+
+  A set gets the result its INSERT would have had, which is why strict SQL
+  mode and tables with unique keys are left to the INSERTs, see
+  bulk_load_keeps_errors(). The warnings of the rest, like truncated
+  values, are mapped back to their sets.
+*/
+static bool bulk_load(STMT *stmt, std::vector<SQLRETURN> &row_rc,
+                      bool &with_info)
+{
+  DBC *dbc= stmt->dbc;
+  MYSQL *mysql= dbc->mysql;
+  DESC *apd= stmt->apd;
+  std::string table, columns, stream, query;
+  std::vector<SQLULEN> line_row;
+
+  if (dbc->ds.opt_BULK_LOAD_ROWS == 0 || !dbc->ds.opt_ENABLE_LOCAL_INFILE ||
+      apd->array_size < (SQLULEN)dbc->ds.opt_BULK_LOAD_ROWS ||
+      is_no_backslashes_escape_mode(dbc) || IS_BATCH(&stmt->query) ||
+      stmt->query.query_type != myqtInsert ||
+      desc_find_dae_rec(apd) > -1 || !bulk_load_target(stmt, table, columns))
+  {
+    return false;
+  }
+
+  for (uint i= 0; i < stmt->param_count; ++i)
+  {
+    DESCREC *aprec= desc_get_rec(apd, i, FALSE);
+    DESCREC *iprec= desc_get_rec(stmt->ipd, i, FALSE);
+
+    /* Raw bytes would be read in the connection character set */
+    if (!aprec || !aprec->par.real_param_done || !iprec ||
+        is_binary_sql_type(iprec->concise_type))
+    {
+      return false;
+    }
+  }
+
+  if (!bulk_load_keeps_errors(stmt, table))
+  {
+    return false;
+  }
+
+  row_rc.assign(apd->array_size, SQL_SUCCESS);
+
+  for (SQLULEN row= 0; row < apd->array_size; ++row)
+  {
+    SQLUSMALLINT *operation= (SQLUSMALLINT*)ptr_offset_adjust(apd->array_status_ptr,
+                                             NULL, 0, sizeof(SQLUSMALLINT), row);
+    size_t line_start= stream.size();
+
+    if (operation && *operation == SQL_PARAM_IGNORE)
+    {
+      row_rc[row]= SQL_NO_DATA;
+      continue;
+    }
+
+    for (uint i= 0; i < stmt->param_count && SQL_SUCCEEDED(row_rc[row]); ++i)
+    {
+      SQLRETURN rc;
+
+      stmt->buf_set_pos(0);
+      rc= insert_param(stmt, NULL, apd, desc_get_rec(apd, i, FALSE),
+                       desc_get_rec(stmt->ipd, i, FALSE), row);
+
+      if (!SQL_SUCCEEDED(rc))
+      {
+        row_rc[row]= rc;
+        break;
+      }
+
+      if (rc != SQL_SUCCESS)
+        row_rc[row]= rc;
+
+      if (i)
+        stream.append("\t");
+
+      if (!append_load_data_field(stream, stmt->buf(), stmt->buf_pos()))
+      {
+        stmt->buf_set_pos(0);
+        return false;
+      }
+    }
+
+    if (SQL_SUCCEEDED(row_rc[row]))
+    {
+      stream.append("\n");
+      line_row.push_back(row);
+    }
+    else
+    {
+      stream.resize(line_start);
+    }
+  }
+  stmt->buf_set_pos(0);
+
+  if (line_row.empty())
+  {
+    return true;
+  }
+
+  query= "LOAD DATA LOCAL INFILE 'myodbc-bulk-load' INTO TABLE ";
+  query.append(table).append(" CHARACTER SET ");
+  query.append(mysql_character_set_name(mysql));
+  query.append(" FIELDS TERMINATED BY '\\t' OPTIONALLY ENCLOSED BY '\\''"
+               " ESCAPED BY '\\\\' LINES TERMINATED BY '\\n' ");
+  query.append(columns);
+
+  load_data_stream in= { &stream, 0 };
+  mysql_set_local_infile_handler(mysql, load_data_init, load_data_read,
+                                 load_data_end, load_data_error, &in);
+  MYLOG_QUERY(stmt, query.c_str());
+  int failed= mysql_real_query(mysql, query.c_str(),
+                               (unsigned long)query.length());
+  mysql_set_local_infile_default(mysql);
+  dbc->track_io(failed ? mysql_errno(mysql) : 0);
+  perf_count(dbc, PERF_BYTES_OUT, query.length() + in.pos);
+
+  if (failed)
+  {
+    switch (mysql_errno(mysql))
+    {
+    case 1148: /* ER_NOT_ALLOWED_COMMAND */
+    case 3948: /* ER_CLIENT_LOCAL_FILES_DISABLED */
+    case 2068: /* CR_LOAD_DATA_LOCAL_INFILE_REJECTED */
+      /* Refused before any row was read */
+      return false;
+    }
+
+    stmt->set_error("HY000", mysql_error(mysql), mysql_errno(mysql));
+    translate_error(stmt->error.sqlstate, MYERR_S1000,
+                    stmt->error.native_error);
+    for (SQLULEN row : line_row)
+      row_rc[row]= SQL_ERROR;
+
+    return true;
+  }
+
+  stmt->affected_rows= mysql_affected_rows(mysql);
+  stmt->state= ST_EXECUTED;
+
+  /* Data warnings name the row, the same the INSERT of the set gets */
+  if (mysql_warning_count(mysql) &&
+      !mysql_real_query(mysql, "SHOW WARNINGS", 13))
+  {
+    MYSQL_RES *res= mysql_store_result(mysql);
+    MYSQL_ROW warning;
+
+    while (res && (warning= mysql_fetch_row(res)))
+    {
+      const char *at= warning[2] ? strstr(warning[2], " at row ") : NULL;
+      SQLULEN line= at ? strtoul(at + 8, NULL, 10) : 0;
+
+      if (line > 0 && line <= line_row.size())
+      {
+        row_rc[line_row[line - 1]]= SQL_SUCCESS_WITH_INFO;
+      }
+      with_info= true;
+    }
+
+    if (res)
+      mysql_free_result(res);
+  }
+
+  /* Without unique keys rows are not expected to be skipped */
+  if (stmt->affected_rows < line_row.size())
+  {
+    stmt->set_error("01000", "Some parameter sets were skipped by the server",
+                    0);
+    with_info= true;
+  }
+
+  return true;
+}
+
+
 /*
   @type    : myodbc3 internal
   @purpose : executes a prepared statement, using the current values
@@ -1329,6 +1934,7 @@ SQLRETURN my_SQLExecute( STMT *pStmt )
       return SQL_ERROR;
 
   CLEAR_STMT_ERROR( pStmt );
+  perf_count(pStmt->dbc, PERF_EXECUTES);
 
   pStmt->clear_attr_names();
 
@@ -1396,6 +2002,12 @@ SQLRETURN my_SQLExecute( STMT *pStmt )
 
     is_select_stmt = pStmt->query.is_select_statement();
 
+    /* Windows of parameter sets and LOAD DATA do not go through do_query() */
+    if (!is_select_stmt && pStmt->apd->array_size > 1)
+    {
+      result_cache_invalidate(pStmt->dbc, query.c_str(), query.length());
+    }
+
     /* if ssps is used for select query then convert it to non ssps
     single statement using UNION
     */
@@ -1411,6 +2023,94 @@ SQLRETURN my_SQLExecute( STMT *pStmt )
 
     LOCK_DBC(pStmt->dbc);
 
+    /*
+      The pipeline sends the query text of a window of parameter sets in one
+      round trip. A failing statement ends a window on the server, the sets
+      after it are sent again unless PIPELINE_STOP_ON_ERROR is set.
+    */
+    std::vector<SQLRETURN> bulk_rc;
+    bool bulk_info= false;
+    bool bulk_loaded= bulk_load(pStmt, bulk_rc, bulk_info);
+    bool pipelined= !bulk_loaded && use_pipeline(pStmt, is_select_stmt);
+    bool multi_statements_set= false;
+    std::vector<std::pair<std::string, SQLUSMALLINT*>> window;
+
+    if (pipelined && !pStmt->dbc->ds.opt_MULTI_STATEMENTS)
+    {
+      multi_statements_set= !mysql_set_server_option(pStmt->dbc->mysql,
+                                                     MYSQL_OPTION_MULTI_STATEMENTS_ON);
+      pipelined= multi_statements_set;
+    }
+
+    if (pipelined)
+    {
+      /* Parameters are put into the query text */
+      ssps_close(pStmt);
+    }
+
+    auto flush_window = [&]() -> bool
+    {
+      size_t first= 0;
+
+      while (first < window.size())
+      {
+        bool lost= connection_failure != 0;
+        SQLRETURN window_rc= SQL_ERROR;
+        size_t done= window.size() - first;
+
+        if (!lost)
+        {
+          done= send_pipeline(pStmt, window, first, &window_rc);
+          pStmt->state= ST_EXECUTED;
+
+          if (window_rc != SQL_SUCCESS &&
+              is_connection_lost(pStmt->error.native_error) &&
+              handle_connection_error(pStmt))
+          {
+            connection_failure= 1;
+          }
+        }
+
+        for (size_t i= first; i < first + done; ++i)
+        {
+          rc= lost || (window_rc != SQL_SUCCESS && i == first + done - 1) ?
+              SQL_ERROR : SQL_SUCCESS;
+
+          if (map_error_to_param_status(window[i].second, rc))
+          {
+            lastError= window[i].second;
+          }
+
+          if (rc != SQL_SUCCESS)
+          {
+            one_of_params_not_succeded= 1;
+          }
+          else
+          {
+            all_parameters_failed= 0;
+          }
+        }
+        first+= done;
+
+        if (!lost && window_rc != SQL_SUCCESS &&
+            pStmt->dbc->ds.opt_PIPELINE_STOP_ON_ERROR)
+        {
+          for (size_t i= first; i < window.size(); ++i)
+          {
+            if (window[i].second)
+              *window[i].second= SQL_PARAM_UNUSED;
+            if (pStmt->ipd->rows_processed_ptr)
+              *pStmt->ipd->rows_processed_ptr-= 1;
+          }
+          window.clear();
+          return false;
+        }
+      }
+
+      window.clear();
+      return true;
+    };
+
     for (row= 0; row < pStmt->apd->array_size; ++row)
     {
       if ( pStmt->param_count )
@@ -1448,6 +2148,27 @@ SQLRETURN my_SQLExecute( STMT *pStmt )
           continue;
         }
 
+        /* The set went with LOAD DATA already */
+        if (bulk_loaded)
+        {
+          rc= bulk_rc[row];
+
+          if (map_error_to_param_status(param_status_ptr, rc))
+          {
+            lastError= param_status_ptr;
+          }
+
+          if (rc != SQL_SUCCESS || bulk_info)
+          {
+            one_of_params_not_succeded= 1;
+          }
+          if (SQL_SUCCEEDED(rc))
+          {
+            all_parameters_failed= 0;
+          }
+          continue;
+        }
+
         /*
         * If any parameters are required at execution time, cannot perform the
         * statement. It will be done through SQLPutData() and SQLParamData().
@@ -1500,6 +2221,8 @@ SQLRETURN my_SQLExecute( STMT *pStmt )
 
         if (!SQL_SUCCEEDED(rc))
         {
+          if (pipelined)
+            pStmt->buf_set_pos(0);
           continue/*return rc*/;
         }
 
@@ -1518,10 +2241,28 @@ SQLRETURN my_SQLExecute( STMT *pStmt )
         }
       }
 
+      if (pipelined)
+      {
+        window.emplace_back(query, param_status_ptr);
+        pStmt->buf_set_pos(0);
+
+        if (window.size() >= (size_t)pStmt->dbc->ds.opt_PIPELINE_WINDOW &&
+            !flush_window())
+        {
+          break;
+        }
+        continue;
+      }
+
       if (!is_select_stmt || row == pStmt->apd->array_size-1)
       {
         if (!connection_failure)
         {
+          /* Results of a multi-statement text from the previous set */
+          if (row > 0 && mysql_more_results(pStmt->dbc->mysql))
+          {
+            pStmt->free_fake_result(true);
+          }
           rc = do_query(pStmt, query);
         }
         else
@@ -1566,6 +2307,17 @@ SQLRETURN my_SQLExecute( STMT *pStmt )
       }
     }
 
+    if (pipelined)
+    {
+      flush_window();
+
+      if (multi_statements_set)
+      {
+        mysql_set_server_option(pStmt->dbc->mysql,
+                                MYSQL_OPTION_MULTI_STATEMENTS_OFF);
+      }
+    }
+
     /* Changing status for last detected error to SQL_PARAM_ERROR as we have
       diagnostics for it */
     if (lastError != NULL)
@@ -1608,7 +2360,7 @@ SQLRETURN my_SQLExecute( STMT *pStmt )
   }
   catch(const MYERROR& e)
   {
-    pStmt->telemetry.set_error(pStmt, e.message);
+    pStmt->telemetry.set_error(pStmt, e.message());
   }
 
   return rc;
@@ -1638,7 +2390,60 @@ static SQLRETURN select_dae_param_desc(STMT *stmt, DESC **apd, unsigned int *par
 }
 
 
-/* Looks for next DAE parameter and returns true if finds it */
+static SQLLEN *dae_octet_length_ptr(DESC *apd, DESCREC *aprec)
+{
+  return (SQLLEN*)ptr_offset_adjust(aprec->octet_length_ptr,
+                                    apd->bind_offset_ptr,
+                                    apd->bind_type,
+                                    sizeof(SQLLEN), 0);
+}
+
+
+/*
+  Binds all parameters on the server handle once the data-at-exec values
+  that have to be assembled on the client are complete. The streamable ones
+  are left for mysql_stmt_send_long_data(), returns SQL_NEED_DATA if there
+  is any.
+*/
+static SQLRETURN bind_long_data_params(STMT *stmt)
+{
+  bool streamed= false;
+
+  for (unsigned int i= 0; i < stmt->param_count; ++i)
+  {
+    DESCREC *aprec= desc_get_rec(stmt->apd, i, FALSE);
+    DESCREC *iprec= desc_get_rec(stmt->ipd, i, FALSE);
+
+    if (aprec && iprec &&
+        IS_DATA_AT_EXEC(dae_octet_length_ptr(stmt->apd, aprec)) &&
+        is_streamable_param(stmt, aprec, iprec))
+    {
+      aprec->par.reset();
+      aprec->par.is_dae= 1;
+      aprec->par.streamed= true;
+      streamed= true;
+    }
+  }
+
+  if (!streamed)
+  {
+    return SQL_SUCCESS;
+  }
+
+  std::string query= GET_QUERY(&stmt->query);
+  PUSH_ERROR(insert_params(stmt, 0, query));
+  PUSH_ERROR(stmt->bind_query_attrs(true));
+  stmt->long_data_bound= true;
+
+  return SQL_NEED_DATA;
+}
+
+
+/*
+  Looks for next DAE parameter and returns true if finds it. Parameters that
+  can be streamed are requested after all others, when the statement is
+  bound.
+*/
 static SQLRETURN find_next_dae_param(STMT *stmt,  SQLPOINTER *token)
 {
   unsigned int i, param_count;
@@ -1652,16 +2457,20 @@ static SQLRETURN find_next_dae_param(STMT *stmt,  SQLPOINTER *token)
     SQLLEN *octet_length_ptr;
 
     assert(aprec);
-    octet_length_ptr= (SQLLEN*)ptr_offset_adjust(aprec->octet_length_ptr,
-                                        apd->bind_offset_ptr,
-                                        apd->bind_type,
-                                        sizeof(SQLLEN), 0);
+    octet_length_ptr= dae_octet_length_ptr(apd, aprec);
 
     /* get the "placeholder" pointer the application bound */
     if (IS_DATA_AT_EXEC(octet_length_ptr))
     {
       SQLINTEGER default_size= bind_length(aprec->concise_type,
                                           (ulong)aprec->octet_length);
+
+      if (stmt->long_data_bound ? !aprec->par.streamed :
+          is_streamable_param(stmt, aprec, desc_get_rec(stmt->ipd, i, FALSE)))
+      {
+        continue;
+      }
+
       stmt->current_param= i + 1;
       if (token)
       {
@@ -1670,13 +2479,30 @@ static SQLRETURN find_next_dae_param(STMT *stmt,  SQLPOINTER *token)
                                       apd->bind_type,
                                       default_size, 0);
       }
-      aprec->par.reset();
-      aprec->par.is_dae= 1;
+
+      if (!stmt->long_data_bound)
+      {
+        aprec->par.reset();
+        aprec->par.is_dae= 1;
+      }
 
       return SQL_NEED_DATA;
     }
   }
 
+  if (!stmt->long_data_bound && stmt->dae_type == DAE_NORMAL)
+  {
+    SQLRETURN rc= bind_long_data_params(stmt);
+
+    if (rc == SQL_NEED_DATA)
+    {
+      stmt->current_param= 0;
+      return find_next_dae_param(stmt, token);
+    }
+
+    return rc;
+  }
+
   return SQL_SUCCESS;
 }
 
@@ -1690,7 +2516,9 @@ static SQLRETURN execute_dae(STMT *stmt)
   {
   case DAE_NORMAL:
     query = GET_QUERY(&stmt->query);
-    if (!SQL_SUCCEEDED(rc= insert_params(stmt, 0, query)))
+    /* Streamed parameters have been bound already */
+    if (!stmt->long_data_bound &&
+        !SQL_SUCCEEDED(rc= insert_params(stmt, 0, query)))
       break;
     rc= do_query(stmt, query);
     break;
@@ -1764,40 +2592,6 @@ SQLRETURN SQL_API SQLParamData(SQLHSTMT hstmt, SQLPOINTER *prbgValue)
   {
     PUSH_ERROR(find_next_dae_param(stmt, prbgValue));
 
-     /* Making sure that param_bind array is big enough - might be needed for send_long_data
-       I guess there is a better place for this though */
-    adjust_param_bind_array(stmt);
-
-#ifdef WE_CAN_SEND_LONG_DATA_PROPERLY
-    /*
-      * Course of actions has to be following:
-      * 1) We skip DAE parameters that are good for mysql_send_long_data(i.e. binary params) - specs
-      *    allow us to do that. But we are memorizing we have them(first such parameter index)
-      * 2) After we done with regular dae parameters we do insert_params/mysql_stmt_result_bind
-      * 3) SQLParamData loops thru those parameters now skipping "regular" dae params
-      * 4) After last parameter done - do_query as it is now, but it should not call
-      *    mysql_stmt_bind_param
-      */
-
-    if (stmt->send_data_param > 0)
-    {
-
-      if (mysql_stmt_bind_param(stmt->ssps, (MYSQL_BIND*)stmt->param_bind->buffer))
-      {
-        stmt->set_error("HY000", mysql_stmt_error(stmt->ssps),
-                      mysql_stmt_errno(stmt->ssps));
-
-        /* For some errors - translating to more appropriate status */
-        translate_error(stmt->error.sqlstate, MYERR_S1000,
-                      mysql_stmt_errno(stmt->ssps));
-        return SQL_ERROR;
-      }
-
-      /* Do all stuff for stmt->send_data_param as a dae */
-      return SQL_NEED_DATA;
-    }
-#endif
-
     /* all data-at-exec params are complete. continue execution */
     PUSH_ERROR_UNLESS_EXT(rc, execute_dae(stmt), SQL_PARAM_DATA_AVAILABLE);
   }
@@ -1858,8 +2652,20 @@ SQLRETURN SQL_API SQLPutData( SQLHSTMT      hstmt,
     }
   }
 
+  if (aprec->par.streamed &&
+      (aprec->par.stream_null ||
+       (cbValue == SQL_NULL_DATA && aprec->par.stream_started)))
+  {
+    return stmt->set_error("HY020", "Attempt to concatenate a null value", 0);
+  }
+
   if ( cbValue == SQL_NULL_DATA )
   {
+    if (aprec->par.streamed)
+    {
+      aprec->par.stream_null= 1;
+      return SQL_SUCCESS;
+    }
     aprec->par.reset();
     return SQL_SUCCESS;
   }
@@ -1918,16 +2724,32 @@ SQLRETURN SQL_API SQLCancel(SQLHSTMT hstmt)
     return SQL_ERROR;
   }
 
-  /** @todo need to preserve and use ssl params */
+  /*
+    Same TLS and network settings as the main connection. Errors go to a
+    record of their own, the DBC diagnostics belong to the thread running
+    the query.
+  */
+  MYERROR options_error;
+  if (!SQL_SUCCEEDED(dbc->set_connect_options(second, &dbc->ds,
+                                              &options_error)))
+  {
+    mysql_close(second);
+    return SQL_ERROR;
+  }
+
+  offer_tls_session(second, &dbc->ds, dbc->ds.opt_SERVER, dbc->ds.opt_PORT);
 
   if (!mysql_real_connect(second, dbc->ds.opt_SERVER, dbc->ds.opt_UID,
                           dbc->ds.opt_PWD, NULL, dbc->ds.opt_PORT,
                           dbc->ds.opt_SOCKET, 0))
   {
+    mysql_close(second);
     /* We do not set the SQLSTATE here, per the ODBC spec. */
     return SQL_ERROR;
   }
 
+  save_tls_session(second, &dbc->ds, dbc->ds.opt_SERVER, dbc->ds.opt_PORT);
+
   {
     char buff[40];
     /* buff is always big enough because max length of %lu is 15 */
@@ -46,22 +46,43 @@
 thread_local long thread_count = 0;
 
 std::mutex g_lock;
+/* Environment handles allocated, guarded by g_lock */
+static size_t env_count= 0;
 
 void ENV::add_dbc(DBC* dbc)
 {
-  LOCK_ENV(this);
-  conn_list.emplace_back(dbc);
+  dbc->env_shard = next_shard++ % ENV_CONN_SHARDS;
+  conn_shard &shard = conn_shards[dbc->env_shard];
+  std::lock_guard<std::mutex> guard(shard.lock);
+  dbc->env_pos = shard.conns.insert(shard.conns.end(), dbc);
 }
 
 void ENV::remove_dbc(DBC* dbc)
 {
-  LOCK_ENV(this);
-  conn_list.remove(dbc);
+  conn_shard &shard = conn_shards[dbc->env_shard];
+  std::lock_guard<std::mutex> guard(shard.lock);
+  shard.conns.erase(dbc->env_pos);
 }
 
 bool ENV::has_connections()
 {
-  return conn_list.size() > 0;
+  for (conn_shard &shard : conn_shards)
+  {
+    std::lock_guard<std::mutex> guard(shard.lock);
+    if (!shard.conns.empty())
+      return true;
+  }
+  return false;
+}
+
+void ENV::for_each_dbc(const std::function<void(DBC*)> &func)
+{
+  for (conn_shard &shard : conn_shards)
+  {
+    std::lock_guard<std::mutex> guard(shard.lock);
+    for (DBC *dbc : shard.conns)
+      func(dbc);
+  }
 }
 
 DBC::DBC(ENV *p_env)  : env(p_env), mysql(nullptr),
@@ -75,12 +96,27 @@ DBC::DBC(ENV *p_env)  : env(p_env), mysql(nullptr),
 
 void DBC::add_desc(DESC* desc)
 {
-  desc_list.emplace_back(desc);
+  desc->dbc_pos = desc_list.insert(desc_list.end(), desc);
 }
 
 void DBC::remove_desc(DESC* desc)
 {
-  desc_list.remove(desc);
+  desc_list.erase(desc->dbc_pos);
+}
+
+/* The callers hold the DBC lock */
+void DBC::add_stmt(STMT *stmt)
+{
+  stmt->dbc_pos = stmt_list.insert(stmt_list.end(), stmt);
+  stmt->listed = true;
+}
+
+void DBC::remove_stmt(STMT *stmt)
+{
+  if (!stmt->listed)
+    return;
+  stmt_list.erase(stmt->dbc_pos);
+  stmt->listed = false;
 }
 
 
@@ -109,14 +145,86 @@ DBC::~DBC()
     env->remove_dbc(this);
 
   free_explicit_descriptors();
+
+  for (STMT *stmt : free_stmts)
+    delete stmt;
+}
+
+
+/*
+  Statement handle for SQLAllocHandle(), taken from the free list of
+  statements dropped on this connection when there is one.
+*/
+STMT *DBC::new_stmt()
+{
+  {
+    LOCK_DBC(this);
+    if (!free_stmts.empty())
+    {
+      STMT *stmt = free_stmts.front();
+      stmt_list.splice(stmt_list.end(), free_stmts, free_stmts.begin());
+      stmt->listed = true;
+      perf_count(this, PERF_STMT_CACHE_HITS);
+      return stmt;
+    }
+  }
+
+  return new STMT(this);
+}
+
+
+/*
+  Put a dropped statement on the free list instead of deleting it.
+
+  @return false if the caller has to delete the statement.
+*/
+bool DBC::keep_stmt(STMT *stmt)
+{
+  LOCK_DBC(this);
+
+  if (free_stmts.size() >= STMT_FREE_LIST_SIZE || !stmt->listed)
+    return false;
+
+  stmt->recycle();
+  free_stmts.splice(free_stmts.begin(), stmt_list, stmt->dbc_pos);
+  stmt->listed = false;
+  return true;
+}
+
+
+/*
+  Accounts every statement of the connection again, including the dropped
+  ones kept for reuse, and returns what they hold. memory_used() only
+  returns the running total, which the statements update when they read
+  a result or give memory back. A statement another thread is working with
+  counts with what it held when last accounted.
+*/
+size_t DBC::account_memory()
+{
+  LOCK_DBC(this);
+
+  for (std::list<STMT*> *list : {&stmt_list, &free_stmts})
+  {
+    for (STMT *stmt : *list)
+    {
+      std::unique_lock<std::recursive_mutex> slock(stmt->lock,
+                                                   std::try_to_lock);
+      if (slock.owns_lock())
+        stmt->memory_used();
+    }
+  }
+
+  return memory_used();
 }
 
 
 SQLRETURN DBC::set_error(char * state, const char * message, uint errcode)
 {
-  error.sqlstate = state ? state : "";
-  error.message = std::string(MYODBC_ERROR_PREFIX) + message;
+  error.set_state(state);
+  error.set_message(MYODBC_ERROR_PREFIX, message);
   error.native_error= errcode;
+  if (is_connection_lost(errcode))
+    link_lost= true;
   return SQL_ERROR;
 }
 
@@ -131,6 +239,8 @@ SQLRETURN DBC::set_error(myodbc_errid errid, const char* errtext,
   SQLINTEGER errcode)
 {
   error = MYERROR(errid, errtext, errcode, MYODBC_ERROR_PREFIX);
+  if (is_connection_lost(errcode))
+    link_lost = true;
   return error.retcode;
 }
 
@@ -147,6 +257,7 @@ SQLRETURN SQL_API my_SQLAllocEnv(SQLHENV *phenv)
 
   std::lock_guard<std::mutex> env_guard(g_lock);
   myodbc_init(); // This will call mysql_library_init()
+  ++env_count;
 
 #ifndef USE_IODBC
     env = new ENV(SQL_OV_ODBC3_80);
@@ -166,8 +277,19 @@ SQLRETURN SQL_API my_SQLAllocEnv(SQLHENV *phenv)
 SQLRETURN SQL_API my_SQLFreeEnv(SQLHENV henv)
 {
     ENV *env= (ENV *) henv;
+    std::lock_guard<std::mutex> env_guard(g_lock);
     delete env;
+    --env_count;
 #ifndef _UNIX_
+    /*
+      The driver may be unloaded next, the DllMain that shuts it down then
+      can't wait for threads.
+    */
+    if (!env_count)
+    {
+      clear_session_pool();
+      join_background_threads();
+    }
 #else
     myodbc_end();
 #endif /* _UNIX_ */
@@ -260,6 +382,27 @@ int wakeup_connection(DBC *dbc)
 {
   DataSource &ds = dbc->ds;
 
+  /*
+    The pooled connection is already authenticated as the same user, so
+    resetting the session is enough. Logging in again is only needed when
+    the server can't reset it.
+  */
+  if (!mysql_reset_connection(dbc->mysql))
+  {
+    if (!SQL_SUCCEEDED(dbc->restore_session()))
+    {
+      return 1;
+    }
+
+    dbc->need_to_wakeup= 0;
+    return 0;
+  }
+
+  if (is_connection_lost(mysql_errno(dbc->mysql)))
+  {
+    return 1;
+  }
+
 #if MFA_ENABLED
   if(ds.opt_PWD1)
   {
@@ -293,6 +436,11 @@ int wakeup_connection(DBC *dbc)
     return 1;
   }
 
+  if (!SQL_SUCCEEDED(dbc->restore_session()))
+  {
+    return 1;
+  }
+
   dbc->need_to_wakeup= 0;
   return 0;
 }
@@ -364,7 +512,7 @@ SQLRETURN SQL_API my_SQLAllocStmt(SQLHDBC hdbc, SQLHSTMT *phstmt)
 
   try
   {
-    stmt.reset(new STMT(dbc));
+    stmt.reset(dbc->new_stmt());
   }
   catch (...)
   {
@@ -434,33 +582,61 @@ SQLRETURN SQL_API my_SQLFreeStmtExtended(SQLHSTMT hstmt, SQLUSMALLINT f_option,
 
     stmt->free_reset_out_params();
 
+    /* Gives back to DBC::mem_total what the statement no longer holds */
+    auto account= [stmt]() -> SQLRETURN
+    {
+      if (stmt->mem_held)
+        stmt->memory_used();
+      return SQL_SUCCESS;
+    };
+
     if (f_option == SQL_RESET_PARAMS)
     {
       stmt->free_reset_params();
-      return SQL_SUCCESS;
+      return account();
     }
 
-    stmt->free_fake_result((bool)(f_extra & FREE_STMT_CLEAR_RESULT));
+    /*
+      Closing the cursor of a prepared statement keeps its result metadata
+      for the next execution, which only rebuilds it if the fields changed.
+    */
+    bool keep_result= (f_option == SQL_CLOSE ||
+                       f_option == FREE_STMT_RESET_BUFFERS) &&
+                      (f_extra & FREE_STMT_CLEAR_RESULT) &&
+                      ssps_keep_result(stmt);
 
-    x_free(stmt->fields);   // TODO: Looks like STMT::fields is not used anywhere
-    stmt->result= 0;
-    stmt->fake_result= 0;
-    stmt->fields= 0;
-    stmt->free_lengths();
+    if (!keep_result)
+    {
+      stmt->free_fake_result((bool)(f_extra & FREE_STMT_CLEAR_RESULT));
+
+      x_free(stmt->fields);   // TODO: Looks like STMT::fields is not used anywhere
+      stmt->result= 0;
+      stmt->fake_result= 0;
+      stmt->meta_described= false;
+      stmt->fields= 0;
+      stmt->free_lengths();
+      stmt->fix_fields= 0;
+      stmt->ird->reset();
+
+      /* The IRD is gone, binds kept by an earlier close must follow it */
+      if (!stmt->result_meta.empty())
+        ssps_free_result_meta(stmt);
+    }
     stmt->current_values= 0;   /* For SQLGetData */
-    stmt->fix_fields= 0;
     stmt->affected_rows= 0;
     stmt->current_row= stmt->rows_found_in_set= 0;
     stmt->cursor_row= -1;
     stmt->dae_type= 0;
-    stmt->ird->reset();
 
     if (f_option == FREE_STMT_RESET_BUFFERS)
     {
-      free_result_bind(stmt);
-      stmt->array.reset();
+      if (!keep_result)
+      {
+        free_result_bind(stmt);
+        stmt->array.reset();
+      }
 
-      return SQL_SUCCESS;
+      return account();
     }
 
     stmt->state= ST_UNKNOWN;
@@ -477,7 +653,7 @@ SQLRETURN SQL_API my_SQLFreeStmtExtended(SQLHSTMT hstmt, SQLUSMALLINT f_option,
     stmt->cursor.pk_count= 0;
 
     if (f_option == SQL_CLOSE)
-        return SQL_SUCCESS;
+        return account();
 
     if (f_extra & FREE_STMT_CLEAR_RESULT)
     {
@@ -508,7 +684,7 @@ SQLRETURN SQL_API my_SQLFreeStmtExtended(SQLHSTMT hstmt, SQLUSMALLINT f_option,
 
     if (f_option == FREE_STMT_RESET)
     {
-      return SQL_SUCCESS;
+      return account();
     }
 
     /* explicitly allocated descriptors are affected up until this point */
@@ -522,7 +698,8 @@ SQLRETURN SQL_API my_SQLFreeStmtExtended(SQLHSTMT hstmt, SQLUSMALLINT f_option,
       slock.unlock();
     }
 
-    delete stmt;
+    if (!(f_extra & FREE_STMT_CLEAR_RESULT) || !stmt->dbc->keep_stmt(stmt))
+      delete stmt;
     return SQL_SUCCESS;
 }
 
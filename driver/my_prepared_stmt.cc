@@ -34,6 +34,9 @@
 #include "driver.h"
 #include "errmsg.h"
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
 
 /* {{{ my_l_to_a() -I- */
 static char * my_l_to_a(char * buf, size_t buf_size, long long a)
@@ -253,6 +256,8 @@ int ssps_get_result(STMT *stmt)
   {
     if (stmt->result)
     {
+      memory_limit_reading(stmt);
+
       if (!if_forward_cache(stmt))
       {
         return mysql_stmt_store_result(stmt->ssps);
@@ -303,9 +308,14 @@ void free_result_bind(STMT *stmt)
 {
   if (stmt->result_bind != NULL)
   {
-    auto field_cnt = stmt->field_count();
+    /* Kept binds were made for the fields of an earlier execution */
+    auto field_cnt = stmt->result_meta.empty() ? stmt->field_count() :
+                                                 stmt->result_meta.size();
 
     /* buffer was allocated for each column */
+    ssps_reset_lobs(stmt);
+    stmt->lobs.clear();
+
     for (size_t i = 0; i < field_cnt; i++)
     {
       x_free(stmt->result_bind[i].buffer);
@@ -320,6 +330,13 @@ void free_result_bind(STMT *stmt)
     stmt->result_bind= 0;
     stmt->array.reset();
   }
+  stmt->result_meta.clear();
+
+  if (stmt->kept_result)
+  {
+    mysql_free_result(stmt->kept_result);
+    stmt->kept_result= NULL;
+  }
 }
 
 
@@ -327,6 +344,10 @@ void ssps_close(STMT *stmt)
 {
   if (stmt->ssps != NULL)
   {
+    /* Kept metadata points into the statement that is about to go */
+    if (!stmt->result_meta.empty())
+      ssps_free_result_meta(stmt);
+
     free_result_bind(stmt);
 
     /*
@@ -342,6 +363,101 @@ void ssps_close(STMT *stmt)
 }
 
 
+/*
+  Remembers the fields the IRD and the result binds were set up for, so
+  that closing the cursor can keep them for the next execution.
+*/
+void ssps_save_result_meta(STMT *stmt)
+{
+  stmt->result_meta.clear();
+
+  /* OUT parameters and further results of CALL bring their own fields */
+  if (!ssps_used(stmt) || !stmt->result || !stmt->result_bind ||
+      stmt->fake_result || is_call_procedure(&stmt->query))
+    return;
+
+  for (unsigned int i= 0; i < stmt->result->field_count; ++i)
+  {
+    const MYSQL_FIELD *field= stmt->result->fields + i;
+    stmt->result_meta.push_back({field->type, field->flags, field->decimals,
+                                 field->charsetnr, field->length});
+  }
+}
+
+
+/*
+  Closes the cursor of the prepared statement, leaving the IRD and the
+  result binds in place and the result metadata in kept_result, so the
+  statement has no cursor until it is executed again. Returns false if
+  there is nothing that can be kept, the caller then frees them.
+*/
+bool ssps_keep_result(STMT *stmt)
+{
+  /* Closed already */
+  if (stmt->kept_result)
+    return !stmt->result;
+
+  if (stmt->result_meta.empty() || !ssps_used(stmt) || !stmt->result ||
+      !stmt->result_bind || stmt->fake_result)
+    return false;
+
+  ssps_reset_lobs(stmt);
+  mysql_stmt_free_result(stmt->ssps);
+  stmt->kept_result= stmt->result;
+  stmt->result= NULL;
+  return true;
+}
+
+
+/*
+  Takes back the kept result metadata and checks the fields of the
+  execution that has just run against the kept ones. libmysql updates the
+  fields of the statement in place and the kept result refers to them.
+*/
+bool ssps_same_result_meta(STMT *stmt)
+{
+  if (stmt->kept_result)
+  {
+    stmt_result_free(stmt);
+    stmt->result= stmt->kept_result;
+    stmt->kept_result= NULL;
+  }
+
+  if (!ssps_used(stmt) || !stmt->result ||
+      mysql_stmt_field_count(stmt->ssps) != stmt->result_meta.size())
+    return false;
+
+  for (size_t i= 0; i < stmt->result_meta.size(); ++i)
+  {
+    MYSQL_FIELD *field= stmt->result->fields + i;
+    const SSPS_FIELD_META &meta= stmt->result_meta[i];
+
+    /* Same as fix_result_types() does for the IRD */
+    if (field->type == MYSQL_TYPE_JSON &&
+        field->charsetnr == BINARY_CHARSET_NUMBER)
+      field->charsetnr= UTF8_CHARSET_NUMBER;
+
+    if (field->type != meta.type || field->flags != meta.flags ||
+        field->decimals != meta.decimals ||
+        field->charsetnr != meta.charsetnr || field->length != meta.length)
+      return false;
+  }
+
+  return true;
+}
+
+
+/* Frees what ssps_keep_result() has kept */
+void ssps_free_result_meta(STMT *stmt)
+{
+  free_result_bind(stmt);
+  stmt_result_free(stmt);
+  stmt->free_lengths();
+  stmt->fix_fields= 0;
+  stmt->ird->reset();
+}
+
+
 SQLRETURN ssps_fetch_chunk(STMT *stmt, char *dest, unsigned long dest_bytes, unsigned long *avail_bytes)
 {
   MYSQL_BIND bind;
@@ -542,6 +658,178 @@ allocate_buffer_for_field(const MYSQL_FIELD * const field, BOOL outparams)
 /* }}} */
 
 
+/*
+  Puts back the bind buffers of the LOB values read for the previous row
+  and releases LOB memory above the MAX_LOB_BUFFER cap, so that keeping a
+  huge value once does not pin that much memory for the rest of the
+  result.
+*/
+void ssps_reset_lobs(STMT *stmt)
+{
+  size_t cap = stmt->dbc->ds.opt_MAX_LOB_BUFFER > 0 ?
+               (size_t)stmt->dbc->ds.opt_MAX_LOB_BUFFER :
+               DEFAULT_MAX_LOB_BUFFER;
+
+  for (size_t i = 0; i < stmt->lobs.size(); ++i)
+  {
+    SSPS_LOB &lob = stmt->lobs[i];
+    lob.pending = false;
+
+    if (lob.bind_buffer)
+    {
+      stmt->result_bind[i].buffer = stmt->array[i] = lob.bind_buffer;
+      stmt->result_bind[i].buffer_length = lob.bind_length;
+      lob.bind_buffer = nullptr;
+    }
+
+    if (lob.data.capacity() > cap)
+      std::vector<char>().swap(lob.data);
+  }
+}
+
+
+/*
+  Reads the value of a column that was left in the client library by
+  fetch_varlength_columns() and makes it the column value of the current
+  row. The bind buffer known to libmysql stays as it is, so no rebind is
+  needed and the buffer is put back by ssps_reset_lobs().
+*/
+SQLRETURN ssps_fetch_lob(STMT *stmt, uint column)
+{
+  if (column >= stmt->lobs.size() || !stmt->lobs[column].pending)
+    return SQL_SUCCESS;
+
+  SSPS_LOB &lob = stmt->lobs[column];
+  MYSQL_BIND *col_rbind = &stmt->result_bind[column];
+  unsigned long length = *col_rbind->length;
+  my_bool is_null = 0, error = 0;
+  unsigned long fetched = 0;
+  MYSQL_BIND bind;
+
+  try
+  {
+    lob.data.resize((size_t)length + 1);
+  }
+  catch (const std::bad_alloc &)
+  {
+    return stmt->set_error("HY001", "Memory allocation error", MYERR_S1001);
+  }
+
+  memset(&bind, 0, sizeof(bind));
+  bind.buffer_type = col_rbind->buffer_type;
+  bind.buffer = lob.data.data();
+  bind.buffer_length = length + 1;
+  bind.length = &fetched;
+  bind.is_null = &is_null;
+  bind.error = &error;
+
+  if (mysql_stmt_fetch_column(stmt->ssps, &bind, column, 0))
+  {
+    return stmt->set_error("HY000", mysql_stmt_error(stmt->ssps),
+                           mysql_stmt_errno(stmt->ssps));
+  }
+  lob.data[length] = '\0';
+
+  lob.bind_buffer = (char *)col_rbind->buffer;
+  lob.bind_length = col_rbind->buffer_length;
+  col_rbind->buffer = stmt->array[column] = lob.data.data();
+  col_rbind->buffer_length = length + 1;
+  lob.pending = false;
+
+  return SQL_SUCCESS;
+}
+
+
+/* Makes all values of the current row available through stmt->array */
+SQLRETURN ssps_fetch_lobs(STMT *stmt)
+{
+  for (uint i = 0; i < stmt->lobs.size(); ++i)
+  {
+    SQLRETURN rc = ssps_fetch_lob(stmt, i);
+    if (rc != SQL_SUCCESS)
+      return rc;
+  }
+  return SQL_SUCCESS;
+}
+
+
+/*
+  SQLGetData() into SQL_C_BINARY, or SQL_C_CHAR if terminate is set, for a
+  value that has not been read from the client library. Every call reads
+  the next piece straight into the application buffer, the same way
+  copy_binary_result() and copy_ansi_result() hand it out, so no more than
+  one buffer of the value is ever held by the driver.
+*/
+SQLRETURN ssps_get_lob_chunk(STMT *stmt, uint column, SQLCHAR *result,
+                             SQLLEN result_bytes, SQLLEN *avail_bytes,
+                             bool terminate)
+{
+  MYSQL_BIND *col_rbind = &stmt->result_bind[column];
+  unsigned long src_bytes = *col_rbind->length;
+  unsigned long offset = stmt->getdata.src_offset;
+  unsigned long copy_bytes;
+  SQLRETURN rc = SQL_SUCCESS;
+
+  if (terminate)
+  {
+    /* Room for the terminating null, nothing to copy without it */
+    if (result_bytes > 0)
+      --result_bytes;
+    else
+      result = NULL;
+  }
+
+  if (stmt->stmt_options.max_length &&
+      src_bytes > stmt->stmt_options.max_length)
+    src_bytes = (unsigned long)stmt->stmt_options.max_length;
+
+  if (offset == (unsigned long)~0L)
+    offset = 0;
+  else if (offset >= src_bytes)
+    return SQL_NO_DATA_FOUND;
+
+  src_bytes -= offset;
+  copy_bytes = myodbc_min((unsigned long)result_bytes, src_bytes);
+
+  if (result && copy_bytes && stmt->stmt_options.retrieve_data)
+  {
+    my_bool is_null = 0, error = 0;
+    unsigned long fetched = 0;
+    MYSQL_BIND bind;
+
+    memset(&bind, 0, sizeof(bind));
+    bind.buffer_type = MYSQL_TYPE_BLOB;
+    bind.buffer = result;
+    bind.buffer_length = copy_bytes;
+    bind.length = &fetched;
+    bind.is_null = &is_null;
+    bind.error = &error;
+
+    if (mysql_stmt_fetch_column(stmt->ssps, &bind, column, offset))
+    {
+      return stmt->set_error("HY000", mysql_stmt_error(stmt->ssps),
+                             mysql_stmt_errno(stmt->ssps));
+    }
+  }
+
+  if (terminate && result && stmt->stmt_options.retrieve_data)
+    result[copy_bytes] = '\0';
+
+  if (avail_bytes && stmt->stmt_options.retrieve_data)
+    *avail_bytes = src_bytes;
+
+  stmt->getdata.src_offset = offset + copy_bytes;
+
+  if (src_bytes > (unsigned long)result_bytes)
+  {
+    stmt->set_error("01004", NULL, 0);
+    rc = SQL_SUCCESS_WITH_INFO;
+  }
+
+  return rc;
+}
+
+
 static MYSQL_ROW fetch_varlength_columns(STMT *stmt, MYSQL_ROW values)
 {
   const size_t num_fields = stmt->field_count();
@@ -557,6 +845,12 @@ static MYSQL_ROW fetch_varlength_columns(STMT *stmt, MYSQL_ROW values)
     desc_find_outstream_rec(stmt, &desc_index, &stream_column);
   }
 
+  /*
+    Values that do not fit their buffers are left in the client library
+    while fetching and read only when the application asks for them.
+  */
+  bool lazy = stmt->defer_lobs && stmt->out_params_state == OPS_UNKNOWN &&
+              stmt->lobs.size() == num_fields;
   bool reallocated_buffers = false;
   for (i= 0; i < num_fields; ++i)
   {
@@ -572,6 +866,17 @@ static MYSQL_ROW fetch_varlength_columns(STMT *stmt, MYSQL_ROW values)
           is_varlen_type(stmt->result_bind[i].buffer_type) &&
           stmt->result_bind[i].buffer_length < *stmt->result_bind[i].length)
       {
+        if (lazy)
+        {
+          DESCREC *arrec = desc_get_rec(stmt->ard, i, FALSE);
+          stmt->lobs[i].pending = true;
+
+          /* Bound columns are needed anyway */
+          if (ARD_IS_BOUND(arrec) && ssps_fetch_lob(stmt, i) != SQL_SUCCESS)
+            throw stmt->error;
+          continue;
+        }
+
         /* TODO Realloc error proc */
         stmt->array[i]= (char*)myodbc_realloc(stmt->array[i],
           *stmt->result_bind[i].length);
@@ -661,6 +966,75 @@ void STMT::reset()
     result_array.reset();
 }
 
+/*
+  Bring a statement dropped with SQLFreeHandle() back to the state of a new
+  one. Its buffers are kept unless they grew beyond STMT_RECYCLE_MAX_BUF,
+  the descriptors start over. my_SQLFreeStmtExtended() has already closed
+  the cursor and the prepared statement.
+*/
+void STMT::recycle()
+{
+  reset();
+  result_array.reset();
+  end_of_set = NULL;
+
+  if (result_bind != NULL)
+    free_result_bind(this);
+  if (ssps != NULL)
+  {
+    mysql_stmt_close(ssps);
+    ssps = NULL;
+  }
+  /* A statement kept for SQLDescribeCol() counts against the server limit */
+  meta_ssps_close(this);
+  rb_is_null.reset();
+  rb_err.reset();
+  rb_len.reset();
+
+  error.clear();
+  stmt_options = dbc->stmt_options;
+  dbc->clear_cursor_name(this);
+  catalog_name.clear();
+  clear_param_bind();
+  if (param_bind.size() * sizeof(MYSQL_BIND) > STMT_RECYCLE_MAX_BUF)
+  {
+    std::vector<MYSQL_BIND>().swap(param_bind);
+    allocate_param_bind(10);
+  }
+  tempbuf.shrink(STMT_RECYCLE_MAX_BUF);
+  /* my_SQLFreeStmtExtended() has reset the queries, the text stays */
+  query.buf.shrink(STMT_RECYCLE_MAX_BUF);
+  orig_query.buf.shrink(STMT_RECYCLE_MAX_BUF);
+  clear_attr_names();
+  getdata = GETDATA();
+  lobs.clear();
+  defer_lobs = false;
+  long_data_bound = false;
+
+  current_row = cursor_row = 0;
+  current_param = rows_found_in_set = 0;
+  setpos_row = setpos_lock = setpos_op = 0;
+
+  scroller.row_count = 0;
+  scroller.start_offset = scroller.total_rows = scroller.query_len = 0;
+  scroller.buf.shrink(STMT_RECYCLE_MAX_BUF);
+  scroller.query = scroller.buf.buf;
+  scroller.reset();
+
+  /* Statement attributes kept in the descriptors go back to defaults */
+  m_ard = DESC(this, SQL_DESC_ALLOC_AUTO, DESC_APP, DESC_ROW);
+  m_ird = DESC(this, SQL_DESC_ALLOC_AUTO, DESC_IMP, DESC_ROW);
+  m_apd = DESC(this, SQL_DESC_ALLOC_AUTO, DESC_APP, DESC_PARAM);
+  m_ipd = DESC(this, SQL_DESC_ALLOC_AUTO, DESC_IMP, DESC_PARAM);
+  ard = imp_ard = &m_ard;
+  ird = &m_ird;
+  apd = imp_apd = &m_apd;
+  ipd = &m_ipd;
+
+  if (mem_held)
+    memory_used();
+}
+
 void STMT::free_reset_out_params()
 {
   if (out_params_state == OPS_STREAMS_PENDING)
@@ -669,6 +1043,13 @@ void STMT::free_reset_out_params()
     mysql_stmt_fetch(ssps);
   }
   out_params_state = OPS_UNKNOWN;
+  if (long_data_bound)
+  {
+    /* Data-at-exec was abandoned, drop the long data the server holds */
+    if (ssps)
+      mysql_stmt_reset(ssps);
+    long_data_bound = false;
+  }
   apd->free_paramdata();
   /* reset data-at-exec state */
   dae_type = 0;
@@ -707,6 +1088,7 @@ void STMT::free_fake_result(bool clear_all_results)
     // Otherwise the data in the next resultset might be corrupted.
     reset_result_array();
     stmt_result_free(this);
+    cached_result.reset();
   }
 
 }
@@ -715,7 +1097,7 @@ void STMT::free_fake_result(bool clear_all_results)
 // Clear and free buffers bound in param_bind
 void STMT::clear_param_bind()
 {
-  for (auto bind : param_bind) {
+  for (auto &bind : param_bind) {
     x_free(bind.buffer);
     bind.buffer = nullptr;
   }
@@ -744,11 +1126,14 @@ STMT::~STMT()
     mysql_stmt_close(ssps);
     ssps = NULL;
   }
+  meta_ssps_close(this);
 
   reset_setpos_apd();
 
   LOCK_DBC(dbc);
-  dbc->stmt_list.remove(this);
+  dbc->mem_total -= mem_held;
+  dbc->remove_stmt(this);
+  dbc->clear_cursor_name(this);
   clear_param_bind();
 }
 
@@ -766,6 +1151,8 @@ SQLRETURN STMT::set_error(myodbc_errid errid, const char *errtext,
                          SQLINTEGER errcode)
 {
   error = MYERROR(errid, errtext, errcode, dbc->st_error_prefix);
+  if (is_connection_lost(errcode))
+    dbc->link_lost = true;
   return error.retcode;
 }
 
@@ -781,6 +1168,8 @@ SQLRETURN STMT::set_error(const char *state, const char *msg,
                           SQLINTEGER errcode)
 {
     error = MYERROR(state, msg, errcode, dbc->st_error_prefix);
+    if (is_connection_lost(errcode))
+      dbc->link_lost = true;
     return error.retcode;
 }
 
@@ -948,6 +1337,7 @@ int STMT::ssps_bind_result()
       if ( p.is_varlen_alloc())
       {
         fix_fields= fetch_varlength_columns;
+        lobs.resize(num_fields);
 
         /* Need to alloc it only once*/
         if (lengths == NULL)
@@ -1082,7 +1472,7 @@ SQLRETURN STMT::bind_query_attrs(bool use_ssps)
                 mysql_stmt_errno(ssps));
 
       /* For some errors - translating to more appropriate status */
-      translate_error((char *)error.sqlstate.c_str(), MYERR_S1000,
+      translate_error(error.sqlstate, MYERR_S1000,
                       error.native_error);
       return SQL_ERROR;
     }
@@ -1250,11 +1640,15 @@ char * ssps_get_string(STMT *stmt, ulong column_number, char *value, ulong *leng
 /* }}} */
 
 
-double ssps_get_double(STMT *stmt, ulong column_number, char *value, ulong length)
+double ssps_get_double(STMT *stmt, ulong column_number, char *value, ulong length,
+                       int *status)
 {
   MYSQL_BIND *col_rbind= &stmt->result_bind[column_number];
   double ret = 0;
 
+  if (status)
+    *status = MYODBC_NUM_OK;
+
   if (*col_rbind->is_null)
   {
     return 0.0;
@@ -1284,21 +1678,25 @@ double ssps_get_double(STMT *stmt, ulong column_number, char *value, ulong lengt
 
       return ret;
     }
+    /* Text in the bind buffer is parsed in place */
     case MYSQL_TYPE_DECIMAL:
     case MYSQL_TYPE_NEWDECIMAL:
-    case MYSQL_TYPE_TIMESTAMP:
-    case MYSQL_TYPE_DATETIME:
-    case MYSQL_TYPE_DATE:
-    case MYSQL_TYPE_TIME:
     case MYSQL_TYPE_STRING:
     case MYSQL_TYPE_BLOB:
     case MYSQL_TYPE_VARCHAR:
     case MYSQL_TYPE_VAR_STRING:
+      return myodbc_parse_double((const char *)col_rbind->buffer,
+                                 *col_rbind->length, status);
+
+    case MYSQL_TYPE_TIMESTAMP:
+    case MYSQL_TYPE_DATETIME:
+    case MYSQL_TYPE_DATE:
+    case MYSQL_TYPE_TIME:
     {
       char buf[50];
-      ret = myodbc_strtod(ssps_get_string(stmt, column_number, value,
-                          &length, buf), length);
-      return ret;
+      const char *str = ssps_get_string(stmt, column_number, value,
+                                        &length, buf);
+      return myodbc_parse_double(str, length, status);
     }
 
     case MYSQL_TYPE_FLOAT:
@@ -1322,6 +1720,61 @@ double ssps_get_double(STMT *stmt, ulong column_number, char *value, ulong lengt
 }
 
 
+/*
+  Fill SQL_NUMERIC_STRUCT straight from the result bind buffer: integers
+  are converted from their binary value and DECIMAL, which the binary
+  protocol transfers as text, is parsed in place.
+*/
+void ssps_get_sqlnum(STMT *stmt, ulong column_number, char *value,
+                     ulong length, SQL_NUMERIC_STRUCT *sqlnum,
+                     int *overflow_ptr)
+{
+  MYSQL_BIND *col_rbind= &stmt->result_bind[column_number];
+
+  switch (col_rbind->buffer_type)
+  {
+    case MYSQL_TYPE_YEAR:  // fetched as a SMALLINT
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_LONGLONG:
+      if (col_rbind->is_unsigned)
+      {
+        sqlnum_from_int(ssps_get_int64<unsigned long long>(stmt,
+                          column_number, value, length), false,
+                        sqlnum, overflow_ptr);
+      }
+      else
+      {
+        long long ival= ssps_get_int64<long long>(stmt, column_number,
+                                                  value, length);
+        sqlnum_from_int(ival < 0 ? 0ULL - (unsigned long long)ival : ival,
+                        ival < 0, sqlnum, overflow_ptr);
+      }
+      return;
+
+    case MYSQL_TYPE_DECIMAL:
+    case MYSQL_TYPE_NEWDECIMAL:
+    case MYSQL_TYPE_STRING:
+    case MYSQL_TYPE_BLOB:
+    case MYSQL_TYPE_VARCHAR:
+    case MYSQL_TYPE_VAR_STRING:
+      sqlnum_from_str((const char *)col_rbind->buffer, *col_rbind->length,
+                      sqlnum, overflow_ptr);
+      return;
+
+    default:
+    {
+      char buf[50];
+      const char *str= ssps_get_string(stmt, column_number, value, &length,
+                                       buf);
+      sqlnum_from_str(str, length, sqlnum, overflow_ptr);
+    }
+  }
+}
+
+
 template <typename T>
 T binary2numeric(char* src, uint64 srcLen)
 {
@@ -1340,6 +1793,34 @@ T binary2numeric(char* src, uint64 srcLen)
   return dst;
 }
 
+/*
+  Convert a double to an integer type. Values out of the range of T are
+  saturated and reported as an overflow, dropping a non-zero fractional
+  part is reported as a truncation.
+*/
+template <typename T>
+T double2integer(double val, int *status)
+{
+  const double upper = std::ldexp(1.0, std::numeric_limits<T>::digits);
+  bool in_range = std::is_signed<T>::value ? val >= -upper && val < upper
+                                           : val > -1.0 && val < upper;
+
+  if (!in_range)
+  {
+    if (status)
+      *status = MYODBC_NUM_OVERFLOW;
+    return val < 0 ? std::numeric_limits<T>::min()
+                   : std::numeric_limits<T>::max();
+  }
+
+  T ret = (T)val;
+
+  if (status)
+    *status = (double)ret != val ? MYODBC_NUM_TRUNC_FRAC : MYODBC_NUM_OK;
+
+  return ret;
+}
+
 long long binary2ll(char* src, uint64 srcLen)
 {
   return binary2numeric<long long>(src, srcLen);
@@ -1351,16 +1832,21 @@ unsigned long long binary2ull(char* src, uint64 srcLen)
 }
 
 template <typename T>
-T ssps_get_int64(STMT *stmt, ulong column_number, char *value, ulong length)
+T ssps_get_int64(STMT *stmt, ulong column_number, char *value, ulong length,
+                 int *status)
 {
   MYSQL_BIND *col_rbind= &stmt->result_bind[column_number];
 
+  if (status)
+    *status = MYODBC_NUM_OK;
+
   switch (col_rbind->buffer_type)
   {
     case MYSQL_TYPE_FLOAT:
     case MYSQL_TYPE_DOUBLE:
 
-      return (T)ssps_get_double(stmt, column_number, value, length);
+      return double2integer<T>(ssps_get_double(stmt, column_number, value,
+                                               length), status);
 
     case MYSQL_TYPE_DECIMAL:
     case MYSQL_TYPE_NEWDECIMAL:
@@ -1374,8 +1860,14 @@ T ssps_get_int64(STMT *stmt, ulong column_number, char *value, ulong length)
     case MYSQL_TYPE_VAR_STRING:
     {
       char buf[30];
-      return strtoll(ssps_get_string(stmt, column_number, value, &length, buf),
-                      NULL, 10);
+      const char *str = ssps_get_string(stmt, column_number, value, &length,
+                                        buf);
+      if (!str)
+        return 0;
+
+      if (std::is_signed<T>::value)
+        return (T)myodbc_parse_int64(str, length, status);
+      return (T)myodbc_parse_uint64(str, length, status);
     }
     case MYSQL_TYPE_BIT:
     {
@@ -1400,11 +1892,11 @@ T ssps_get_int64(STMT *stmt, ulong column_number, char *value, ulong length)
         case 1:
           if (is_it_unsigned)
           {
-            ret = !is_it_null? ((char *)col_rbind->buffer)[0]:0;
+            ret = !is_it_null? ((unsigned char *)col_rbind->buffer)[0]:0;
           }
           else
           {
-            ret = !is_it_null? *(char *)(col_rbind->buffer):0;
+            ret = !is_it_null? *(signed char *)(col_rbind->buffer):0;
           }
           break;
 
@@ -1455,6 +1947,17 @@ T ssps_get_int64(STMT *stmt, ulong column_number, char *value, ulong length)
         default:
           return 0;
       }
+
+      /*
+        Same-signed values always fit. Otherwise the value does not fit
+        when it lands on the negative side: a negative number requested as
+        unsigned, or an unsigned BIGINT above the signed maximum.
+      */
+      if (status && is_it_unsigned == std::is_signed<T>::value &&
+          (long long)ret < 0)
+      {
+        *status = MYODBC_NUM_OVERFLOW;
+      }
       return ret;
     }
     default:
@@ -1471,17 +1974,16 @@ T ssps_get_int64(STMT *stmt, ulong column_number, char *value, ulong length)
 SQLRETURN ssps_send_long_data(STMT *stmt, unsigned int param_number, const char *chunk,
                             unsigned long length)
 {
+  perf_count(stmt->dbc, PERF_BYTES_OUT, length);
   if ( mysql_stmt_send_long_data(stmt->ssps, param_number, chunk, length))
   {
     uint err= mysql_stmt_errno(stmt->ssps);
     switch (err)
     {
-      case CR_INVALID_BUFFER_USE:
-      /* We can fall back to assembling parameter's value on client */
-        return SQL_SUCCESS_WITH_INFO;
       case CR_SERVER_GONE_ERROR:
         return stmt->set_error("08S01", mysql_stmt_error(stmt->ssps), err);
       case CR_COMMANDS_OUT_OF_SYNC:
+      case CR_INVALID_BUFFER_USE:
       case CR_UNKNOWN_ERROR:
         return stmt->set_error("HY000", mysql_stmt_error( stmt->ssps), err);
       case CR_OUT_OF_MEMORY:
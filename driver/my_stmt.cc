@@ -90,8 +90,14 @@ my_bool free_current_result(STMT *stmt)
 static
 MYSQL_RES * stmt_get_result(STMT *stmt, BOOL force_use)
 {
-  /* We can't use USE_RESULT because SQLRowCount will fail in this case! */
-  if (if_forward_cache(stmt) || force_use)
+  PERF_SCOPE perf_scope(stmt->dbc, PERF_TIME_GET_RESULT);
+  memory_limit_reading(stmt);
+
+  /*
+    We can't use USE_RESULT because SQLRowCount will fail in this case!
+    A capped result is read to the end before anything else happens.
+  */
+  if (if_forward_cache(stmt) || force_use || stmt->capped_result)
   {
     return mysql_use_result(stmt->dbc->mysql);
   }
@@ -108,6 +114,8 @@ MYSQL_RES * get_result_metadata(STMT *stmt, BOOL force_use)
 {
   /* just a precaution, mysql_free_result checks for NULL anywat */
   mysql_free_result(stmt->result);
+  /* Not to be counted by memory_limit_reading() */
+  stmt->result= NULL;
 
   if (ssps_used(stmt))
   {
@@ -136,6 +144,7 @@ int get_result(STMT *stmt)
 {
   if (ssps_used(stmt))
   {
+    PERF_SCOPE perf_scope(stmt->dbc, PERF_TIME_GET_RESULT);
     return ssps_get_result(stmt);
   }
   /* Nothing to do here for text protocol */
@@ -159,6 +168,184 @@ size_t STMT::field_count()
 }
 
 
+/*
+  Bytes of the rows libmysql has stored for the current result. The rows
+  are walked once, the count is kept while the same rows are stored.
+*/
+static size_t stored_rows_size(STMT *stmt)
+{
+  MYSQL_ROWS *rows= NULL;
+  my_ulonglong row_count= 0;
+  bool binary= ssps_used(stmt);
+
+  if (binary)
+  {
+    rows= stmt->ssps->result.data;
+    row_count= stmt->ssps->result.rows;
+  }
+  else if (stmt->result && !stmt->fake_result && stmt->result->data)
+  {
+    rows= stmt->result->data->data;
+    row_count= stmt->result->data->rows;
+  }
+
+  if (rows == NULL)
+    return 0;
+
+  if (rows == stmt->counted_rows && row_count == stmt->counted_row_count)
+    return stmt->rows_bytes;
+
+  size_t fields= binary ? 0 : stmt->result->field_count;
+  size_t bytes= 0;
+
+  for (MYSQL_ROWS *row= rows; row; row= row->next)
+  {
+    bytes+= sizeof(MYSQL_ROWS);
+    if (binary)
+    {
+      bytes+= row->length;
+    }
+    else
+    {
+      /* Values follow the pointers, the last pointer marks their end */
+      bytes+= (fields + 1) * sizeof(char*) +
+              (row->data[fields] - (char*)(row->data + fields + 1));
+    }
+  }
+
+  stmt->counted_rows= rows;
+  stmt->counted_row_count= row_count;
+  stmt->rows_bytes= bytes;
+  return bytes;
+}
+
+
+/*
+  Bytes of client memory the statement holds: the stored rows, result
+  and parameter bind buffers, LOB values, data-at-exec parameters, the
+  copies of the query text and the work buffers. The caller holds the
+  statement lock.
+*/
+size_t STMT::memory_used()
+{
+  size_t bytes= stored_rows_size(this) + tempbuf.buf_len +
+                query.buf.buf_len + orig_query.buf.buf_len +
+                scroller.buf.buf_len;
+
+  if (result_bind)
+  {
+    size_t columns= result_meta.empty() ? field_count() : result_meta.size();
+    for (size_t i= 0; i < columns; ++i)
+    {
+      /* A LOB read into lobs[i].data is counted with it */
+      if (i >= lobs.size() || !lobs[i].bind_buffer)
+        bytes+= sizeof(MYSQL_BIND) + result_bind[i].buffer_length;
+    }
+  }
+
+  for (const SSPS_LOB &lob : lobs)
+    bytes+= lob.data.capacity() + (lob.bind_buffer ? lob.bind_length : 0);
+
+  for (const xstring &val : m_row_storage.m_data)
+    bytes+= sizeof(xstring) + val.capacity();
+
+  for (const MYSQL_BIND &bind : param_bind)
+    bytes+= sizeof(MYSQL_BIND) + (bind.buffer ? bind.buffer_length : 0);
+
+  for (DESCREC &rec : apd->records2)
+    bytes+= rec.par.tempbuf.buf_len;
+
+  /* Rows of store_result_capped(), a result cache entry is the cache's */
+  if (cached_result && cached_result.use_count() == 1)
+    bytes+= cached_result->size();
+
+  dbc->mem_total+= bytes - mem_held.exchange(bytes);
+  return bytes;
+}
+
+
+/*
+  Decides how the result about to be read stays under the memory limits.
+  Once the statements of the connection hold MEMORY_SOFT_LIMIT bytes, a
+  forward-only cursor reads it from the server as it is fetched, as with
+  NO_CACHE (stmt->stream_result). The connection can't run anything else
+  until it is read then, which is what setting the option accepts.
+  Otherwise, under MEMORY_HARD_LIMIT, the rows are read one by one and
+  counted (stmt->capped_result), see memory_check_result().
+*/
+void memory_limit_reading(STMT *stmt)
+{
+  DBC *dbc= stmt->dbc;
+
+  stmt->stream_result= false;
+  stmt->capped_result= false;
+
+  if (dbc->ds.opt_MEMORY_SOFT_LIMIT <= 0 && dbc->ds.opt_MEMORY_HARD_LIMIT <= 0)
+    return;
+
+  /* What the previous result of the statement held is gone */
+  stmt->memory_used();
+
+  if (stmt->stmt_options.cursor_type == SQL_CURSOR_FORWARD_ONLY &&
+      !dbc->ds.opt_NO_CACHE && dbc->ds.opt_MEMORY_SOFT_LIMIT > 0)
+  {
+    stmt->stream_result= dbc->memory_used() >=
+                         (size_t)dbc->ds.opt_MEMORY_SOFT_LIMIT;
+  }
+
+  stmt->capped_result= dbc->ds.opt_MEMORY_HARD_LIMIT > 0 &&
+                       !if_forward_cache(stmt) && !ssps_used(stmt);
+}
+
+
+/*
+  Whether the statements of the connection would hold more than
+  MEMORY_HARD_LIMIT bytes with more bytes allocated.
+*/
+bool memory_hard_limit_exceeded(STMT *stmt, size_t more)
+{
+  if (stmt->dbc->ds.opt_MEMORY_HARD_LIMIT <= 0)
+    return false;
+
+  stmt->memory_used();
+  return stmt->dbc->memory_used() + more >
+         (size_t)stmt->dbc->ds.opt_MEMORY_HARD_LIMIT;
+}
+
+
+/*
+  Accounts the result that has just been read. A capped result is read
+  into the driver here. A result stored by libmysql taking the connection
+  over MEMORY_HARD_LIMIT, which only a prepared statement's can do, is
+  freed. Returns true with the error set then.
+*/
+bool memory_check_result(STMT *stmt)
+{
+  DBC *dbc= stmt->dbc;
+
+  if (dbc->ds.opt_MEMORY_SOFT_LIMIT <= 0 && dbc->ds.opt_MEMORY_HARD_LIMIT <= 0)
+    return false;
+
+  if (stmt->capped_result)
+  {
+    stmt->capped_result= false;
+    if (stmt->result && !stmt->fake_result)
+      return store_result_capped(stmt);
+  }
+
+  stmt->memory_used();
+  if (dbc->ds.opt_MEMORY_HARD_LIMIT <= 0 || stored_rows_size(stmt) == 0 ||
+      dbc->memory_used() <= (size_t)dbc->ds.opt_MEMORY_HARD_LIMIT)
+    return false;
+
+  free_current_result(stmt);
+  stmt->memory_used();
+  stmt->set_error(MYERR_S1001, "The result needs more memory than "
+                  "MEMORY_HARD_LIMIT allows", 4001);
+  return true;
+}
+
+
 my_ulonglong affected_rows(STMT *stmt)
 {
   if (ssps_used(stmt))
@@ -200,7 +387,7 @@ my_ulonglong num_rows(STMT *stmt)
 }
 
 
-MYSQL_ROW STMT::fetch_row(bool read_unbuffered)
+MYSQL_ROW STMT::fetch_row(bool read_unbuffered, bool lazy_lobs)
 {
   if (ssps)
   {
@@ -210,15 +397,19 @@ MYSQL_ROW STMT::fetch_row(bool read_unbuffered)
     }
     int err = 0;
 
+    ssps_reset_lobs(this);
+
     if (read_unbuffered || m_row_storage.eof())
     {
       /* Reading results from network */
       err = mysql_stmt_fetch(ssps);
+      defer_lobs = lazy_lobs && !read_unbuffered;
     }
     else
     {
       /* Row is already buffered in row storage, use the row storage */
       m_row_storage.fill_data(result_bind);
+      defer_lobs = false;
     }
 
     switch (err)
@@ -319,7 +510,7 @@ int get_int(STMT *stmt, ulong column_number, char *value, ulong length)
   }
   else
   {
-    return (int)strtol(value, NULL, 10);
+    return (int)myodbc_parse_int64(value, length, nullptr);
   }
 }
 
@@ -332,33 +523,37 @@ unsigned int get_uint(STMT* stmt, ulong column_number, char* value, ulong length
   }
   else
   {
-    return (unsigned int)strtoul(value, NULL, 10);
+    return (unsigned int)myodbc_parse_uint64(value, length, nullptr);
   }
 }
 
 
-long long get_int64(STMT *stmt, ulong column_number, char *value, ulong length)
+long long get_int64(STMT *stmt, ulong column_number, char *value, ulong length,
+                    int *status)
 {
   if (ssps_used(stmt))
   {
-     return ssps_get_int64<long long>(stmt, column_number, value, length);
+     return ssps_get_int64<long long>(stmt, column_number, value, length,
+                                      status);
   }
   else
   {
-    return strtoll(value, NULL, 10);
+    return myodbc_parse_int64(value, length, status);
   }
 }
 
 
-unsigned long long get_uint64(STMT* stmt, ulong column_number, char* value, ulong length)
+unsigned long long get_uint64(STMT* stmt, ulong column_number, char* value, ulong length,
+                              int *status)
 {
   if (ssps_used(stmt))
   {
-    return ssps_get_int64<unsigned long long>(stmt, column_number, value, length);
+    return ssps_get_int64<unsigned long long>(stmt, column_number, value,
+                                              length, status);
   }
   else
   {
-    return strtoull(value, NULL, 10);
+    return myodbc_parse_uint64(value, length, status);
   }
 }
 
@@ -378,15 +573,29 @@ char * get_string(STMT *stmt, ulong column_number, char *value, ulong *length,
 
 
 double get_double(STMT *stmt, ulong column_number, char *value,
-                  ulong length)
+                  ulong length, int *status)
 {
   if (ssps_used(stmt))
   {
-    return ssps_get_double(stmt, column_number, value, length);
+    return ssps_get_double(stmt, column_number, value, length, status);
   }
   else
   {
-    return myodbc_strtod(value, length);
+    return myodbc_parse_double(value, length, status);
+  }
+}
+
+
+void get_sqlnum(STMT *stmt, ulong column_number, char *value, ulong length,
+                SQL_NUMERIC_STRUCT *sqlnum, int *overflow_ptr)
+{
+  if (ssps_used(stmt))
+  {
+    ssps_get_sqlnum(stmt, column_number, value, length, sqlnum, overflow_ptr);
+  }
+  else
+  {
+    sqlnum_from_str(value, length, sqlnum, overflow_ptr);
   }
 }
 
@@ -427,12 +636,31 @@ SQLRETURN prepare(STMT *stmt, char * query, SQLINTEGER query_length,
   }
 
   ssps_close(stmt);
+
+  /* The result described for the previous text is gone with it */
+  if (stmt->meta_described)
+  {
+    stmt_result_free(stmt);
+    stmt->ird->reset();
+    stmt->meta_described= false;
+  }
+  if (stmt->meta_ssps &&
+      stmt->meta_query.compare(0, std::string::npos, stmt->query.query,
+                               stmt->query.length()))
+  {
+    meta_ssps_close(stmt);
+  }
+
   stmt->param_count = (uint)PARAM_COUNT(stmt->query);
   /* Trusting our parsing we are not using prepared statments unsless there are
-     actually parameter markers in it */
+     actually parameter markers in it. Rows that are stored can only be read
+     one by one under MEMORY_HARD_LIMIT with the text protocol. */
   if (!stmt->dbc->ds.opt_NO_SSPS && (PARAM_COUNT(stmt->query) || force_prepare)
     && !IS_BATCH(&stmt->query) &&
-      stmt->query.preparable_on_server(stmt->dbc->mysql->server_version))
+      stmt->query.preparable_on_server(stmt->dbc->mysql->server_version) &&
+      !(stmt->dbc->ds.opt_MEMORY_HARD_LIMIT > 0 &&
+        !(stmt->dbc->ds.opt_NO_CACHE &&
+          stmt->stmt_options.cursor_type == SQL_CURSOR_FORWARD_ONLY)))
   {
     MYLOG_QUERY(stmt, "Using prepared statement");
     ssps_init(stmt);
@@ -450,13 +678,16 @@ SQLRETURN prepare(STMT *stmt, char * query, SQLINTEGER query_length,
      // the result string for prepare is inside stmt->query.
      int prep_res = mysql_stmt_prepare(stmt->ssps, stmt->query.query,
                                        (unsigned long)stmt->query.length());
+     perf_count(stmt->dbc, PERF_PREPARES);
+     perf_count(stmt->dbc, PERF_ROUND_TRIPS);
+     perf_count(stmt->dbc, PERF_BYTES_OUT, stmt->query.length());
 
      if (prep_res)
       {
         MYLOG_QUERY(stmt, mysql_error(stmt->dbc->mysql));
 
         stmt->set_error("HY000");
-        translate_error((char*)stmt->error.sqlstate.c_str(), MYERR_S1000,
+        translate_error(stmt->error.sqlstate, MYERR_S1000,
                         mysql_errno(stmt->dbc->mysql));
 
         return SQL_ERROR;
@@ -499,36 +730,148 @@ SQLRETURN prepare(STMT *stmt, char * query, SQLINTEGER query_length,
   return SQL_SUCCESS;
 }
 
-SQLRETURN send_long_data (STMT *stmt, unsigned int param_num, DESCREC * aprec, const char *chunk,
-                          unsigned long length)
+/*
+  Describes the result of a statement that will run through the text
+  protocol by preparing it on the server, which sends the result metadata
+  without executing anything. The prepared handle stays with the statement
+  for its text, describing it again doesn't go to the server. Returns false
+  if the server can't prepare the statement or it has no result.
+*/
+bool describe_prepared(STMT *stmt)
 {
-#ifdef WE_CAN_SEND_LONG_DATA_PROPERLY
-  if (ssps_used(stmt))
+  MYSQL_RES *result;
+
+  if (IS_BATCH(&stmt->query) || stmt->query.get_cursor_name() ||
+      !stmt->query.preparable_on_server(stmt->dbc->mysql->server_version))
   {
-    /* If we haven't already started to do that on client and parameter is binary */
-    if (aprec->par.value == NULL && aprec->concise_type == SQL_C_BINARY)
-    {
-      SQLRETURN result= ssps_send_long_data(stmt, param_num, chunk, length);
+    return false;
+  }
 
-      /* A bit ugly */
-      if (result == SQL_SUCCESS_WITH_INFO)
-      {
-        return append2param_value(stmt, aprec, chunk, length);
-      }
+  LOCK_DBC(stmt->dbc);
+
+  if (!stmt->meta_ssps)
+  {
+    MYSQL_STMT *meta= mysql_stmt_init(stmt->dbc->mysql);
 
-      return result;
+    if (!meta)
+    {
+      return false;
     }
-    else
+
+    MYLOG_QUERY(stmt, "Preparing to describe the result");
+    perf_count(stmt->dbc, PERF_PREPARES);
+    perf_count(stmt->dbc, PERF_ROUND_TRIPS);
+    perf_count(stmt->dbc, PERF_BYTES_OUT, stmt->query.length());
+    if (mysql_stmt_prepare(meta, stmt->query.query,
+                           (unsigned long)stmt->query.length()))
     {
-      return append2param_value(stmt, aprec, chunk, length);
+      MYLOG_QUERY(stmt, mysql_stmt_error(meta));
+      mysql_stmt_close(meta);
+      return false;
     }
+
+    stmt->meta_ssps= meta;
+    stmt->meta_query.assign(stmt->query.query, stmt->query.length());
   }
-  else
-#endif
+
+  /* The fields stay in meta_ssps, freeing the result leaves them alone */
+  if (!(result= mysql_stmt_result_metadata(stmt->meta_ssps)))
+  {
+    return false;
+  }
+
+  stmt_result_free(stmt);
+  stmt->result= result;
+  stmt->fake_result= false;
+  fix_result_types(stmt);
+
+  /* fix_result_types() takes it for executed */
+  stmt->state= ST_PREPARED;
+  stmt->meta_described= true;
+
+  return true;
+}
+
+
+void meta_ssps_close(STMT *stmt)
+{
+  if (stmt->meta_described)
+  {
+    stmt_result_free(stmt);
+    stmt->ird->reset();
+    stmt->meta_described= false;
+  }
+
+  if (stmt->meta_ssps != NULL)
   {
+    mysql_stmt_close(stmt->meta_ssps);
+    stmt->meta_ssps= NULL;
+  }
+  stmt->meta_query.clear();
+}
+
+
+SQLRETURN send_long_data (STMT *stmt, unsigned int param_num, DESCREC * aprec, const char *chunk,
+                          unsigned long length)
+{
+  if (!aprec->par.streamed)
+  {
+    if (memory_hard_limit_exceeded(stmt, length))
+    {
+      return stmt->set_error(MYERR_S1001, "The parameter data needs more "
+                             "memory than MEMORY_HARD_LIMIT allows", 4001);
+    }
     aprec->par.add_param_data(chunk, length);
     return SQL_SUCCESS;
   }
+
+  aprec->par.stream_started= true;
+
+  if (aprec->concise_type != SQL_C_WCHAR)
+  {
+    return ssps_send_long_data(stmt, param_num, chunk, length);
+  }
+
+  /*
+    Wide characters are sent as UTF-8, like insert_param() does for the whole
+    value. A chunk can end inside a code unit or between the halves of a
+    surrogate pair, that tail waits for the next chunk. Whatever is still
+    pending at execution is dropped, as an incomplete character would be.
+  */
+  std::string units(aprec->par.pending, aprec->par.pending_len);
+  units.append(chunk, length);
+
+  SQLINTEGER count= (SQLINTEGER)(units.length() / sizeof(SQLWCHAR));
+  const SQLWCHAR *wstr= (const SQLWCHAR *)units.data();
+
+  if (sizeof(SQLWCHAR) == 2 && count > 0 &&
+      wstr[count - 1] >= 0xd800 && wstr[count - 1] <= 0xdbff)
+  {
+    --count;
+  }
+
+  aprec->par.pending_len= (unsigned int)(units.length() -
+                                         count * sizeof(SQLWCHAR));
+  memcpy(aprec->par.pending, units.data() + count * sizeof(SQLWCHAR),
+         aprec->par.pending_len);
+
+  if (count == 0)
+  {
+    return SQL_SUCCESS;
+  }
+
+  SQLCHAR *utf8= sqlwchar_as_utf8_ext(wstr, &count, NULL, 0, NULL);
+
+  if (utf8 == NULL)
+  {
+    return stmt->set_error(MYERR_S1001, NULL, 4001);
+  }
+
+  SQLRETURN rc= ssps_send_long_data(stmt, param_num, (const char *)utf8,
+                                    (unsigned long)count);
+  x_free(utf8);
+
+  return rc;
 }
 
 
@@ -44,7 +44,7 @@
 */
 
 #define if_forward_cache(st) ((st)->stmt_options.cursor_type == SQL_CURSOR_FORWARD_ONLY && \
-           (st)->dbc->ds.opt_NO_CACHE)
+           ((st)->dbc->ds.opt_NO_CACHE || (st)->stream_result))
 #define is_connected(dbc)    ((dbc)->mysql && (dbc)->mysql->net.vio)
 #define trans_supported(db) ((db)->mysql->server_capabilities & CLIENT_TRANSACTIONS)
 #define autocommit_on(db) ((db)->mysql->server_status & SERVER_STATUS_AUTOCOMMIT)
@@ -266,6 +266,10 @@ void  myodbc_sqlstate2_init     (void);
 void  myodbc_sqlstate3_init     (void);
 int   check_if_server_is_alive  (DBC *dbc);
 MYSQL *new_mysql                (void);
+void   offer_tls_session        (MYSQL *mysql, DataSource *ds,
+                                 const char *host, unsigned int port);
+bool   save_tls_session         (MYSQL *mysql, DataSource *ds,
+                                 const char *host, unsigned int port);
 bool   myodbc_append_quoted_name_std(std::string &str, const char *name);
 
 SQLRETURN set_handle_error          (SQLSMALLINT HandleType, SQLHANDLE handle,
@@ -281,6 +285,8 @@ SQLRETURN SQL_API my_SQLFreeConnect   (SQLHDBC hdbc);
 SQLRETURN SQL_API my_SQLFreeEnv       (SQLHENV henv);
 
 void myodbc_end();
+void clear_session_pool();
+void join_background_threads();
 my_bool set_dynamic_result        (STMT *stmt);
 bool    set_current_cursor_data   (STMT *stmt,SQLUINTEGER irow);
 my_bool is_minimum_version        (const char *server_version,const char *version);
@@ -309,6 +315,10 @@ SQLRETURN stmt_SQLCopyDesc(STMT *stmt, DESC *src, DESC *dest);
 
 void sqlnum_from_str      (const char *numstr, SQL_NUMERIC_STRUCT *sqlnum,
                           int *overflow_ptr);
+void sqlnum_from_str      (const char *numstr, size_t len,
+                          SQL_NUMERIC_STRUCT *sqlnum, int *overflow_ptr);
+void sqlnum_from_int      (unsigned long long magnitude, bool negative,
+                          SQL_NUMERIC_STRUCT *sqlnum, int *overflow_ptr);
 void sqlnum_to_str        (SQL_NUMERIC_STRUCT *sqlnum, SQLCHAR *numstr,
                           SQLCHAR **numbegin, SQLCHAR reqprec, SQLSCHAR reqscale,
                           int *truncptr);
@@ -392,6 +402,11 @@ MYSQL_ROW_OFFSET  row_tell            (STMT *stmt);
 int               next_result         (STMT *stmt);
 SQLRETURN         send_long_data      (STMT *stmt, unsigned int param_num, DESCREC * aprec,
                                       const char *chunk, unsigned long length);
+bool              describe_prepared   (STMT *stmt);
+void              meta_ssps_close     (STMT *stmt);
+void              memory_limit_reading(STMT *stmt);
+bool              memory_hard_limit_exceeded(STMT *stmt, size_t more);
+bool              memory_check_result (STMT *stmt);
 
 #define IGNORE_THROW(A) try{ A; }catch(...){}
 
@@ -399,14 +414,21 @@ int           get_int     (STMT *stmt, ulong column_number, char *value,
                           ulong length);
 unsigned int  get_uint    (STMT *stmt, ulong column_number, char *value,
                           ulong length);
+/*
+  The optional status receives one of MYODBC_NUM_* codes telling whether
+  the value was truncated or did not fit into the result type.
+*/
 long long     get_int64   (STMT *stmt, ulong column_number, char *value,
-                          ulong length);
+                          ulong length, int *status = nullptr);
 unsigned long long get_uint64(STMT * stmt, ulong column_number, char* value,
-                          ulong length);
+                          ulong length, int *status = nullptr);
 char *        get_string  (STMT *stmt, ulong column_number, char *value,
                           ulong *length, char * buffer);
 double        get_double  (STMT *stmt, ulong column_number, char *value,
-                          ulong length);
+                          ulong length, int *status = nullptr);
+void          get_sqlnum  (STMT *stmt, ulong column_number, char *value,
+                          ulong length, SQL_NUMERIC_STRUCT *sqlnum,
+                          int *overflow_ptr);
 BOOL          is_null     (STMT *stmt, ulong column_number, char *value);
 SQLRETURN     prepare     (STMT *stmt, char * query, SQLINTEGER query_length,
                            bool reset_sql_limit, bool force_prepare);
@@ -426,6 +448,7 @@ void stmt_result_free(STMT * stmt)
     mysql_free_result(stmt->result);
 
   stmt->result = NULL;
+  stmt->stream_result = false;
 }
 
 
@@ -441,22 +464,93 @@ SQLRETURN     scroller_prefetch   (STMT * stmt);
 bool          scrollable          (STMT * stmt, const char * query,
                                   const char * query_end);
 
+/* result_cache.cc */
+bool  result_cache_lookup           (STMT *stmt, const std::string &query,
+                                     RESULT_CACHE_LOOKUP &lookup);
+void  result_cache_store            (STMT *stmt,
+                                     const RESULT_CACHE_LOOKUP &lookup);
+void  result_cache_invalidate       (DBC *dbc, const char *query,
+                                     size_t length);
+void  result_cache_end_transaction  (DBC *dbc);
+size_t single_statement_length      (const char *query, size_t length);
+bool  store_result_capped           (STMT *stmt);
+
+/* perf_counters.cc */
+void        perf_add              (DBC *dbc, perf_counter counter,
+                                   unsigned long long n);
+void        perf_add_conversion   (DBC *dbc, enum enum_field_types type,
+                                   SQLSMALLINT c_type, unsigned long long n);
+void        perf_add_time         (DBC *dbc, perf_timer timer,
+                                   std::chrono::steady_clock::duration time);
+const char *perf_connection_report(DBC *dbc);
+std::string perf_process_report   ();
+void        perf_dump             (DBC *dbc);
+
+/* Counting costs a test of dbc->perf without PERF_COUNTERS */
+inline void perf_count(DBC *dbc, perf_counter counter,
+                       unsigned long long n= 1)
+{
+  if (dbc->perf)
+    perf_add(dbc, counter, n);
+}
+
+inline void perf_count_conversion(DBC *dbc, enum enum_field_types type,
+                                  SQLSMALLINT c_type, unsigned long long n= 1)
+{
+  if (dbc->perf)
+    perf_add_conversion(dbc, type, c_type, n);
+}
+
+/* Adds the time until the end of the scope to a timer of the connection */
+struct PERF_SCOPE
+{
+  DBC *dbc;
+  perf_timer timer;
+  std::chrono::steady_clock::time_point start;
+
+  PERF_SCOPE(DBC *d, perf_timer t) : dbc(d->perf ? d : nullptr), timer(t)
+  {
+    if (dbc)
+      start= std::chrono::steady_clock::now();
+  }
+
+  ~PERF_SCOPE()
+  {
+    if (dbc)
+      perf_add_time(dbc, timer, std::chrono::steady_clock::now() - start);
+  }
+};
+
 /* my_prepared_stmt.c */
 void        ssps_init             (STMT *stmt);
 BOOL        ssps_get_out_params   (STMT *stmt);
 int         ssps_get_result       (STMT *stmt);
 void        ssps_close            (STMT *stmt);
+void        ssps_save_result_meta (STMT *stmt);
+bool        ssps_keep_result      (STMT *stmt);
+bool        ssps_same_result_meta (STMT *stmt);
+void        ssps_free_result_meta (STMT *stmt);
 SQLRETURN   ssps_fetch_chunk      (STMT *stmt, char *dest, unsigned long dest_bytes,
                                   unsigned long *avail_bytes);
 void        free_result_bind      (STMT *stmt);
+void        ssps_reset_lobs       (STMT *stmt);
+SQLRETURN   ssps_fetch_lob        (STMT *stmt, uint column);
+SQLRETURN   ssps_fetch_lobs       (STMT *stmt);
+SQLRETURN   ssps_get_lob_chunk    (STMT *stmt, uint column, SQLCHAR *result,
+                                  SQLLEN result_bytes, SQLLEN *avail_bytes,
+                                  bool terminate);
 BOOL        ssps_buffers_need_extending(STMT *stmt);
 
 template <typename T>
-T ssps_get_int64 (STMT *stmt, ulong column_number, char *value, ulong length);
+T ssps_get_int64 (STMT *stmt, ulong column_number, char *value, ulong length,
+                 int *status = nullptr);
 double ssps_get_double            (STMT *stmt, ulong column_number, char *value,
-                                  ulong length);
+                                  ulong length, int *status = nullptr);
 char *      ssps_get_string       (STMT *stmt, ulong column_number, char *value,
                                   ulong *length, char * buffer);
+void        ssps_get_sqlnum       (STMT *stmt, ulong column_number, char *value,
+                                  ulong length, SQL_NUMERIC_STRUCT *sqlnum,
+                                  int *overflow_ptr);
 SQLRETURN   ssps_send_long_data   (STMT *stmt, unsigned int param_num, const char *chunk,
                                   unsigned long length);
 MYSQL_BIND * get_param_bind       (STMT *stmt, unsigned int param_number, int reset);
@@ -145,6 +145,10 @@ static SQLRETURN set_constmt_attr(SQLSMALLINT  HandleType,
             }
             break;
 
+        case MYSQL_ATTR_RESULT_CACHE_TTL:
+            options->result_cache_ttl= (SQLLEN) ValuePtr;
+            break;
+
         case SQL_ATTR_KEYSET_SIZE:
         case SQL_ATTR_CONCURRENCY:
         case SQL_ATTR_NOSCAN:
@@ -212,6 +216,10 @@ get_constmt_attr(SQLSMALLINT  HandleType,
             *((SQLULEN *) ValuePtr)= (options->retrieve_data ? SQL_RD_ON : SQL_RD_OFF);
             break;
 
+        case MYSQL_ATTR_RESULT_CACHE_TTL:
+            *((SQLLEN *) ValuePtr)= options->result_cache_ttl;
+            break;
+
         case SQL_ATTR_SIMULATE_CURSOR:
             *((SQLUINTEGER *) ValuePtr)= SQL_SC_TRY_UNIQUE;
             break;
@@ -498,13 +506,28 @@ MySQLGetConnectAttr(SQLHDBC hdbc, SQLINTEGER attrib, SQLCHAR **char_attr,
   case SQL_ATTR_CONNECTION_DEAD:
     /* If waking up fails - we return "connection is dead", no matter what really the reason is */
     if (dbc->need_to_wakeup != 0 && wakeup_connection(dbc)
-      || dbc->need_to_wakeup == 0 && mysql_ping(dbc->mysql) &&
-        is_connection_lost(mysql_errno(dbc->mysql)))
+      || dbc->need_to_wakeup == 0 && dbc->connection_is_dead())
       *((SQLUINTEGER *)num_attr)= SQL_CD_TRUE;
     else
       *((SQLUINTEGER *)num_attr)= SQL_CD_FALSE;
     break;
 
+  case MYSQL_ATTR_TLS_SESSION_REUSED:
+    *((SQLUINTEGER *)num_attr)= dbc->tls_session_reused ? SQL_TRUE : SQL_FALSE;
+    break;
+
+  case MYSQL_ATTR_RESULT_CACHE_TTL:
+    *((SQLLEN *)num_attr)= dbc->stmt_options.result_cache_ttl;
+    break;
+
+  case MYSQL_ATTR_MEMORY_USED:
+    *((SQLULEN *)num_attr)= (SQLULEN)dbc->account_memory();
+    break;
+
+  case MYSQL_ATTR_PERF_COUNTERS:
+    *char_attr= (SQLCHAR *)perf_connection_report(dbc);
+    break;
+
   case SQL_ATTR_CONNECTION_TIMEOUT:
     /* We don't support this option, so it is always 0. */
     *((SQLUINTEGER *)num_attr)= 0;
@@ -898,6 +921,10 @@ MySQLGetStmtAttr(SQLHSTMT hstmt, SQLINTEGER Attribute, SQLPOINTER ValuePtr,
             *StringLengthPtr= sizeof(SQLPOINTER);
             break;
 
+        case MYSQL_ATTR_MEMORY_USED:
+            *(SQLULEN *)ValuePtr= (SQLULEN)stmt->memory_used();
+            break;
+
             /*
               3.x driver doesn't support any statement attributes
               at connection level, but to make sure all 2.x apps
@@ -967,8 +994,8 @@ SQLRETURN SQL_API
 SQLGetEnvAttr(SQLHENV    henv,
               SQLINTEGER Attribute,
               SQLPOINTER ValuePtr,
-              SQLINTEGER BufferLength __attribute__((unused)),
-              SQLINTEGER *StringLengthPtr __attribute__((unused)))
+              SQLINTEGER BufferLength,
+              SQLINTEGER *StringLengthPtr)
 {
     CHECK_HANDLE(henv);
     /* NULL is acceptable for ValuePtr, so we are not checking for it here */
@@ -987,6 +1014,23 @@ SQLGetEnvAttr(SQLHENV    henv,
             IF_NOT_NULL(ValuePtr, *((SQLINTEGER*)ValuePtr)= SQL_TRUE);
             break;
 
+        case MYSQL_ATTR_PERF_COUNTERS:
+        {
+            std::string report= perf_process_report();
+            IF_NOT_NULL(StringLengthPtr,
+                        *StringLengthPtr= (SQLINTEGER)report.length());
+            if (ValuePtr && BufferLength > 0)
+            {
+                size_t copy= myodbc_min(report.length(),
+                                        (size_t)BufferLength - 1);
+                memcpy(ValuePtr, report.data(), copy);
+                ((char *)ValuePtr)[copy]= '\0';
+                if (copy < report.length())
+                    return set_env_error((ENV*)henv, MYERR_01004, NULL, 0);
+            }
+            break;
+        }
+
         default:
             return set_env_error((ENV*)henv,MYERR_S1C00,NULL,0);
     }
@@ -130,15 +130,13 @@ static const QUERY_TYPE_RESOLVING rule[]=
   {NULL, 0, 0, myqtOther, NULL, NULL}
 };
 
-MY_PARSED_QUERY::MY_PARSED_QUERY() : buf(1024) {
+MY_PARSED_QUERY::MY_PARSED_QUERY() : buf(0) {
     query =      NULL;
     query_end =  NULL;
     last_char =  NULL;
     is_batch =   NULL;
 
     query_type= myqtOther;
-    token2.reserve(20);
-    param_pos.reserve(20);
 }
 
 
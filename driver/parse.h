@@ -138,6 +138,7 @@ struct tempBuf {
   char *add_to_buffer(char *to, const char *from, size_t len);
   void remove_trail_zeroes();
   void reset();
+  void shrink(size_t max_len);
 
   operator bool();
 
@@ -0,0 +1,328 @@
+// Copyright (c) 2024, Oracle and/or its affiliates.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0, as
+// published by the Free Software Foundation.
+//
+// This program is designed to work with certain software (including
+// but not limited to OpenSSL) that is licensed under separate terms, as
+// designated in a particular file or component or in included license
+// documentation. The authors of MySQL hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have either included with
+// the program or referenced in the documentation.
+//
+// Without limiting anything contained in the foregoing, this file,
+// which is part of Connector/ODBC, is also subject to the
+// Universal FOSS Exception, version 1.0, a copy of which can be found at
+// https://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+/**
+  @file  perf_counters.cc
+  @brief Counters and time histograms of the work done by the driver.
+
+  A connection with PERF_COUNTERS=1 keeps a PERF_COUNTERS of its own,
+  read with SQLGetConnectAttr(MYSQL_ATTR_PERF_COUNTERS). Everything it
+  counts also goes to one of PERF_SHARDS process-wide shards picked by the
+  thread, SQLGetEnvAttr() returns their sum. Threads rarely share a shard,
+  so counting does not make them wait for each other's cache lines.
+
+  With PERF_DUMP_INTERVAL set as well, do_query() writes the counters of
+  the connection to the query log (LOG_QUERY) at most that often.
+*/
+
+#include "driver.h"
+
+#include <array>
+
+
+namespace
+{
+
+typedef PERF_COUNTERS::counter counter;
+
+const char *counter_names[PERF_COUNTERS_NUM]= {
+  "round_trips", "prepares", "executes", "stmt_cache_hits",
+  "result_cache_hits", "bytes_out", "bytes_in", "rows_fetched",
+  "conversions"
+};
+
+const char *timer_names[PERF_TIMERS_NUM]= {
+  "do_query", "get_result", "fetch", "conversion"
+};
+
+/*
+  MySQL types by their row in PERF_COUNTERS::conversions, see
+  mysql_type_index().
+*/
+const char *mysql_type_names[PERF_MYSQL_TYPES]= {
+  "DECIMAL", "TINY", "SHORT", "LONG", "FLOAT", "DOUBLE", "NULL",
+  "TIMESTAMP", "LONGLONG", "INT24", "DATE", "TIME", "DATETIME", "YEAR",
+  "NEWDATE", "VARCHAR", "BIT", "TIMESTAMP2", "DATETIME2", "TIME2",
+  "TYPED_ARRAY", "VECTOR", "INVALID", "BOOL", "JSON", "NEWDECIMAL", "ENUM",
+  "SET", "TINY_BLOB", "MEDIUM_BLOB", "LONG_BLOB", "BLOB", "VAR_STRING",
+  "STRING", "GEOMETRY", "OTHER"
+};
+
+/* C types by their column in PERF_COUNTERS::conversions, other ones last */
+const struct
+{
+  SQLSMALLINT type;
+  const char *name;
+} c_types[PERF_C_TYPES - 1]= {
+  {SQL_C_CHAR, "SQL_C_CHAR"}, {SQL_C_WCHAR, "SQL_C_WCHAR"},
+  {SQL_C_BINARY, "SQL_C_BINARY"}, {SQL_C_BIT, "SQL_C_BIT"},
+  {SQL_C_TINYINT, "SQL_C_TINYINT"}, {SQL_C_STINYINT, "SQL_C_STINYINT"},
+  {SQL_C_UTINYINT, "SQL_C_UTINYINT"}, {SQL_C_SHORT, "SQL_C_SHORT"},
+  {SQL_C_SSHORT, "SQL_C_SSHORT"}, {SQL_C_USHORT, "SQL_C_USHORT"},
+  {SQL_C_LONG, "SQL_C_LONG"}, {SQL_C_SLONG, "SQL_C_SLONG"},
+  {SQL_C_ULONG, "SQL_C_ULONG"}, {SQL_C_SBIGINT, "SQL_C_SBIGINT"},
+  {SQL_C_UBIGINT, "SQL_C_UBIGINT"}, {SQL_C_FLOAT, "SQL_C_FLOAT"},
+  {SQL_C_DOUBLE, "SQL_C_DOUBLE"}, {SQL_C_NUMERIC, "SQL_C_NUMERIC"},
+  {SQL_C_DATE, "SQL_C_DATE"}, {SQL_C_TIME, "SQL_C_TIME"},
+  {SQL_C_TIMESTAMP, "SQL_C_TIMESTAMP"},
+  {SQL_C_TYPE_DATE, "SQL_C_TYPE_DATE"},
+  {SQL_C_TYPE_TIME, "SQL_C_TYPE_TIME"},
+  {SQL_C_TYPE_TIMESTAMP, "SQL_C_TYPE_TIMESTAMP"},
+  {SQL_C_GUID, "SQL_C_GUID"},
+  {SQL_C_INTERVAL_YEAR, "SQL_C_INTERVAL_YEAR"},
+  {SQL_C_INTERVAL_MONTH, "SQL_C_INTERVAL_MONTH"},
+  {SQL_C_INTERVAL_DAY, "SQL_C_INTERVAL_DAY"},
+  {SQL_C_INTERVAL_HOUR, "SQL_C_INTERVAL_HOUR"},
+  {SQL_C_INTERVAL_MINUTE, "SQL_C_INTERVAL_MINUTE"},
+  {SQL_C_INTERVAL_SECOND, "SQL_C_INTERVAL_SECOND"},
+  {SQL_C_INTERVAL_YEAR_TO_MONTH, "SQL_C_INTERVAL_YEAR_TO_MONTH"},
+  {SQL_C_INTERVAL_DAY_TO_HOUR, "SQL_C_INTERVAL_DAY_TO_HOUR"},
+  {SQL_C_INTERVAL_DAY_TO_MINUTE, "SQL_C_INTERVAL_DAY_TO_MINUTE"},
+  {SQL_C_INTERVAL_DAY_TO_SECOND, "SQL_C_INTERVAL_DAY_TO_SECOND"},
+  {SQL_C_INTERVAL_HOUR_TO_MINUTE, "SQL_C_INTERVAL_HOUR_TO_MINUTE"},
+  {SQL_C_INTERVAL_HOUR_TO_SECOND, "SQL_C_INTERVAL_HOUR_TO_SECOND"},
+  {SQL_C_INTERVAL_MINUTE_TO_SECOND, "SQL_C_INTERVAL_MINUTE_TO_SECOND"}
+};
+
+
+unsigned int mysql_type_index(enum enum_field_types type)
+{
+  unsigned int num= (unsigned int)type;
+
+  if (num <= 20)
+    return num;
+  if (num >= 242 && num <= 255)
+    return 21 + num - 242;
+  return PERF_MYSQL_TYPES - 1;
+}
+
+
+unsigned int c_type_index(SQLSMALLINT type)
+{
+  /* C type codes are between -128 and 127 */
+  static const std::array<unsigned char, 256> index= []()
+  {
+    std::array<unsigned char, 256> index;
+    index.fill(PERF_C_TYPES - 1);
+    for (unsigned int i= 0; i < PERF_C_TYPES - 1; ++i)
+      index[c_types[i].type + 128]= (unsigned char)i;
+    return index;
+  }();
+
+  return type >= -128 && type < 128 ? index[type + 128] : PERF_C_TYPES - 1;
+}
+
+
+inline void add(counter &value, unsigned long long n)
+{
+  value.fetch_add(n, std::memory_order_relaxed);
+}
+
+
+inline unsigned long long get(const counter &value)
+{
+  return value.load(std::memory_order_relaxed);
+}
+
+
+/* Separate cache lines for the shards */
+struct alignas(64) perf_shard
+{
+  PERF_COUNTERS counters;
+};
+
+perf_shard shards[PERF_SHARDS];
+std::atomic<unsigned int> next_shard{0};
+thread_local PERF_COUNTERS *thread_shard= nullptr;
+
+PERF_COUNTERS &process_counters()
+{
+  if (!thread_shard)
+    thread_shard= &shards[next_shard++ % PERF_SHARDS].counters;
+  return *thread_shard;
+}
+
+
+void add_counters(PERF_COUNTERS &to, const PERF_COUNTERS &from)
+{
+  for (int i= 0; i < PERF_COUNTERS_NUM; ++i)
+    add(to.counts[i], get(from.counts[i]));
+
+  for (int i= 0; i < PERF_TIMERS_NUM; ++i)
+  {
+    add(to.timers[i].calls, get(from.timers[i].calls));
+    add(to.timers[i].nanos, get(from.timers[i].nanos));
+    for (int j= 0; j < PERF_BUCKETS; ++j)
+      add(to.timers[i].buckets[j], get(from.timers[i].buckets[j]));
+  }
+
+  for (int i= 0; i < PERF_MYSQL_TYPES; ++i)
+    for (int j= 0; j < PERF_C_TYPES; ++j)
+      add(to.conversions[i][j], get(from.conversions[i][j]));
+}
+
+
+/*
+  The counters as "name=value;" pairs. A histogram is the calls taking
+  under 1, 2, 4... microseconds, up to its last used bucket, the last
+  bucket of all takes the slower ones.
+*/
+std::string report(const PERF_COUNTERS &perf)
+{
+  std::string text;
+
+  auto put= [&text](const std::string &name, unsigned long long value)
+  {
+    text.append(name).append("=").append(std::to_string(value)).append(";");
+  };
+
+  for (int i= 0; i < PERF_COUNTERS_NUM; ++i)
+    put(counter_names[i], get(perf.counts[i]));
+
+  for (int i= 0; i < PERF_TIMERS_NUM; ++i)
+  {
+    const PERF_COUNTERS::timer &timer= perf.timers[i];
+    std::string hist;
+    int used= PERF_BUCKETS;
+
+    put(std::string(timer_names[i]) + "_calls", get(timer.calls));
+    put(std::string(timer_names[i]) + "_us", get(timer.nanos) / 1000);
+
+    while (used > 0 && !get(timer.buckets[used - 1]))
+      --used;
+    for (int j= 0; j < used; ++j)
+    {
+      if (j)
+        hist.append(",");
+      hist.append(std::to_string(get(timer.buckets[j])));
+    }
+    text.append(timer_names[i]).append("_hist=").append(hist).append(";");
+  }
+
+  for (int i= 0; i < PERF_MYSQL_TYPES; ++i)
+  {
+    for (int j= 0; j < PERF_C_TYPES; ++j)
+    {
+      unsigned long long n= get(perf.conversions[i][j]);
+      if (n)
+        put(std::string("conv_") + mysql_type_names[i] + "_" +
+            (j < PERF_C_TYPES - 1 ? c_types[j].name : "OTHER"), n);
+    }
+  }
+
+  return text;
+}
+
+} // namespace
+
+
+void perf_add(DBC *dbc, perf_counter counter, unsigned long long n)
+{
+  if (!dbc->perf)
+    return;
+
+  add(dbc->perf->counts[counter], n);
+  add(process_counters().counts[counter], n);
+}
+
+
+void perf_add_conversion(DBC *dbc, enum enum_field_types type,
+                         SQLSMALLINT c_type, unsigned long long n)
+{
+  if (!dbc->perf)
+    return;
+
+  unsigned int row= mysql_type_index(type);
+  unsigned int col= c_type_index(c_type);
+  PERF_COUNTERS &process= process_counters();
+
+  add(dbc->perf->counts[PERF_CONVERSIONS], n);
+  add(dbc->perf->conversions[row][col], n);
+  add(process.counts[PERF_CONVERSIONS], n);
+  add(process.conversions[row][col], n);
+}
+
+
+void perf_add_time(DBC *dbc, perf_timer timer,
+                   std::chrono::steady_clock::duration time)
+{
+  if (!dbc->perf)
+    return;
+
+  unsigned long long nanos= (unsigned long long)
+    std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+  unsigned long long micros= nanos / 1000;
+  int bucket= 0;
+
+  while (bucket < PERF_BUCKETS - 1 && micros >= (1ULL << bucket))
+    ++bucket;
+
+  for (PERF_COUNTERS *perf : {dbc->perf.get(), &process_counters()})
+  {
+    add(perf->timers[timer].calls, 1);
+    add(perf->timers[timer].nanos, nanos);
+    add(perf->timers[timer].buckets[bucket], 1);
+  }
+}
+
+
+/* MYSQL_ATTR_PERF_COUNTERS of the connection, empty without PERF_COUNTERS */
+const char *perf_connection_report(DBC *dbc)
+{
+  dbc->perf_text= dbc->perf ? report(*dbc->perf) : std::string();
+  return dbc->perf_text.c_str();
+}
+
+
+/* MYSQL_ATTR_PERF_COUNTERS of the process */
+std::string perf_process_report()
+{
+  std::unique_ptr<PERF_COUNTERS> total(new PERF_COUNTERS());
+
+  for (perf_shard &shard : shards)
+    add_counters(*total, shard.counters);
+
+  return report(*total);
+}
+
+
+/* Writes the counters to the query log if PERF_DUMP_INTERVAL has passed */
+void perf_dump(DBC *dbc)
+{
+  if (!dbc->perf || dbc->ds.opt_PERF_DUMP_INTERVAL <= 0 || !dbc->query_log)
+    return;
+
+  time_t now= time(NULL);
+  if (now - dbc->perf_dumped < (time_t)(int)dbc->ds.opt_PERF_DUMP_INTERVAL)
+    return;
+
+  dbc->perf_dumped= now;
+  fprintf(dbc->query_log, "-- %lld:perf:%s\n", (long long)now,
+          report(*dbc->perf).c_str());
+  fflush(dbc->query_log);
+}
@@ -0,0 +1,852 @@
+// Copyright (c) 2024, Oracle and/or its affiliates.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License, version 2.0, as
+// published by the Free Software Foundation.
+//
+// This program is designed to work with certain software (including
+// but not limited to OpenSSL) that is licensed under separate terms, as
+// designated in a particular file or component or in included license
+// documentation. The authors of MySQL hereby grant you an additional
+// permission to link the program and your derivative works with the
+// separately licensed software that they have either included with
+// the program or referenced in the documentation.
+//
+// Without limiting anything contained in the foregoing, this file,
+// which is part of Connector/ODBC, is also subject to the
+// Universal FOSS Exception, version 1.0, a copy of which can be found at
+// https://oss.oracle.com/licenses/universal-foss-exception.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+// See the GNU General Public License, version 2.0, for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA
+
+/**
+  @file  result_cache.cc
+  @brief Client-side cache of the results of read-only queries.
+
+  With RESULT_CACHE_TTL (or MYSQL_ATTR_RESULT_CACHE_TTL) set, do_query()
+  answers a SELECT it has seen within that many seconds from the process
+  memory instead of the server. Results are kept by server, user, schema,
+  character set, row limit, the SET statements run on the session and the
+  query text with the parameter values put in, and handed to the
+  statement as a fake result.
+
+  The cache is only a shortcut for statements that would read the same
+  rows again: queries calling stored or loadable functions or built-ins
+  with a different value on every call, reading variables or locking rows
+  are not cached, neither is anything inside a transaction. Statements changing data through the
+  driver drop the results of the tables they name, changes made by other
+  clients are only seen once the results expire.
+*/
+
+#include "driver.h"
+#include "catalog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <set>
+
+
+namespace
+{
+
+typedef std::chrono::steady_clock clock_type;
+
+/*
+  Functions and clauses that make a query return something else on every
+  execution, or that must reach the server. Table and column names that
+  happen to match only make a query bypass the cache.
+*/
+const std::set<std::string> volatile_words = {
+  "@", "benchmark", "connection_id", "curdate", "current_date",
+  "current_role", "current_time", "current_timestamp", "current_user",
+  "curtime", "database", "found_rows", "get_lock", "information_schema",
+  "into", "is_free_lock", "is_used_lock", "last_insert_id", "localtime",
+  "localtimestamp", "lock", "mysql", "now", "performance_schema", "rand",
+  "random_bytes", "release_lock", "row_count", "schema", "session_user",
+  "share", "sleep", "sql_no_cache", "sys", "sysdate", "system_user",
+  "unix_timestamp", "update", "user", "utc_date", "utc_time",
+  "utc_timestamp", "uuid", "uuid_short"
+};
+
+/*
+  Built-in functions returning the same for the same arguments and session
+  settings. Any other name called in a query, a stored or loadable function,
+  makes it bypass the cache whatever the function is declared as.
+*/
+const std::set<std::string> builtin_functions = {
+  "abs", "acos", "ascii", "asin", "atan", "atan2", "avg", "bin", "bit_and",
+  "bit_count", "bit_length", "bit_or", "bit_xor", "cast", "ceil", "ceiling",
+  "char", "char_length", "character_length", "coalesce", "concat",
+  "concat_ws", "conv", "convert", "cos", "cot", "count", "crc32", "date",
+  "date_add", "date_format", "date_sub", "datediff", "day", "dayname",
+  "dayofmonth", "dayofweek", "dayofyear", "degrees", "elt", "exp",
+  "export_set", "extract", "field", "find_in_set", "floor", "format",
+  "from_base64", "from_days", "from_unixtime", "greatest", "group_concat",
+  "hex", "hour", "if", "ifnull", "inet_aton", "inet_ntoa", "insert",
+  "instr", "interval", "isnull", "json_array", "json_contains",
+  "json_extract", "json_keys", "json_length", "json_object", "json_quote",
+  "json_unquote", "last_day", "lcase", "least", "left", "length", "ln",
+  "locate", "log", "log10", "log2", "lower", "lpad", "ltrim", "make_set",
+  "makedate", "maketime", "max", "md5", "mid", "min", "minute", "mod",
+  "month", "monthname", "nullif", "oct", "octet_length", "ord",
+  "period_add", "period_diff", "pi", "position", "pow", "power", "quarter",
+  "quote", "radians", "regexp_instr", "regexp_like", "regexp_replace",
+  "regexp_substr", "repeat", "replace", "reverse", "right", "round", "rpad",
+  "rtrim", "sec_to_time", "second", "sha", "sha1", "sha2", "sign", "sin",
+  "soundex", "space", "sqrt", "std", "stddev", "stddev_pop", "stddev_samp",
+  "str_to_date", "strcmp", "subdate", "substr", "substring",
+  "substring_index", "sum", "tan", "time", "time_format", "time_to_sec",
+  "timediff", "timestamp", "timestampadd", "timestampdiff", "to_base64",
+  "to_days", "to_seconds", "trim", "truncate", "ucase", "unhex", "upper",
+  "var_pop", "var_samp", "variance", "week", "weekday", "weekofyear", "year",
+  "yearweek"
+};
+
+/* Keywords and type names a parenthesis can follow without a call */
+const std::set<std::string> paren_words = {
+  "all", "and", "any", "as", "between", "binary", "by", "case", "decimal",
+  "distinct", "div", "double", "else", "except", "exists", "float", "from",
+  "having", "in", "index", "intersect", "is", "join", "key", "like", "not",
+  "numeric", "on", "or", "over", "partition", "regexp", "rlike", "row",
+  "select", "signed", "some", "then", "union", "unsigned", "using",
+  "values", "when", "where", "window", "xor"
+};
+
+/* Statements that neither change data nor end a transaction */
+const std::set<std::string> read_words = {
+  "begin", "desc", "describe", "explain", "help", "release", "savepoint",
+  "select", "show", "start", "use"
+};
+
+/* Words after which a statement names the tables it reads or changes */
+const std::set<std::string> table_words = {
+  "from", "into", "join", "table", "tables", "truncate", "update"
+};
+
+/* Statements a WITH clause can start besides SELECT */
+const std::set<std::string> change_words = {
+  "delete", "insert", "replace", "update"
+};
+
+
+bool is_word_char(unsigned char c)
+{
+  return c == '_' || c == '$' || c >= 0x80 || isalnum(c);
+}
+
+bool is_word(const std::string &token)
+{
+  return !token.empty() && is_word_char((unsigned char)token[0]);
+}
+
+
+/*
+  Splits the query into lower-case words and punctuation, skipping string
+  literals and comments, and copies it to normalized with its white space
+  collapsed. Returns false if there is more than one statement. The end of
+  the last word or punctuation is put into stmt_end.
+*/
+bool scan_query(const char *query, size_t length, std::string *normalized,
+                std::vector<std::string> &tokens,
+                const char **stmt_end= nullptr)
+{
+  const char *pos= query, *end= query + length;
+  const char *last= query;
+  bool space= false, ended= false, more= false;
+
+  auto put= [&](const char *from, const char *to)
+  {
+    more= ended;
+    last= to;
+    if (!normalized)
+      return;
+    if (space && !normalized->empty())
+      normalized->push_back(' ');
+    normalized->append(from, to);
+    space= false;
+  };
+
+  while (pos < end && !more)
+  {
+    const char *start= pos;
+    unsigned char c= (unsigned char)*pos;
+
+    if (isspace(c))
+    {
+      space= true;
+      ++pos;
+    }
+    else if (c == '\'' || c == '"' || c == '`')
+    {
+      for (++pos; pos < end; ++pos)
+      {
+        if (*pos == '\\' && c != '`')
+          ++pos;
+        else if (*pos == (char)c && pos + 1 < end && pos[1] == (char)c)
+          ++pos;
+        else if (*pos == (char)c)
+          break;
+      }
+      pos= std::min(pos + 1, end);
+      put(start, pos);
+
+      if (c == '`')
+      {
+        const char *name_end= pos > start + 1 && pos[-1] == '`' ? pos - 1 : pos;
+        std::string name(start + 1, name_end);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        tokens.push_back(name.empty() ? "_" : name);
+      }
+    }
+    else if (c == '#' || (c == '-' && pos + 2 < end && pos[1] == '-' &&
+                          isspace((unsigned char)pos[2])))
+    {
+      while (pos < end && *pos != '\n')
+        ++pos;
+      space= true;
+    }
+    else if (c == '/' && pos + 1 < end && pos[1] == '*')
+    {
+      /* Kept in the text, executable comments and hints change the query */
+      const char *close= std::search(pos + 2, end, "*/", "*/" + 2);
+      pos= close == end ? end : close + 2;
+      put(start, pos);
+    }
+    else if (c == ';')
+    {
+      /* Only white space, comments and more ';' may follow */
+      ended= true;
+      ++pos;
+    }
+    else if (is_word_char(c))
+    {
+      while (pos < end && is_word_char((unsigned char)*pos))
+        ++pos;
+      put(start, pos);
+
+      std::string word(start, pos);
+      std::transform(word.begin(), word.end(), word.begin(), ::tolower);
+      tokens.push_back(word);
+    }
+    else
+    {
+      ++pos;
+      put(start, pos);
+      tokens.push_back(std::string(1, (char)c));
+    }
+  }
+
+  if (more)
+    return false;
+  if (stmt_end)
+    *stmt_end= last;
+  return true;
+}
+
+
+/*
+  Names of the tables following FROM, JOIN, INTO, UPDATE and the like,
+  without the schema. A query reading a table in a subquery names it the
+  same way, so this finds the tables of subqueries too.
+*/
+std::vector<std::string> table_names(const std::vector<std::string> &tokens)
+{
+  std::set<std::string> names;
+  size_t count= tokens.size();
+
+  for (size_t i= 0; i < count; ++i)
+  {
+    if (!table_words.count(tokens[i]))
+      continue;
+
+    size_t j= i + 1;
+    while (j < count && (tokens[j] == "table" || tokens[j] == "if" ||
+                         tokens[j] == "not" || tokens[j] == "exists" ||
+                         tokens[j] == "ignore" || tokens[j] == "low_priority"))
+      ++j;
+
+    while (j < count && is_word(tokens[j]) && !table_words.count(tokens[j]))
+    {
+      std::string name= tokens[j++];
+      if (j + 1 < count && tokens[j] == "." && is_word(tokens[j + 1]))
+      {
+        name= tokens[j + 1];
+        j+= 2;
+      }
+      names.insert(name);
+
+      /* An alias, then possibly the next table of a list */
+      if (j < count && tokens[j] == "as")
+        j+= 2;
+      else if (j + 1 < count && is_word(tokens[j]) && tokens[j + 1] == ",")
+        ++j;
+
+      if (j >= count || tokens[j] != ",")
+        break;
+      ++j;
+    }
+  }
+
+  return std::vector<std::string>(names.begin(), names.end());
+}
+
+
+/*
+  Whether the statement may be or contain a SET, USE or CALL. Only the
+  first word is looked at, anything hidden behind a comment or a ';' is
+  taken for one.
+*/
+bool may_change_session(const char *query, size_t length)
+{
+  const char *pos= query, *end= query + length;
+
+  while (pos < end && isspace((unsigned char)*pos))
+    ++pos;
+
+  const char *word= pos;
+  while (pos < end && is_word_char((unsigned char)*pos))
+    ++pos;
+
+  return (pos - word == 3 && (!myodbc_casecmp(word, "set", 3) ||
+                              !myodbc_casecmp(word, "use", 3))) ||
+         (pos - word == 4 && !myodbc_casecmp(word, "call", 4)) ||
+         pos == word || std::find(pos, end, ';') != end;
+}
+
+
+/*
+  Adds a SET statement to the session state in the key. Running one again
+  moves it to the end, which is what the session ends up with.
+*/
+void add_session_set(DBC *dbc, const std::string &set)
+{
+  std::vector<std::string> &sets= dbc->result_cache_session;
+
+  sets.erase(std::remove(sets.begin(), sets.end(), set), sets.end());
+  sets.push_back(set);
+
+  if (sets.size() > RESULT_CACHE_MAX_SETS)
+    dbc->result_cache_unsafe= true;
+}
+
+
+/*
+  Whether the query calls anything but a built-in from builtin_functions,
+  a qualified name is always a stored function.
+*/
+bool calls_stored_function(const std::vector<std::string> &tokens)
+{
+  for (size_t i= 0; i + 1 < tokens.size(); ++i)
+  {
+    const std::string &name= tokens[i];
+    if (tokens[i + 1] != "(" || !is_word(name))
+      continue;
+
+    if ((i > 0 && tokens[i - 1] == ".") ||
+        (!builtin_functions.count(name) && !paren_words.count(name)))
+      return true;
+  }
+
+  return false;
+}
+
+
+bool in_transaction(DBC *dbc)
+{
+  return !dbc->autocommit_is_on() ||
+         (dbc->mysql->server_status & SERVER_STATUS_IN_TRANS);
+}
+
+
+/* Bytes the strings of the fields take in CACHED_RESULT::data */
+size_t fields_size(const MYSQL_FIELD *fields, unsigned int field_count)
+{
+  size_t bytes= 0;
+
+  for (unsigned int i= 0; i < field_count; ++i)
+  {
+    const MYSQL_FIELD &f= fields[i];
+    bytes+= f.name_length + f.org_name_length + f.table_length +
+            f.org_table_length + f.db_length + f.catalog_length +
+            f.def_length + 7;
+  }
+
+  return bytes;
+}
+
+
+/* Appends a copy of str to data, which must have room for it */
+char *copy_string(std::string &data, const char *str, size_t length)
+{
+  if (!str)
+    return nullptr;
+  size_t pos= data.size();
+  data.append(str, length).push_back('\0');
+  return &data[pos];
+}
+
+
+/* Copies the fields, their strings go into cached.data */
+void copy_fields(CACHED_RESULT &cached, const MYSQL_FIELD *fields,
+                 unsigned int field_count)
+{
+  std::string &data= cached.data;
+
+  for (unsigned int i= 0; i < field_count; ++i)
+  {
+    MYSQL_FIELD field= fields[i];
+    field.name= copy_string(data, field.name, field.name_length);
+    field.org_name= copy_string(data, field.org_name, field.org_name_length);
+    field.table= copy_string(data, field.table, field.table_length);
+    field.org_table= copy_string(data, field.org_table,
+                                 field.org_table_length);
+    field.db= copy_string(data, field.db, field.db_length);
+    field.catalog= copy_string(data, field.catalog, field.catalog_length);
+    field.def= copy_string(data, field.def, field.def_length);
+    field.extension= nullptr;
+    cached.fields.push_back(field);
+  }
+}
+
+
+/* Copies the rows and the fields of a stored result */
+std::shared_ptr<CACHED_RESULT> copy_result(MYSQL_RES *result, size_t limit)
+{
+  unsigned int field_count= mysql_num_fields(result);
+  my_ulonglong row_count= mysql_num_rows(result);
+  MYSQL_FIELD *fields= mysql_fetch_fields(result);
+  MYSQL_ROW row;
+  size_t bytes= fields_size(fields, field_count);
+
+  mysql_data_seek(result, 0);
+  while (bytes <= limit && (row= mysql_fetch_row(result)))
+  {
+    unsigned long *lengths= mysql_fetch_lengths(result);
+    for (unsigned int i= 0; i < field_count; ++i)
+    {
+      if (row[i])
+        bytes+= lengths[i] + 1;
+    }
+  }
+  mysql_data_seek(result, 0);
+
+  if (bytes > limit)
+    return nullptr;
+
+  auto cached= std::make_shared<CACHED_RESULT>();
+  std::string &data= cached->data;
+
+  /* data never grows past what is reserved, so its strings do not move */
+  data.reserve(bytes);
+  copy_fields(*cached, fields, field_count);
+
+  /* A fake result needs a row array even when there are no rows */
+  cached->row_count= row_count;
+  cached->rows.assign(std::max<my_ulonglong>(row_count, 1) * field_count,
+                      nullptr);
+  cached->lengths.assign(row_count * field_count, 0);
+
+  for (size_t r= 0; (row= mysql_fetch_row(result)); ++r)
+  {
+    unsigned long *lengths= mysql_fetch_lengths(result);
+    for (unsigned int i= 0; i < field_count; ++i)
+    {
+      cached->rows[r * field_count + i]= copy_string(data, row[i],
+                                                     lengths[i]);
+      cached->lengths[r * field_count + i]= lengths[i];
+    }
+  }
+  mysql_data_seek(result, 0);
+
+  return cached;
+}
+
+
+/* Hands the rows to the statement as a fake result */
+bool use_cached_result(STMT *stmt, std::shared_ptr<CACHED_RESULT> cached)
+{
+  if (create_fake_resultset(stmt, nullptr, 0, cached->row_count,
+                            cached->fields.data(),
+                            (uint)cached->fields.size(),
+                            false) != SQL_SUCCESS)
+    return false;
+
+  stmt->cached_result= cached;
+  stmt->result_array= (MYSQL_ROW)cached->rows.data();
+  if (!cached->lengths.empty())
+  {
+    stmt->alloc_lengths(cached->lengths.size());
+    std::copy(cached->lengths.begin(), cached->lengths.end(),
+              stmt->lengths.get());
+  }
+  return true;
+}
+
+
+/*
+  The results by key, dropped when they expire and, least recently used
+  first, when they do not fit into RESULT_CACHE_SIZE any more.
+*/
+class result_cache
+{
+  struct entry
+  {
+    std::shared_ptr<CACHED_RESULT> result;
+    std::vector<std::string> tables;
+    clock_type::time_point expires;
+    std::list<std::string>::iterator lru_pos;
+    size_t size;
+  };
+
+  std::mutex mtx;
+  std::unordered_map<std::string, entry> entries;
+  std::list<std::string> lru;   // Most recently used first
+  size_t used = 0;
+
+  /* Changes with every statement that may change data */
+  std::atomic<unsigned long long> changes{0};
+  std::atomic<bool> enabled{false};
+
+  void erase(std::unordered_map<std::string, entry>::iterator it)
+  {
+    used-= it->second.size;
+    lru.erase(it->second.lru_pos);
+    entries.erase(it);
+  }
+
+  public:
+
+  /* Whether any connection of the process has turned the cache on */
+  bool in_use() { return enabled; }
+
+  void enable() { enabled= true; }
+
+  unsigned long long generation() { return changes; }
+
+  std::shared_ptr<CACHED_RESULT> get(const std::string &key)
+  {
+    std::lock_guard<std::mutex> guard(mtx);
+    auto it= entries.find(key);
+    if (it == entries.end())
+      return nullptr;
+
+    if (it->second.expires <= clock_type::now())
+    {
+      erase(it);
+      return nullptr;
+    }
+
+    lru.splice(lru.begin(), lru, it->second.lru_pos);
+    return it->second.result;
+  }
+
+  void put(const RESULT_CACHE_LOOKUP &lookup,
+           std::shared_ptr<CACHED_RESULT> result, size_t capacity)
+  {
+    size_t size= result->size() + 2 * lookup.key.size();
+    std::lock_guard<std::mutex> guard(mtx);
+
+    /* Data may have changed while the query ran */
+    if (changes != lookup.generation || size > capacity)
+      return;
+
+    auto it= entries.find(lookup.key);
+    if (it != entries.end())
+      erase(it);
+
+    while (used + size > capacity && !lru.empty())
+      erase(entries.find(lru.back()));
+
+    lru.push_front(lookup.key);
+    entry &e= entries[lookup.key];
+    e.result= result;
+    e.tables= lookup.tables;
+    e.expires= clock_type::now() + std::chrono::seconds(lookup.ttl);
+    e.lru_pos= lru.begin();
+    e.size= size;
+    used+= size;
+  }
+
+  /* Drops the results reading any of the tables, all if none is given */
+  void invalidate(const std::vector<std::string> &tables)
+  {
+    std::lock_guard<std::mutex> guard(mtx);
+    ++changes;
+
+    for (auto it= entries.begin(); it != entries.end();)
+    {
+      auto next= std::next(it);
+      const std::vector<std::string> &read= it->second.tables;
+
+      if (tables.empty() || read.empty() ||
+          std::find_first_of(read.begin(), read.end(), tables.begin(),
+                             tables.end()) != read.end())
+        erase(it);
+      it= next;
+    }
+  }
+};
+
+result_cache results;
+
+}
+
+
+/*
+  Serves the query from the result cache if it is there, leaving the key to
+  store its result under in lookup otherwise.
+
+  @return true if the statement has got the cached result.
+*/
+bool result_cache_lookup(STMT *stmt, const std::string &query,
+                         RESULT_CACHE_LOOKUP &lookup)
+{
+  DBC *dbc= stmt->dbc;
+  SQLLEN ttl= stmt->stmt_options.result_cache_ttl >= 0 ?
+              stmt->stmt_options.result_cache_ttl :
+              (SQLLEN)dbc->ds.opt_RESULT_CACHE_TTL;
+
+  lookup.key.clear();
+  if (ttl <= 0)
+    return false;
+
+  results.enable();
+  if (ssps_used(stmt) || dbc->ds.opt_PREFETCH > 0 ||
+      if_forward_cache(stmt) || in_transaction(dbc) ||
+      dbc->result_cache_unsafe)
+    return false;
+
+  std::string normalized;
+  std::vector<std::string> tokens;
+  if (!scan_query(query.c_str(), query.length(), &normalized, tokens) ||
+      tokens.empty() || tokens[0] != "select")
+    return false;
+
+  for (const std::string &token : tokens)
+  {
+    if (volatile_words.count(token))
+      return false;
+  }
+  if (calls_stored_function(tokens))
+    return false;
+
+  MYSQL *mysql= dbc->mysql;
+  /* dbc->database doesn't follow a USE, mysql->db does if it is tracked */
+  const char *schema= dbc->schema_tracked ?
+                      (mysql->db ? mysql->db : "") : dbc->database.c_str();
+  lookup.key.append(mysql->host ? mysql->host : "").append(":")
+            .append(std::to_string(mysql->port)).append("|")
+            .append(mysql->user ? mysql->user : "").append("|")
+            .append(schema).append("|")
+            .append(dbc->cxn_charset_info->name).append("|")
+            .append(std::to_string(stmt->stmt_options.max_rows)).append("|");
+  /* time_zone, sql_mode and the like change what a query returns */
+  for (const std::string &set : dbc->result_cache_session)
+    lookup.key.append(set).append("|");
+  lookup.key.append(normalized);
+  lookup.tables= table_names(tokens);
+  lookup.ttl= (unsigned long)ttl;
+  lookup.generation= results.generation();
+
+  std::shared_ptr<CACHED_RESULT> cached= results.get(lookup.key);
+  if (!cached)
+    return false;
+
+  if (!use_cached_result(stmt, cached))
+    return false;
+
+  MYLOG_QUERY(stmt, "Result served from the result cache");
+  return true;
+}
+
+
+/* Keeps the result do_query() has just stored, if lookup has a key for it */
+void result_cache_store(STMT *stmt, const RESULT_CACHE_LOOKUP &lookup)
+{
+  DBC *dbc= stmt->dbc;
+
+  if (lookup.key.empty() || !stmt->result || stmt->fake_result ||
+      ssps_used(stmt) || if_forward_cache(stmt) || scroller_exists(stmt) ||
+      mysql_more_results(dbc->mysql))
+    return;
+
+  size_t capacity= dbc->ds.opt_RESULT_CACHE_SIZE > 0 ?
+                   (size_t)dbc->ds.opt_RESULT_CACHE_SIZE :
+                   DEFAULT_RESULT_CACHE_SIZE;
+
+  std::shared_ptr<CACHED_RESULT> cached= copy_result(stmt->result, capacity);
+  if (cached)
+    results.put(lookup, cached, capacity);
+}
+
+
+/*
+  Reads the rows of a result taken with mysql_use_result() one by one into
+  a fake result, the way the cache keeps them. A scrollable cursor under
+  MEMORY_HARD_LIMIT is read like this instead of with mysql_store_result(),
+  which can't be stopped: as soon as the rows would take the connection
+  over the limit, the rest of the result is discarded and HY001 is set.
+
+  @return true on error, with stmt->result freed.
+*/
+bool store_result_capped(STMT *stmt)
+{
+  DBC *dbc= stmt->dbc;
+  MYSQL_RES *result= stmt->result;
+  unsigned int field_count= mysql_num_fields(result);
+  MYSQL_FIELD *fields= mysql_fetch_fields(result);
+  size_t held= dbc->memory_used();
+  size_t limit= (size_t)dbc->ds.opt_MEMORY_HARD_LIMIT;
+  auto cached= std::make_shared<CACHED_RESULT>();
+  std::string &data= cached->data;
+  /* Where the values start in data, 0 for NULL. data still moves. */
+  std::vector<size_t> values;
+  MYSQL_ROW row;
+
+  while ((row= mysql_fetch_row(result)))
+  {
+    unsigned long *lengths= mysql_fetch_lengths(result);
+    for (unsigned int i= 0; i < field_count; ++i)
+    {
+      values.push_back(row[i] ? data.size() + 1 : 0);
+      if (row[i])
+        data.append(row[i], lengths[i]).push_back('\0');
+      cached->lengths.push_back(lengths[i]);
+    }
+    ++cached->row_count;
+
+    if (held + data.capacity() + values.capacity() *
+        (sizeof(size_t) + sizeof(char*) + sizeof(unsigned long)) > limit)
+    {
+      free_current_result(stmt);
+      stmt->set_error(MYERR_S1001, "The result needs more memory than "
+                      "MEMORY_HARD_LIMIT allows", 4001);
+      return true;
+    }
+  }
+
+  if (mysql_errno(dbc->mysql))
+  {
+    stmt->set_error(MYERR_S1000, mysql_error(dbc->mysql),
+                    mysql_errno(dbc->mysql));
+    free_current_result(stmt);
+    return true;
+  }
+
+  data.reserve(data.size() + fields_size(fields, field_count));
+  copy_fields(*cached, fields, field_count);
+
+  /* A fake result needs a row array even when there are no rows */
+  cached->rows.assign(std::max<size_t>(values.size(), field_count), nullptr);
+  for (size_t i= 0; i < values.size(); ++i)
+  {
+    if (values[i])
+      cached->rows[i]= &data[values[i] - 1];
+  }
+
+  free_current_result(stmt);
+  if (!use_cached_result(stmt, cached))
+    return true;
+
+  stmt->memory_used();
+  return false;
+}
+
+
+/*
+  Length of the query without the ';', white space and line comments after
+  its end, or 0 if it has more than one statement.
+*/
+size_t single_statement_length(const char *query, size_t length)
+{
+  std::vector<std::string> tokens;
+  const char *stmt_end;
+
+  if (!scan_query(query, length, nullptr, tokens, &stmt_end))
+    return 0;
+  return stmt_end - query;
+}
+
+
+/*
+  Drops the cached results a statement sent through the driver may have
+  changed. Changes made inside a transaction drop everything once more
+  when it ends, see result_cache_end_transaction().
+
+  SET statements are tracked even before the cache is turned on, they are
+  the session state of the key. After a CALL, a text with more than one
+  statement or a USE the client library does not track, the session state
+  is not known any more.
+*/
+void result_cache_invalidate(DBC *dbc, const char *query, size_t length)
+{
+  if (!query || (!results.in_use() && !may_change_session(query, length)))
+    return;
+
+  std::string normalized;
+  std::vector<std::string> tokens;
+  if (!scan_query(query, length, &normalized, tokens))
+  {
+    dbc->result_cache_unsafe= true;
+    results.invalidate({});
+    if (in_transaction(dbc))
+      dbc->result_cache_dirty= true;
+    return;
+  }
+  if (tokens.empty())
+    return;
+
+  const std::string &first= tokens[0];
+  if (first == "set")
+    add_session_set(dbc, normalized);
+  else if (first == "call" || (first == "use" && !dbc->schema_tracked))
+    dbc->result_cache_unsafe= true;
+
+  if (!results.in_use())
+    return;
+
+  if (first == "commit" || first == "rollback" ||
+      (first == "set" &&
+       std::find(tokens.begin(), tokens.end(), "autocommit") != tokens.end()))
+  {
+    result_cache_end_transaction(dbc);
+    return;
+  }
+
+  if (read_words.count(first) || first == "set")
+    return;
+
+  if (first == "with" &&
+      std::none_of(tokens.begin(), tokens.end(),
+                   [](const std::string &token)
+                   { return change_words.count(token) > 0; }))
+    return;
+
+  /* CALL and anything naming no table drop all results */
+  results.invalidate(first == "call" ? std::vector<std::string>() :
+                                       table_names(tokens));
+
+  if (in_transaction(dbc))
+    dbc->result_cache_dirty= true;
+}
+
+
+/*
+  Other connections may have cached rows the transaction was changing
+  before it was committed.
+*/
+void result_cache_end_transaction(DBC *dbc)
+{
+  if (dbc->result_cache_dirty)
+  {
+    results.invalidate({});
+    dbc->result_cache_dirty= false;
+  }
+}
@@ -34,6 +34,7 @@
 #include "driver.h"
 #include <errmsg.h>
 #include <ctype.h>
+#include <float.h>
 #include <locale.h>
 
 #define SQL_MY_PRIMARY_KEY 1212
@@ -358,6 +359,25 @@ char *fix_padding(STMT *stmt, SQLSMALLINT fCType, char *value, std::string &out_
 }
 
 
+/*
+  Report the outcome of a numeric conversion done by sql_get_data():
+  22003 if the value did not fit into the target C type and 01S07 if a
+  non-zero fractional part was dropped.
+*/
+static SQLRETURN numeric_conv_result(STMT *stmt, int status, SQLRETURN result)
+{
+  switch (status)
+  {
+  case MYODBC_NUM_OVERFLOW:
+    return stmt->set_error("22003", "Numeric value out of range", 0);
+  case MYODBC_NUM_TRUNC_FRAC:
+    stmt->set_error(MYERR_01S07, NULL, 0);
+    return SQL_SUCCESS_WITH_INFO;
+  }
+  return result;
+}
+
+
 /**
   Retrieve the data from a field as a specified ODBC C type.
 
@@ -384,6 +404,7 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
   long long numeric_value = 0;
   unsigned long long u_numeric_value = 0;
   my_bool   convert= 1;
+  int       conv_status= MYODBC_NUM_OK;
   SQLRETURN result= SQL_SUCCESS;
   char      as_string[50]; /* Buffer that might be required to convert other
                               types data to its string representation */
@@ -408,6 +429,9 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
     fCType= arrec->concise_type;
   }
 
+  PERF_SCOPE perf_scope(stmt->dbc, PERF_TIME_CONVERSION);
+  perf_count_conversion(stmt->dbc, field->type, fCType);
+
   /* set prec and scale for numeric */
   if (fCType == SQL_C_NUMERIC && rgbValue)
   {
@@ -623,8 +647,13 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
                                         (SQLINTEGER) atol(value + 8));
           }
           else
-            *((SQLINTEGER *)rgbValue)= (SQLINTEGER) get_int64(stmt,
-                                                  column_number, value, length);
+          {
+            long long num= get_int64(stmt, column_number, value, length,
+                                     &conv_status);
+            if (num < INT_MIN32 || num > INT_MAX32)
+              conv_status= MYODBC_NUM_OVERFLOW;
+            *((SQLINTEGER *)rgbValue)= (SQLINTEGER)num;
+          }
         }
         else
           *((SQLINTEGER *)rgbValue)= (SQLINTEGER)(numeric_value
@@ -635,23 +664,43 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
 
     case SQL_C_ULONG:
       if (rgbValue)
-        *((SQLUINTEGER *)rgbValue)= (SQLUINTEGER)(convert ?
-                                get_uint64(stmt, column_number, value, length) :
-                                numeric_value & (SQLUINTEGER)(-1));
+      {
+        if (convert)
+        {
+          unsigned long long num= get_uint64(stmt, column_number, value,
+                                             length, &conv_status);
+          if (num > UINT_MAX32)
+            conv_status= MYODBC_NUM_OVERFLOW;
+          *((SQLUINTEGER *)rgbValue)= (SQLUINTEGER)num;
+        }
+        else
+          *((SQLUINTEGER *)rgbValue)= (SQLUINTEGER)(numeric_value
+                                                    & (SQLUINTEGER)(-1));
+      }
       *pcbValue= sizeof(SQLUINTEGER);
       break;
 
     case SQL_C_FLOAT:
       if (rgbValue)
-        *((float *)rgbValue)= (float)(convert ? get_double(stmt, column_number,
-                                    value, length) : numeric_value & (int)(-1));
+      {
+        if (convert)
+        {
+          double num= get_double(stmt, column_number, value, length,
+                                 &conv_status);
+          if (num > FLT_MAX || num < -FLT_MAX)
+            conv_status= MYODBC_NUM_OVERFLOW;
+          *((float *)rgbValue)= (float)num;
+        }
+        else
+          *((float *)rgbValue)= (float)(numeric_value & (int)(-1));
+      }
       *pcbValue= sizeof(float);
       break;
 
     case SQL_C_DOUBLE:
       if (rgbValue)
         *((double *)rgbValue)= (double)(convert ? get_double(stmt, column_number,
-                                    value, length) : numeric_value);
+                                    value, length, &conv_status) : numeric_value);
       *pcbValue= sizeof(double);
       break;
 
@@ -728,10 +777,10 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
           field->type == MYSQL_TYPE_DATETIME)
       {
         SQL_TIMESTAMP_STRUCT ts;
+        char *tmp= get_string(stmt, column_number, value, &length, as_string);
 
-        switch (str_to_ts(&ts, get_string(stmt, column_number, value, &length,
-                          as_string), SQL_NTS, stmt->dbc->ds.opt_ZERO_DATE_TO_MIN,
-                          TRUE))
+        switch (str_to_ts(&ts, tmp, (int)length,
+                          stmt->dbc->ds.opt_ZERO_DATE_TO_MIN, TRUE))
         {
         case SQLTS_BAD_DATE:
           return stmt->set_error("22018", "Data value is not a valid time(stamp) value", 0);
@@ -854,7 +903,7 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
       }
       else
       {
-        switch (str_to_ts((SQL_TIMESTAMP_STRUCT *)rgbValue, tmp, SQL_NTS,
+        switch (str_to_ts((SQL_TIMESTAMP_STRUCT *)rgbValue, tmp, (int)length,
                       stmt->dbc->ds.opt_ZERO_DATE_TO_MIN, TRUE))
         {
         case SQLTS_BAD_DATE:
@@ -875,7 +924,8 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
       /** @todo This is not right. SQLBIGINT is not always longlong. */
       if (rgbValue)
         *((longlong *)rgbValue)= (longlong)(convert ? get_int64(stmt,
-                        column_number, value, length) : numeric_value);
+                        column_number, value, length, &conv_status) :
+                        numeric_value);
 
       *pcbValue= sizeof(longlong);
       break;
@@ -884,7 +934,8 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
       /** @todo This is not right. SQLUBIGINT is not always ulonglong.  */
       if (rgbValue)
           *((ulonglong *)rgbValue)= (ulonglong)(convert ? get_uint64(stmt,
-                        column_number, value, length) : u_numeric_value);
+                        column_number, value, length, &conv_status) :
+                        u_numeric_value);
 
       *pcbValue= sizeof(ulonglong);
       break;
@@ -898,21 +949,18 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
         {
           if (convert)
           {
-            sqlnum_from_str(get_string(stmt, column_number, value, &length, as_string), sqlnum, &overflow);
+            get_sqlnum(stmt, column_number, value, length, sqlnum, &overflow);
             *pcbValue = sizeof(SQL_NUMERIC_STRUCT);
           }
           else /* bit field */
           {
-            /* Lazy way - converting number we have to a string.
-               If it couldn't happen we have to scale/unscale number - we would
-               just reverse binary data */
-            std::string _value;
             if (numeric_value)
-              _value = std::to_string(numeric_value);
+              sqlnum_from_int(numeric_value < 0 ?
+                                0ULL - (unsigned long long)numeric_value :
+                                numeric_value,
+                              numeric_value < 0, sqlnum, &overflow);
             else
-              _value = std::to_string(u_numeric_value);
-
-            sqlnum_from_str(_value.c_str(), sqlnum, &overflow);
+              sqlnum_from_int(u_numeric_value, false, sqlnum, &overflow);
             *pcbValue = sizeof(ulonglong);
           }
 
@@ -923,7 +971,7 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
                                 "Numeric value out of range", 0);
         else if (overflow == 2)
         {
-          stmt->set_error("01S07", "Fractional truncation", 0);
+          stmt->set_error(MYERR_01S07, NULL, 0);
           result = SQL_SUCCESS_WITH_INFO;
         }
       }
@@ -934,6 +982,13 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
                        "Restricted data type attribute violation",0);
       break;
     }
+
+    if (conv_status != MYODBC_NUM_OK)
+    {
+      result= numeric_conv_result(stmt, conv_status, result);
+      if (!SQL_SUCCEEDED(result))
+        return result;
+    }
   }
 
   if (stmt->getdata.source)  /* Second call to getdata */
@@ -943,6 +998,38 @@ sql_get_data(STMT *stmt, SQLSMALLINT fCType, uint column_number,
 }
 
 
+/*
+  @type    : myodbc3 internal
+  @purpose : does the any open param binding
+*/
+
+SQLRETURN do_dummy_parambind(SQLHSTMT hstmt)
+{
+    SQLRETURN rc;
+    STMT *stmt= (STMT *)hstmt;
+    uint     nparam;
+
+    for ( nparam= 0; nparam < stmt->param_count; ++nparam )
+    {
+        DESCREC *aprec= desc_get_rec(stmt->apd, nparam, TRUE);
+        if (!aprec->par.real_param_done)
+        {
+            /* do the dummy bind temporarily to get the result set
+               and once everything is done, remove it */
+            if (!SQL_SUCCEEDED(rc= my_SQLBindParameter(hstmt, nparam+1,
+                                                       SQL_PARAM_INPUT,
+                                                       SQL_C_CHAR,
+                                                       SQL_VARCHAR, 0, 0,
+                                                       (SQLPOINTER)"NULL", SQL_NTS, NULL)))
+                return rc;
+            /* reset back to false (this is the *dummy* param bind) */
+            aprec->par.real_param_done= FALSE;
+        }
+    }
+    stmt->dummy_state= ST_DUMMY_PREPARED;
+    return(SQL_SUCCESS);
+}
+
 /*
   @type    : myodbc3 internal
   @purpose : execute the query if it is only prepared. This is needed
@@ -963,6 +1050,22 @@ static SQLRETURN check_result(STMT *stmt)
       /*TODO: introduce state for statements prepared on the server side */
       if (!ssps_used(stmt) && stmt_returns_result(&stmt->query))
       {
+        if (stmt->meta_described || describe_prepared(stmt))
+        {
+          error= SQL_SUCCESS;
+          break;
+        }
+
+        /*
+          The server couldn't describe it, run the query for one row with
+          the parameters that aren't bound yet set to NULL.
+        */
+        if (stmt->param_count > 0 && stmt->dummy_state == ST_DUMMY_UNKNOWN &&
+            (error= do_dummy_parambind(stmt)) != SQL_SUCCESS)
+        {
+          break;
+        }
+
         SQLULEN real_max_rows= stmt->stmt_options.max_rows;
         stmt->stmt_options.max_rows= 1;
         /* select limit will be restored back to max_rows before real execution */
@@ -986,38 +1089,6 @@ static SQLRETURN check_result(STMT *stmt)
   return(error);
 }
 
-/*
-  @type    : myodbc3 internal
-  @purpose : does the any open param binding
-*/
-
-SQLRETURN do_dummy_parambind(SQLHSTMT hstmt)
-{
-    SQLRETURN rc;
-    STMT *stmt= (STMT *)hstmt;
-    uint     nparam;
-
-    for ( nparam= 0; nparam < stmt->param_count; ++nparam )
-    {
-        DESCREC *aprec= desc_get_rec(stmt->apd, nparam, TRUE);
-        if (!aprec->par.real_param_done)
-        {
-            /* do the dummy bind temporarily to get the result set
-               and once everything is done, remove it */
-            if (!SQL_SUCCEEDED(rc= my_SQLBindParameter(hstmt, nparam+1,
-                                                       SQL_PARAM_INPUT,
-                                                       SQL_C_CHAR,
-                                                       SQL_VARCHAR, 0, 0,
-                                                       (SQLPOINTER)"NULL", SQL_NTS, NULL)))
-                return rc;
-            /* reset back to false (this is the *dummy* param bind) */
-            aprec->par.real_param_done= FALSE;
-        }
-    }
-    stmt->dummy_state= ST_DUMMY_PREPARED;
-    return(SQL_SUCCESS);
-}
-
 /*
   @type    : ODBC 1.0 API
   @purpose : returns the number of columns in a result set
@@ -1033,14 +1104,6 @@ SQLRETURN SQL_API SQLNumResultCols(SQLHSTMT  hstmt, SQLSMALLINT *pccol)
 
   if (!ssps_used(stmt))
   {
-    if (stmt->param_count > 0 && stmt->dummy_state == ST_DUMMY_UNKNOWN &&
-      (stmt->state != ST_PRE_EXECUTED || stmt->state != ST_EXECUTED))
-    {
-      if ( do_dummy_parambind(hstmt) != SQL_SUCCESS )
-      {
-        return SQL_ERROR;
-      }
-    }
     if ((error= check_result(stmt)) != SQL_SUCCESS)
     {
       return error;
@@ -1076,17 +1139,9 @@ MySQLDescribeCol(SQLHSTMT hstmt, SQLUSMALLINT column,
 
   *need_free= 0;
 
-  /* SQLDescribeCol can be called before SQLExecute. Thus we need make sure that
-     all parameters have been bound */
+  /* SQLDescribeCol can be called before SQLExecute */
   if (!ssps_used(stmt))
   {
-    if ( stmt->param_count > 0 && stmt->dummy_state == ST_DUMMY_UNKNOWN &&
-      (stmt->state != ST_PRE_EXECUTED || stmt->state != ST_EXECUTED) )
-    {
-      if ( do_dummy_parambind(hstmt) != SQL_SUCCESS )
-        return SQL_ERROR;
-    }
-
     if ((error= check_result(stmt)) != SQL_SUCCESS)
       return error;
     if (!stmt->result)
@@ -1161,15 +1216,7 @@ MySQLColAttribute(SQLHSTMT hstmt, SQLUSMALLINT column,
 
   if (!ssps_used(stmt))
   {
-    /* MySQLColAttribute can be called before SQLExecute. Thus we need make sure that
-    all parameters have been bound */
-    if ( stmt->param_count > 0 && stmt->dummy_state == ST_DUMMY_UNKNOWN &&
-      (stmt->state != ST_PRE_EXECUTED || stmt->state != ST_EXECUTED) )
-    {
-      if ( do_dummy_parambind(hstmt) != SQL_SUCCESS )
-        return SQL_ERROR;
-    }
-
+    /* MySQLColAttribute can be called before SQLExecute */
     if (check_result(stmt) != SQL_SUCCESS)
       return SQL_ERROR;
   }
@@ -1544,6 +1591,32 @@ SQLRETURN SQL_API SQLGetData(SQLHSTMT      StatementHandle,
     }
     else
     {
+      if (ssps_used(stmt) && sColNum < (long)stmt->lobs.size() &&
+          stmt->lobs[sColNum].pending)
+      {
+        MYSQL_FIELD *field= mysql_fetch_field_direct(stmt->result, sColNum);
+        bool padded= stmt->dbc->ds.opt_PAD_SPACE &&
+                     (irrec->type == SQL_CHAR || irrec->type == SQL_WCHAR);
+
+        /*
+          Binary data, and character data that needs no conversion, is read
+          piece by piece into the application buffer. Wide characters and
+          hex strings are converted from the whole value, which is read
+          once and released after the row if it is above MAX_LOB_BUFFER.
+        */
+        if (!padded && (TargetType == SQL_C_BINARY ||
+                        (TargetType == SQL_C_CHAR &&
+                         field->charsetnr != BINARY_CHARSET_NUMBER)))
+        {
+          return ssps_get_lob_chunk(stmt, sColNum, (SQLCHAR *)TargetValuePtr,
+                                    BufferLength, StrLen_or_IndPtr,
+                                    TargetType == SQL_C_CHAR);
+        }
+
+        if ((result= ssps_fetch_lob(stmt, sColNum)) != SQL_SUCCESS)
+          return result;
+      }
+
       /* catalog functions with "fake" results won't have lengths */
       length= irrec->row.datalen;
       if (!length && stmt->current_values[sColNum])
@@ -1659,6 +1732,11 @@ SQLRETURN SQL_API SQLMoreResults( SQLHSTMT hstmt )
   {
     nReturn= stmt->set_error("HY000");
   }
+  else if (memory_check_result(stmt))
+  {
+    nReturn= SQL_ERROR;
+    goto exitSQLMoreResults;
+  }
   fix_result_types(stmt);
 
   /* checking if next result is SP OUT params and fetch them if needed */
@@ -1842,6 +1920,15 @@ fill_fetch_buffers(STMT *stmt, MYSQL_ROW values, uint rownum)
   ulong length= 0;
   DESCREC *irrec, *arrec;
 
+  if (stmt->dbc->perf)
+  {
+    unsigned long long bytes= 0;
+    for (i= 0; i < stmt->ird->rcount(); ++i)
+      bytes+= desc_get_rec(stmt->ird, i, FALSE)->row.datalen;
+    perf_count(stmt->dbc, PERF_ROWS_FETCHED);
+    perf_count(stmt->dbc, PERF_BYTES_IN, bytes);
+  }
+
   for (i= 0; i < myodbc_min(stmt->ird->rcount(), stmt->ard->rcount()); ++i, ++values)
   {
     irrec= desc_get_rec(stmt->ird, i, FALSE);
@@ -1910,6 +1997,199 @@ fill_fetch_buffers(STMT *stmt, MYSQL_ROW values, uint rownum)
 }
 
 
+/* Folds the result of one value into the result of its row */
+static void merge_row_result(SQLRETURN &res, SQLRETURN tmp_res)
+{
+  if (tmp_res == SQL_SUCCESS)
+    return;
+
+  if (tmp_res == SQL_SUCCESS_WITH_INFO)
+  {
+    if (res == SQL_SUCCESS)
+      res= tmp_res;
+  }
+  else
+  {
+    res= SQL_ERROR;
+  }
+}
+
+
+static inline long long parse_column_value(const char *value, ulong length,
+                                           SQLINTEGER *, int *status)
+{
+  long long num= myodbc_parse_int64(value, length, status);
+  if (num < INT_MIN32 || num > INT_MAX32)
+    *status= MYODBC_NUM_OVERFLOW;
+  return num;
+}
+
+static inline long long parse_column_value(const char *value, ulong length,
+                                           SQLBIGINT *, int *status)
+{
+  return myodbc_parse_int64(value, length, status);
+}
+
+static inline double parse_column_value(const char *value, ulong length,
+                                        SQLDOUBLE *, int *status)
+{
+  return myodbc_parse_double(value, length, status);
+}
+
+static inline SQLSMALLINT column_c_type(SQLINTEGER *) { return SQL_C_LONG; }
+static inline SQLSMALLINT column_c_type(SQLBIGINT *) { return SQL_C_SBIGINT; }
+static inline SQLSMALLINT column_c_type(SQLDOUBLE *) { return SQL_C_DOUBLE; }
+
+
+/*
+  Converts an integer column of the block into a contiguous array of T,
+  doing the same as sql_get_data() would for every value.
+*/
+template <typename T>
+static void fill_fixed_column(STMT *stmt, FETCH_BLOCK &block, uint column,
+                              SQLULEN nrows, T *data, SQLLEN *ind)
+{
+  const uint field_count= stmt->result->field_count;
+  PERF_SCOPE perf_scope(stmt->dbc, PERF_TIME_CONVERSION);
+
+  perf_count_conversion(stmt->dbc, stmt->result->fields[column].type,
+                        column_c_type(data), nrows);
+
+  for (SQLULEN row= 0; row < nrows; ++row)
+  {
+    const char *value= block.rows[row][column];
+
+    if (!value)
+    {
+      if (ind)
+        ind[row]= SQL_NULL_DATA;
+      else
+        merge_row_result(block.results[row], stmt->set_error("22002",
+                         "Indicator variable required but not supplied", 0));
+      continue;
+    }
+
+    int status= MYODBC_NUM_OK;
+    T num= (T)parse_column_value(value,
+                                 block.lengths[row * field_count + column],
+                                 data, &status);
+    if (data)
+      data[row]= num;
+    if (ind)
+      ind[row]= sizeof(T);
+
+    if (status != MYODBC_NUM_OK)
+      merge_row_result(block.results[row],
+                       numeric_conv_result(stmt, status, SQL_SUCCESS));
+  }
+}
+
+
+/*
+  @type    : myodbc3 internal
+  @purpose : column-wise counterpart of fill_fetch_buffers() for a block
+             of rows bound with SQL_BIND_BY_COLUMN. Each bound column is
+             converted for all rows of the block into its application
+             array before moving to the next one. Integer columns fetched
+             as SQL_C_LONG, SQL_C_SBIGINT or SQL_C_DOUBLE take a tight
+             loop, everything else goes through sql_get_data().
+  @param[in]  stmt        Handle of statement
+  @param[in]  nrows       Number of rows in stmt->fetch_block
+*/
+static void fill_fetch_columns(STMT *stmt, SQLULEN nrows)
+{
+  FETCH_BLOCK &block= stmt->fetch_block;
+  const uint field_count= stmt->result->field_count;
+  int i;
+  SQLULEN row;
+
+  for (row= 0; row < nrows; ++row)
+    block.results[row]= SQL_SUCCESS;
+
+  if (stmt->dbc->perf)
+  {
+    unsigned long long bytes= 0;
+    for (SQLULEN n= 0; n < nrows * field_count; ++n)
+      bytes+= block.lengths[n];
+    perf_count(stmt->dbc, PERF_ROWS_FETCHED, nrows);
+    perf_count(stmt->dbc, PERF_BYTES_IN, bytes);
+  }
+
+  for (i= 0; i < myodbc_min(stmt->ird->rcount(), stmt->ard->rcount()); ++i)
+  {
+    DESCREC *irrec= desc_get_rec(stmt->ird, i, FALSE);
+    DESCREC *arrec= desc_get_rec(stmt->ard, i, FALSE);
+    assert(irrec && arrec);
+
+    if (!ARD_IS_BOUND(arrec))
+      continue;
+
+    MYSQL_FIELD *field= mysql_fetch_field_direct(stmt->result, i);
+    SQLPOINTER data= ptr_offset_adjust(arrec->data_ptr,
+                                       stmt->ard->bind_offset_ptr,
+                                       SQL_BIND_BY_COLUMN, 0, 0);
+    SQLLEN *ind= (SQLLEN *)ptr_offset_adjust(arrec->octet_length_ptr,
+                                             stmt->ard->bind_offset_ptr,
+                                             SQL_BIND_BY_COLUMN, 0, 0);
+
+    if (field->type == MYSQL_TYPE_TINY || field->type == MYSQL_TYPE_SHORT ||
+        field->type == MYSQL_TYPE_INT24 || field->type == MYSQL_TYPE_LONG ||
+        field->type == MYSQL_TYPE_LONGLONG)
+    {
+      switch (arrec->concise_type)
+      {
+      case SQL_C_LONG:
+      case SQL_C_SLONG:
+        if (arrec->octet_length != sizeof(SQLINTEGER))
+          break;
+        fill_fixed_column(stmt, block, i, nrows, (SQLINTEGER *)data, ind);
+        continue;
+
+      case SQL_C_SBIGINT:
+        if (arrec->octet_length != sizeof(SQLBIGINT))
+          break;
+        fill_fixed_column(stmt, block, i, nrows, (SQLBIGINT *)data, ind);
+        continue;
+
+      case SQL_C_DOUBLE:
+        if (arrec->octet_length != sizeof(SQLDOUBLE))
+          break;
+        fill_fixed_column(stmt, block, i, nrows, (SQLDOUBLE *)data, ind);
+        continue;
+      }
+    }
+
+    for (row= 0; row < nrows; ++row)
+    {
+      char *value= block.rows[row][i];
+      ulong length= block.lengths[row * field_count + i];
+
+      stmt->reset_getdata_position();
+
+      if (!length && value)
+      {
+        length= (ulong)strlen(value);
+      }
+
+      std::string temp_str;
+      char *temp_val= fix_padding(stmt, arrec->concise_type, value,
+                                  temp_str, arrec->octet_length,
+                                  length, irrec);
+
+      merge_row_result(block.results[row],
+                       sql_get_data(stmt, arrec->concise_type, (uint)i,
+                                    ptr_offset_adjust(data, NULL,
+                                                      SQL_BIND_BY_COLUMN,
+                                                      (SQLINTEGER)arrec->octet_length,
+                                                      row),
+                                    arrec->octet_length,
+                                    ind ? ind + row : NULL,
+                                    temp_val, length, arrec));
+    }
+  }
+}
+
+
 /*
   @type    : myodbc3 internal
   @purpose : fetches the specified row from the result set and
@@ -1932,6 +2212,7 @@ SQLRETURN SQL_API myodbc_single_fetch( SQLHSTMT             hstmt,
   SQLULEN           dummy_pcrow;
   BOOL              disconnected= FALSE;
   long              brow= 0;
+  PERF_SCOPE        perf_scope(stmt->dbc, PERF_TIME_FETCH);
 
   try
   {
@@ -2105,7 +2386,7 @@ SQLRETURN SQL_API myodbc_single_fetch( SQLHSTMT             hstmt,
     {
       save_position= row_tell(stmt);
       /* - Actual fetching happens here - */
-      if (!(values = stmt->fetch_row()) )
+      if (!(values = stmt->fetch_row(false, true)) )
       {
         if (scroller_exists(stmt))
         {
@@ -2118,7 +2399,7 @@ SQLRETURN SQL_API myodbc_single_fetch( SQLHSTMT             hstmt,
             goto exitSQLSingleFetch;
           }
 
-          if ( !(values = stmt->fetch_row()) )
+          if ( !(values = stmt->fetch_row(false, true)) )
           {
             goto exitSQLSingleFetch;
           }
@@ -2263,6 +2544,7 @@ SQLRETURN SQL_API my_SQLExtendedFetch( SQLHSTMT             hstmt,
   SQLULEN           dummy_pcrow;
   BOOL              disconnected= FALSE;
   long              brow= 0;
+  PERF_SCOPE        perf_scope(stmt->dbc, PERF_TIME_FETCH);
 
   auto span_stop_if_no_data = [](STMT *stmt) {
     if (!mysql_more_results(stmt->dbc->mysql))
@@ -2359,6 +2641,63 @@ SQLRETURN SQL_API my_SQLExtendedFetch( SQLHSTMT             hstmt,
       }
     }
 
+    /*
+      Rows of plain buffered results stay valid until the result is freed,
+      so a block bound by column can be fetched first and then converted
+      column by column.
+    */
+    bool by_column= rows_to_fetch > 1
+      && stmt->ard->bind_type == SQL_BIND_BY_COLUMN
+      && !stmt->result_array && !stmt->fix_fields
+      && !ssps_used(stmt) && !if_forward_cache(stmt)
+      && !scroller_exists(stmt)
+      && stmt->out_params_state == OPS_UNKNOWN
+      && !(fFetchType == SQL_FETCH_BOOKMARK &&
+           stmt->stmt_options.bookmarks == SQL_UB_VARIABLE);
+
+    if (by_column)
+    {
+      stmt->fetch_block.resize(rows_to_fetch, stmt->result->field_count);
+    }
+
+    auto set_row_result = [&](SQLULEN row, SQLRETURN row_result)
+    {
+      /* For SQL_SUCCESS we need all rows to be SQL_SUCCESS */
+      if (res != row_result || res != row_book)
+      {
+        /* Any successful row makes overall result SQL_SUCCESS_WITH_INFO */
+        if (SQL_SUCCEEDED(row_result) && SQL_SUCCEEDED(row_result))
+        {
+          res= SQL_SUCCESS_WITH_INFO;
+        }
+        /* Else error */
+        else if (row == 0)
+        {
+          /* SQL_ERROR only if all rows fail */
+          res= SQL_ERROR;
+        }
+        else
+        {
+          res= SQL_SUCCESS_WITH_INFO;
+        }
+      }
+
+      /* "Fetching" includes buffers filling. I think errors in that
+         have to affect row status */
+
+      if (rgfRowStatus)
+      {
+        rgfRowStatus[row]= sqlreturn2row_status(row_result);
+      }
+      /*
+        No need to update rowStatusPtr_ex, it's the same as rgfRowStatus.
+      */
+      if (upd_status && stmt->ird->array_status_ptr)
+      {
+        stmt->ird->array_status_ptr[row]= sqlreturn2row_status(row_result);
+      }
+    };
+
     res= SQL_SUCCESS;
     for (i= 0 ; i < rows_to_fetch ; ++i)
     {
@@ -2381,7 +2720,7 @@ SQLRETURN SQL_API my_SQLExtendedFetch( SQLHSTMT             hstmt,
         }
         /* - Actual fetching happens here - */
         if ( stmt->out_params_state == OPS_UNKNOWN
-          && !(values = stmt->fetch_row()) )
+          && !(values = stmt->fetch_row(false, true)) )
         {
           if (scroller_exists(stmt))
           {
@@ -2394,7 +2733,7 @@ SQLRETURN SQL_API my_SQLExtendedFetch( SQLHSTMT             hstmt,
               break;
             }
 
-            if ( !(values = stmt->fetch_row()) )
+            if ( !(values = stmt->fetch_row(false, true)) )
             {
               break;
             }
@@ -2421,6 +2760,17 @@ SQLRETURN SQL_API my_SQLExtendedFetch( SQLHSTMT             hstmt,
         stmt->current_values= values;
       }
 
+      if (by_column)
+      {
+        /* Buffers are filled once the whole block is fetched */
+        stmt->fetch_block.rows[i]= values;
+        memcpy(&stmt->fetch_block.lengths[i * stmt->result->field_count],
+               fetch_lengths(stmt),
+               sizeof(unsigned long) * stmt->result->field_count);
+        ++cur_row;
+        continue;
+      }
+
       if (!stmt->fix_fields)
       {
         /* lengths contains lengths for all rows. Alternate use could be
@@ -2450,44 +2800,25 @@ SQLRETURN SQL_API my_SQLExtendedFetch( SQLHSTMT             hstmt,
         row_book= fill_fetch_bookmark_buffers(stmt, (ulong)(irow + i + 1), (uint)i);
       }
       row_res= fill_fetch_buffers(stmt, values, (uint)i);
+      set_row_result(i, row_res);
 
-      /* For SQL_SUCCESS we need all rows to be SQL_SUCCESS */
-      if (res != row_res || res != row_book)
-      {
-        /* Any successful row makes overall result SQL_SUCCESS_WITH_INFO */
-        if (SQL_SUCCEEDED(row_res) && SQL_SUCCEEDED(row_res))
-        {
-          res= SQL_SUCCESS_WITH_INFO;
-        }
-        /* Else error */
-        else if (i == 0)
-        {
-          /* SQL_ERROR only if all rows fail */
-          res= SQL_ERROR;
-        }
-        else
-        {
-          res= SQL_SUCCESS_WITH_INFO;
-        }
-      }
+      ++cur_row;
+    }   /* fetching cycle end*/
 
-      /* "Fetching" includes buffers filling. I think errors in that
-         have to affect row status */
+    if (by_column && i > 0)
+    {
+      /* IRD describes the last fetched row as it does for single rows */
+      fill_ird_data_lengths(stmt->ird,
+        &stmt->fetch_block.lengths[(i - 1) * stmt->result->field_count],
+        stmt->result->field_count);
 
-      if (rgfRowStatus)
-      {
-        rgfRowStatus[i]= sqlreturn2row_status(row_res);
-      }
-      /*
-        No need to update rowStatusPtr_ex, it's the same as rgfRowStatus.
-      */
-      if (upd_status && stmt->ird->array_status_ptr)
+      fill_fetch_columns(stmt, i);
+
+      for (SQLULEN row= 0; row < i; ++row)
       {
-        stmt->ird->array_status_ptr[i]= sqlreturn2row_status(row_res);
+        set_row_result(row, stmt->fetch_block.results[row]);
       }
-
-      ++cur_row;
-    }   /* fetching cycle end*/
+    }
 
     stmt->rows_found_in_set = (uint)i;
     *pcrow= i;
@@ -2542,7 +2873,7 @@ SQLRETURN SQL_API my_SQLExtendedFetch( SQLHSTMT             hstmt,
   catch(const MYERROR &e)
   {
     res = e.retcode;
-    stmt->telemetry.set_error(stmt, e.message);
+    stmt->telemetry.set_error(stmt, e.message());
   }
   return res;
 }
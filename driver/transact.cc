@@ -81,6 +81,7 @@ static SQLRETURN my_transact(SQLHDBC hdbc, SQLSMALLINT CompletionType)
 			     mysql_error(dbc->mysql),
 			     mysql_errno(dbc->mysql));
     }
+    result_cache_end_transaction(dbc);
   }
   return(result);
 }
@@ -109,11 +110,10 @@ end_transaction(SQLSMALLINT HandleType,
   case SQL_HANDLE_ENV:
   {
     henv= (ENV *)Handle;
-    LOCK_ENV(henv);
-    for (DBC *dbc : henv->conn_list)
+    henv->for_each_dbc([CompletionType](DBC *dbc)
     {
         my_transact(dbc, CompletionType);
-    }
+    });
     break;
   }
   case SQL_HANDLE_DBC:
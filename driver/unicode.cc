@@ -81,6 +81,51 @@ SQLColAttributeW(SQLHSTMT hstmt, SQLUSMALLINT column,
 }
 
 
+/*
+  Returns the UTF-16 copy of a name of the IRD record for column, converting
+  it on first use. The copy stays with the record until it is described
+  anew, asking for the same name again is a copy. Returns NULL if value is
+  not one of the record's names or memory ran out.
+*/
+static const SQLWSTRING *cached_wide_name(STMT *stmt, SQLUSMALLINT column,
+                                          SQLCHAR *value)
+{
+  DESCREC *irrec;
+  DESCREC::row_struct::wide_name *cache;
+
+  if (column == 0 || column > stmt->ird->rcount() ||
+      !(irrec= desc_get_rec(stmt->ird, column - 1, FALSE)))
+    return NULL;
+
+  if (value == irrec->name)
+    cache= &irrec->row.wname;
+  else if (value == irrec->table_name)
+    cache= &irrec->row.wtable_name;
+  else if (value == irrec->base_column_name)
+    cache= &irrec->row.wbase_column_name;
+  else if (value == irrec->base_table_name)
+    cache= &irrec->row.wbase_table_name;
+  else
+    return NULL;
+
+  if (cache->src != value)
+  {
+    SQLINTEGER len= SQL_NTS;
+    uint errors;
+    SQLWCHAR *wvalue= sqlchar_as_sqlwchar(stmt->dbc->cxn_charset_info, value,
+                                          &len, &errors);
+    if (!wvalue)
+      return NULL;
+
+    cache->value.assign(wvalue, len);
+    cache->src= value;
+    x_free(wvalue);
+  }
+
+  return &cache->value;
+}
+
+
 SQLRETURN SQL_API
 SQLColAttributeWImpl(SQLHSTMT hstmt, SQLUSMALLINT column,
                      SQLUSMALLINT field, SQLPOINTER char_attr,
@@ -96,9 +141,16 @@ SQLColAttributeWImpl(SQLHSTMT hstmt, SQLUSMALLINT column,
 
   if (value)
   {
-    my_bool free_value= FALSE;
-    wvalue= sqlchar_as_sqlwchar(stmt->dbc->cxn_charset_info, value,
-                                &len, &errors);
+    const SQLWSTRING *cached= cached_wide_name(stmt, column, value);
+
+    if (cached)
+    {
+      wvalue= (SQLWCHAR *)cached->c_str();
+      len= (SQLINTEGER)cached->size();
+    }
+    else
+      wvalue= sqlchar_as_sqlwchar(stmt->dbc->cxn_charset_info, value,
+                                  &len, &errors);
 
     /* char_attr_max is in bytes, we want it in chars. */
     char_attr_max/= sizeof(SQLWCHAR);
@@ -118,9 +170,8 @@ SQLColAttributeWImpl(SQLHSTMT hstmt, SQLUSMALLINT column,
       ((SQLWCHAR *)char_attr)[len]= 0;
     }
 
-    if (free_value)
-      x_free(value);
-    x_free(wvalue);
+    if (!cached)
+      x_free(wvalue);
   }
 
   return rc;
@@ -279,8 +330,18 @@ SQLDescribeColW(SQLHSTMT hstmt, SQLUSMALLINT column,
 
   if (value)
   {
-    wvalue= sqlchar_as_sqlwchar(stmt->dbc->cxn_charset_info, value, &len,
-                                &errors);
+    /* A name joined with its table for FULL_COLUMN_NAMES isn't kept */
+    const SQLWSTRING *cached= free_value ? NULL :
+                              cached_wide_name(stmt, column, value);
+
+    if (cached)
+    {
+      wvalue= (SQLWCHAR *)cached->c_str();
+      len= (SQLINTEGER)cached->size();
+    }
+    else
+      wvalue= sqlchar_as_sqlwchar(stmt->dbc->cxn_charset_info, value, &len,
+                                  &errors);
     if (len == -1)
     {
       if (free_value)
@@ -306,7 +367,8 @@ SQLDescribeColW(SQLHSTMT hstmt, SQLUSMALLINT column,
 
     if (free_value)
       x_free(value);
-    x_free(wvalue);
+    if (!cached)
+      x_free(wvalue);
   }
 
   return rc;
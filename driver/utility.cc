@@ -161,6 +161,7 @@ void fix_result_types(STMT *stmt)
     field= result->fields + i;
 
     irrec->row.field= field;
+    irrec->row.clear_wide_names();
     irrec->type= get_sql_data_type(stmt, field, NULL);
     irrec->concise_type= get_sql_data_type(stmt, field,
                                            (char *)irrec->row.type_name);
@@ -1929,6 +1930,74 @@ SQLLEN get_bookmark_value(SQLSMALLINT fCType, SQLPOINTER rgbValue)
 }
 
 
+/* Value of the two digits at str, or -1 if either is not a digit */
+static inline int two_digits(const char *str)
+{
+  uint hi= (uint)(uchar)str[0] - '0', lo;
+
+  /* don't read past the terminating null */
+  if (hi > 9 || (lo= (uint)(uchar)str[1] - '0') > 9)
+    return -1;
+
+  return (int)(hi * 10 + lo);
+}
+
+
+/*
+  Fixed-offset parser for "YYYY-MM-DD", "YYYY-MM-DD hh:mm:ss" and
+  "YYYY-MM-DD hh:mm:ss.f" (up to 9 fractional digits), the layouts the
+  server sends DATE, DATETIME and TIMESTAMP values in. Returns FALSE for
+  anything else, which then goes through the generic parsing in
+  str_to_ts(). Values are not range checked, just like there.
+*/
+static BOOL canonical_str_to_ts(SQL_TIMESTAMP_STRUCT *ts, const char *str,
+                                size_t len)
+{
+  int century, year, month, day, hour= 0, minute= 0, second= 0;
+  SQLUINTEGER fraction= 0;
+
+  if (len < 10 || str[4] != '-' || str[7] != '-' ||
+      (century= two_digits(str)) < 0 || (year= two_digits(str + 2)) < 0 ||
+      (month= two_digits(str + 5)) < 0 || (day= two_digits(str + 8)) < 0)
+    return FALSE;
+
+  if (len > 10)
+  {
+    if (len < 19 || str[10] != ' ' || str[13] != ':' || str[16] != ':' ||
+        (hour= two_digits(str + 11)) < 0 ||
+        (minute= two_digits(str + 14)) < 0 ||
+        (second= two_digits(str + 17)) < 0)
+      return FALSE;
+
+    if (len > 19)
+    {
+      SQLUINTEGER scale= 100000000;
+
+      if (str[19] != '.' || len == 20 || len > 29)
+        return FALSE;
+
+      for (str+= 20, len-= 20; len; ++str, --len, scale/= 10)
+      {
+        uint d= (uint)(uchar)*str - '0';
+        if (d > 9)
+          return FALSE;
+        fraction+= d * scale;
+      }
+    }
+  }
+
+  ts->year=     century * 100 + year;
+  ts->month=    month;
+  ts->day=      day;
+  ts->hour=     hour;
+  ts->minute=   minute;
+  ts->second=   second;
+  ts->fraction= fraction;
+
+  return TRUE;
+}
+
+
 /*
   @type    : myodbc internal
   @purpose : convert a possible string to a timestamp value
@@ -1954,6 +2023,27 @@ int str_to_ts(SQL_TIMESTAMP_STRUCT *ts, const char *str, int len, int zeroToMin,
       len = (int)strlen(str);
     }
 
+    /* Values coming from the server take the fixed layout fast path */
+    if (dont_use_set_locale &&
+        canonical_str_to_ts(&tmp_timestamp, str, (size_t)len))
+    {
+      if (!tmp_timestamp.month || !tmp_timestamp.day)
+      {
+        if (!zeroToMin) /* Don't convert invalid */
+          return SQLTS_NULL_DATE;
+
+        /* convert invalid to min allowed */
+        if (!tmp_timestamp.month)
+          tmp_timestamp.month= 1;
+        if (!tmp_timestamp.day)
+          tmp_timestamp.day= 1;
+      }
+
+      if (ts != &tmp_timestamp)
+        *ts= tmp_timestamp;
+      return 0;
+    }
+
     /* We don't wan to change value in the out parameter directly
        before we know that string is a good datetime */
     end= get_fractional_part(str, len, dont_use_set_locale, &fraction);
@@ -2048,6 +2138,27 @@ my_bool str_to_time_st(SQL_TIME_STRUCT *ts, const char *str)
     if ( !ts )
         ts= (SQL_TIME_STRUCT *) &tmp_time;
 
+    /* Fast path for the "hh:mm:ss" and "hhh:mm:ss" the server sends */
+    {
+      const char *pos= str;
+      int hundreds= 0;
+
+      if (isdigit(pos[0]) && isdigit(pos[1]) && isdigit(pos[2]))
+        hundreds= digit(*pos++);
+
+      if ((int_hour= two_digits(pos)) >= 0 && pos[2] == ':' &&
+          (int_min= two_digits(pos + 3)) >= 0 && int_min < 60 &&
+          pos[5] == ':' &&
+          (int_sec= two_digits(pos + 6)) >= 0 && int_sec < 60 &&
+          !isdigit(pos[8]))
+      {
+        ts->hour=   (SQLUSMALLINT)(hundreds * 100 + int_hour);
+        ts->minute= (SQLUSMALLINT)int_min;
+        ts->second= (SQLUSMALLINT)int_sec;
+        return 0;
+      }
+    }
+
     /* remember the position of the first numeric string */
     tokens[0]= buff;
 
@@ -2110,6 +2221,22 @@ my_bool str_to_date(SQL_DATE_STRUCT *rgbValue, const char *str,
     uint field_length,year_length,digits,i,date[3];
     const char *pos;
     const char *end= str+length;
+    int year_hi, year_lo, month, day;
+
+    /* Fast path for the "YYYY-MM-DD" the server sends */
+    if (length >= 10 && str[4] == '-' && str[7] == '-' &&
+        (year_hi= two_digits(str)) >= 0 && (year_lo= two_digits(str + 2)) >= 0 &&
+        (month= two_digits(str + 5)) >= 0 && (day= two_digits(str + 8)) >= 0)
+    {
+      if ((!month || !day) && !zeroToMin)
+        return 1;
+
+      rgbValue->year=  year_hi * 100 + year_lo;
+      rgbValue->month= month ? month : 1;
+      rgbValue->day=   day ? day : 1;
+      return 0;
+    }
+
     for ( ; !isdigit(*str) && str != end ; ++str ) ;
     /*
       Calculate first number of digits.
@@ -2235,6 +2362,7 @@ int check_if_server_is_alive( DBC *dbc )
             if (is_connection_lost(mysql_errno( dbc->mysql )))
                 result = 1;
         }
+        dbc->track_io(result ? mysql_errno(dbc->mysql) : 0);
     }
     dbc->last_query_time = seconds;
 
@@ -2265,6 +2393,14 @@ int reget_current_catalog(DBC *dbc)
 {
     dbc->database.clear();
 
+    /* The client library follows the schema changes the server reports */
+    if (dbc->schema_tracked)
+    {
+        if (dbc->mysql->db)
+            dbc->database = dbc->mysql->db;
+        return 0;
+    }
+
     if (dbc->execute_query("select database()", SQL_NTS, true))
     {
         return 1;
@@ -2550,246 +2686,328 @@ ulong myodbc_escape_string(STMT *stmt,
 }
 
 
-/**
-  Scale an int[] representing SQL_C_NUMERIC
-
-  @param[in] ary   Array in little endian form
-  @param[in] s     Scale
+/*
+  Unsigned 128-bit integer holding the value of a SQL_NUMERIC_STRUCT.
+  Uses the compiler's native 128-bit type when there is one, and
+  four 32-bit limbs otherwise. Building with SQLNUM_NO_INT128 forces the
+  limbs, which is what MSVC compiles.
 */
-void sqlnum_scale(unsigned *ary, int s)
+struct sqlnum_uint128
 {
-  /* multiply out all pieces */
-  while (s--)
+#if defined(__SIZEOF_INT128__) && !defined(SQLNUM_NO_INT128)
+  unsigned __int128 v= 0;
+
+  bool is_zero() const { return v == 0; }
+
+  /* this= this * mul + add; returns false on overflow */
+  bool mul_add(uint32 mul, uint32 add)
   {
-    ary[0] *= 10;
-    ary[1] *= 10;
-    ary[2] *= 10;
-    ary[3] *= 10;
-    ary[4] *= 10;
-    ary[5] *= 10;
-    ary[6] *= 10;
-    ary[7] *= 10;
+    unsigned __int128 lo= (unsigned __int128)(uint64)v * mul + add;
+    unsigned __int128 hi= (v >> 64) * mul + (lo >> 64);
+    if (hi >> 64)
+      return false;
+    v= (hi << 64) | (uint64)lo;
+    return true;
   }
-}
-
 
-/**
-  Unscale an int[] representing SQL_C_NUMERIC. This
-  leaves the last element (0) with the value of the
-  last digit.
+  /* this /= div; returns the remainder */
+  uint32 divmod(uint32 div)
+  {
+    unsigned __int128 q= v / div;
+    uint32 rem= (uint32)(v - q * div);
+    v= q;
+    return rem;
+  }
 
-  @param[in] ary   Array in little endian form
-*/
-static void sqlnum_unscale_le(unsigned *ary)
-{
-  int i;
-  for (i= 7; i > 0; --i)
+  void from_bytes(const SQLCHAR *val)
   {
-    ary[i - 1] += (ary[i] % 10) << 16;
-    ary[i] /= 10;
+    v= 0;
+    for (int i= SQL_MAX_NUMERIC_LEN - 1; i >= 0; --i)
+      v= (v << 8) | val[i];
   }
-}
 
+  void to_bytes(SQLCHAR *val) const
+  {
+    unsigned __int128 tmp= v;
+    for (int i= 0; i < SQL_MAX_NUMERIC_LEN; ++i, tmp >>= 8)
+      val[i]= (SQLCHAR)(tmp & 0xff);
+  }
+#else
+  /* little-endian */
+  uint32 limb[4]= {0, 0, 0, 0};
 
-/**
-  Unscale an int[] representing SQL_C_NUMERIC. This
-  leaves the last element (7) with the value of the
-  last digit.
+  bool is_zero() const
+  {
+    return !(limb[0] | limb[1] | limb[2] | limb[3]);
+  }
 
-  @param[in] ary   Array in big endian form
-*/
-static void sqlnum_unscale_be(unsigned *ary, int start)
-{
-  int i;
-  for (i= start; i < 7; ++i)
+  bool mul_add(uint32 mul, uint32 add)
   {
-    ary[i + 1] += (ary[i] % 10) << 16;
-    ary[i] /= 10;
+    uint64 carry= add;
+    for (int i= 0; i < 4; ++i)
+    {
+      uint64 t= (uint64)limb[i] * mul + carry;
+      limb[i]= (uint32)t;
+      carry= t >> 32;
+    }
+    return carry == 0;
   }
-}
 
+  uint32 divmod(uint32 div)
+  {
+    uint64 rem= 0;
+    for (int i= 3; i >= 0; --i)
+    {
+      uint64 t= (rem << 32) | limb[i];
+      limb[i]= (uint32)(t / div);
+      rem= t % div;
+    }
+    return (uint32)rem;
+  }
 
-/**
-  Perform the carry to get all elements below 2^16.
-  Should be called right after sqlnum_scale().
+  void from_bytes(const SQLCHAR *val)
+  {
+    for (int i= 0; i < 4; ++i)
+      limb[i]= (uint32)val[4 * i] | ((uint32)val[4 * i + 1] << 8) |
+               ((uint32)val[4 * i + 2] << 16) | ((uint32)val[4 * i + 3] << 24);
+  }
 
-  @param[in] ary   Array in little endian form
-*/
-static void sqlnum_carry(unsigned *ary)
-{
-  int i;
-  /* carry over rest of structure */
-  for (i= 0; i < 7; ++i)
+  void to_bytes(SQLCHAR *val) const
   {
-    ary[i+1] += ary[i] >> 16;
-    ary[i] &= 0xffff;
+    for (int i= 0; i < 4; ++i)
+    {
+      val[4 * i]= (SQLCHAR)(limb[i] & 0xff);
+      val[4 * i + 1]= (SQLCHAR)((limb[i] >> 8) & 0xff);
+      val[4 * i + 2]= (SQLCHAR)((limb[i] >> 16) & 0xff);
+      val[4 * i + 3]= (SQLCHAR)(limb[i] >> 24);
+    }
   }
-}
+#endif
+};
+
+/* Largest power of 10 that fits in 32 bits, used to move 9 digits at once */
+#define SQLNUM_CHUNK_DIGITS 9
+#define SQLNUM_CHUNK_BASE   1000000000U
 
 
 /**
-  Retrieve a SQL_NUMERIC_STRUCT from a string. The requested scale
-  and precesion are first read from sqlnum, and then updated values
-  are written back at the end.
+  Store an unscaled value into a SQL_NUMERIC_STRUCT, applying the requested
+  scale and checking the requested precision read from sqlnum. Shared by
+  the string and integer conversions.
 
-  @param[in] numstr       String representation of number to convert
   @param[in] sqlnum       Destination struct
-  @param[in] overflow_ptr Whether or not whole-number overflow occurred.
-                          This indicates failure, and the result of sqlnum
-                          is undefined.
+  @param[in] value        Unscaled value (all digits of the number)
+  @param[in] negative     Whether the number is negative
+  @param[in] precision    Number of digits in value
+  @param[in] scale        Number of digits in value after the decimal point
+  @param[in] truncated    Whether non-zero fractional digits were already
+                          dropped from value
+  @param[in] overflow_ptr Set as described in sqlnum_from_str()
 */
-
-void sqlnum_from_str(const char *numstr, SQL_NUMERIC_STRUCT *sqlnum,
-                     int *overflow_ptr)
+static void sqlnum_from_value(SQL_NUMERIC_STRUCT *sqlnum,
+                              sqlnum_uint128 value, bool negative,
+                              SQLCHAR precision, SQLSCHAR scale,
+                              bool truncated, int *overflow_ptr)
 {
-  /*
-     We use 16 bits of each integer to convert the
-     current segment of the number leaving extra bits
-     to multiply/carry
-  */
-  unsigned build_up[8], tmp_prec_calc[8];
-  /* current segment as integer */
-  unsigned int curnum;
-  /* current segment digits copied for strtoul() */
-  char curdigs[5];
-  /* number of digits in current segment */
-  int usedig;
-  int i;
-  int len;
-  char *decpt= strchr((char*)numstr, '.');
-  int overflow= 0;
+  int overflow= truncated ? 2 : 0;
   SQLSCHAR reqscale= sqlnum->scale;
   SQLCHAR reqprec= sqlnum->precision;
 
   memset(&sqlnum->val, 0, sizeof(sqlnum->val));
-  memset(build_up, 0, sizeof(build_up));
-
-  /* handle sign */
-  if (!(sqlnum->sign= !(*numstr == '-')))
-    ++numstr;
-
-  len= (int) strlen(numstr);
-  sqlnum->precision= len;
-  sqlnum->scale= 0;
+  sqlnum->sign= !negative;
 
-  /* process digits in groups of <=4 */
-  for (i= 0; i < len; i += usedig)
+  /* scale the number to the requested scale */
+  if (reqscale > 0 && reqscale > scale)
   {
-    if (i + 4 < len)
-      usedig= 4;
-    else
-      usedig= len - i;
-    /*
-       if we have the decimal point, ignore it by setting it to the
-       last char (will be ignored by strtoul)
-    */
-    if (decpt && decpt >= numstr + i && decpt < numstr + i + usedig)
+    while (reqscale > scale)
     {
-      usedig = (int) (decpt - (numstr + i) + 1);
-      sqlnum->scale= len - (i + usedig);
-      --sqlnum->precision;
-      decpt= NULL;
-    }
-
-    if (overflow)
-      goto end;
-
-    /* grab just this piece, and convert to int */
-    memcpy(curdigs, numstr + i, usedig);
-    curdigs[usedig]= 0;
-    curnum= strtoul(curdigs, NULL, 10);
-    if (curdigs[usedig - 1] == '.')
-      sqlnum_scale(build_up, usedig - 1);
-    else
-      sqlnum_scale(build_up, usedig);
-    /* add the current number */
-    build_up[0] += curnum;
-    sqlnum_carry(build_up);
-    if (build_up[7] & ~0xffff)
-      overflow= 1;
-  }
-
-  /* scale up to SQL_DESC_SCALE */
-  if (reqscale > 0 && reqscale > sqlnum->scale)
-  {
-    while (reqscale > sqlnum->scale)
-    {
-      sqlnum_scale(build_up, 1);
-      sqlnum_carry(build_up);
-      ++sqlnum->scale;
+      if (!value.mul_add(10, 0))
+      {
+        overflow= 1;
+        goto end;
+      }
+      ++scale;
     }
   }
-  /* scale back, truncating decimals */
-  else if (reqscale < sqlnum->scale)
+  else if (reqscale < scale)
   {
-    while (reqscale < sqlnum->scale && sqlnum->scale > 0)
+    while (reqscale < scale && scale > 0)
     {
-      sqlnum_unscale_le(build_up);
-
-      // Value 2 of overflow indicates truncation, not critical
-      if (build_up[0] % 10)
-        overflow = 2;
-
-      build_up[0] /= 10;
-      --sqlnum->precision;
-      --sqlnum->scale;
+      if (value.divmod(10))
+        overflow= 2;
+      --precision;
+      --scale;
     }
   }
 
-  /* scale back whole numbers while there's no significant digits */
-  if (reqscale < 0)
+  /* negative scale only drops zeros, anything else is out of range */
+  while (reqscale < scale)
   {
-    memcpy(tmp_prec_calc, build_up, sizeof(build_up));
-    while (reqscale < sqlnum->scale)
+    sqlnum_uint128 tmp= value;
+    if (tmp.divmod(10))
     {
-      sqlnum_unscale_le(tmp_prec_calc);
-      if (tmp_prec_calc[0] % 10)
-      {
-        overflow= 1;
-        goto end;
-      }
-      sqlnum_unscale_le(build_up);
-      tmp_prec_calc[0] /= 10;
-      build_up[0] /= 10;
-      --sqlnum->precision;
-      --sqlnum->scale;
+      overflow= 1;
+      goto end;
     }
+    value= tmp;
+    --precision;
+    --scale;
   }
 
   /* calculate minimum precision */
-  memcpy(tmp_prec_calc, build_up, sizeof(build_up));
-
   {
-    SQLCHAR temp_precision = sqlnum->precision;
+    sqlnum_uint128 tmp= value;
+    SQLCHAR temp_precision= precision;
+    uint32 digit;
 
     do
     {
-      sqlnum_unscale_le(tmp_prec_calc);
-      i= tmp_prec_calc[0] % 10;
-      tmp_prec_calc[0] /= 10;
-      if (i == 0)
+      digit= tmp.divmod(10);
+      if (digit == 0)
         --temp_precision;
-    } while (i == 0 && temp_precision > 0);
+    } while (digit == 0 && temp_precision > 0);
 
     /* detect precision overflow */
     if (temp_precision > reqprec)
       overflow= 1;
   }
 
-  /* compress results into SQL_NUMERIC_STRUCT.val */
-  for (i= 0; i < 8; ++i)
-  {
-    int elem= 2 * i;
-    sqlnum->val[elem]= build_up[i] & 0xff;
-    sqlnum->val[elem+1]= (build_up[i] >> 8) & 0xff;
-  }
+  value.to_bytes(sqlnum->val);
 
 end:
+  sqlnum->precision= precision;
+  sqlnum->scale= scale;
   if (overflow_ptr)
     *overflow_ptr= overflow;
 }
 
 
+/**
+  Retrieve a SQL_NUMERIC_STRUCT from a string. The requested scale
+  and precesion are first read from sqlnum, and then updated values
+  are written back at the end.
+
+  The digits are accumulated nine at a time into a 128-bit value, which
+  is then scaled as requested. Fractional digits beyond the requested
+  scale are dropped while parsing. Parsing stops at the first character
+  that is not a digit or the (first) decimal point, so the string does
+  not need to be null-terminated.
+
+  @param[in] numstr       String representation of number to convert
+  @param[in] len          Length of numstr
+  @param[in] sqlnum       Destination struct
+  @param[in] overflow_ptr Whether or not whole-number overflow occurred.
+                          This indicates failure, and the result of sqlnum
+                          is undefined.
+*/
+void sqlnum_from_str(const char *numstr, size_t len,
+                     SQL_NUMERIC_STRUCT *sqlnum, int *overflow_ptr)
+{
+  const char *end= numstr + len;
+  sqlnum_uint128 value;
+  bool negative= numstr < end && *numstr == '-';
+  bool decpt= false, truncated= false;
+  int precision= 0, scale= 0;
+  int maxscale= sqlnum->scale > 0 ? sqlnum->scale : 0;
+  uint32 chunk= 0;
+  int chunk_digits= 0;
+
+  if (negative)
+    ++numstr;
+
+  for (; numstr < end; ++numstr)
+  {
+    unsigned digit= (unsigned char)*numstr - '0';
+
+    if (digit > 9)
+    {
+      if (*numstr == '.' && !decpt)
+      {
+        decpt= true;
+        continue;
+      }
+      break;
+    }
+
+    if (decpt)
+    {
+      /* the digit would be truncated by the scaling anyway */
+      if (scale == maxscale)
+      {
+        truncated|= digit != 0;
+        continue;
+      }
+      ++scale;
+    }
+
+    chunk= chunk * 10 + digit;
+    ++precision;
+
+    if (++chunk_digits == SQLNUM_CHUNK_DIGITS)
+    {
+      if (!value.mul_add(SQLNUM_CHUNK_BASE, chunk))
+        goto overflow;
+      chunk= 0;
+      chunk_digits= 0;
+    }
+  }
+
+  if (chunk_digits)
+  {
+    uint32 mul= 10;
+    while (--chunk_digits)
+      mul *= 10;
+    if (!value.mul_add(mul, chunk))
+      goto overflow;
+  }
+
+  sqlnum_from_value(sqlnum, value, negative, (SQLCHAR)precision,
+                    (SQLSCHAR)scale, truncated, overflow_ptr);
+  return;
+
+overflow:
+  memset(&sqlnum->val, 0, sizeof(sqlnum->val));
+  sqlnum->sign= !negative;
+  if (overflow_ptr)
+    *overflow_ptr= 1;
+}
+
+
+void sqlnum_from_str(const char *numstr, SQL_NUMERIC_STRUCT *sqlnum,
+                     int *overflow_ptr)
+{
+  sqlnum_from_str(numstr, strlen(numstr), sqlnum, overflow_ptr);
+}
+
+
+/**
+  Retrieve a SQL_NUMERIC_STRUCT from an integer, without formatting it
+  as a string first. Has the same semantics as sqlnum_from_str() on the
+  decimal representation of the number.
+
+  @param[in] magnitude    Absolute value of the number
+  @param[in] negative     Whether the number is negative
+  @param[in] sqlnum       Destination struct
+  @param[in] overflow_ptr See sqlnum_from_str()
+*/
+void sqlnum_from_int(unsigned long long magnitude, bool negative,
+                     SQL_NUMERIC_STRUCT *sqlnum, int *overflow_ptr)
+{
+  sqlnum_uint128 value;
+  int precision= 1;
+
+  for (unsigned long long rest= magnitude / 10; rest; rest /= 10)
+    ++precision;
+
+  value.mul_add(1, (uint32)(magnitude >> 32));
+  value.mul_add(0x10000, 0);
+  value.mul_add(0x10000, (uint32)(magnitude & 0xffffffff));
+
+  sqlnum_from_value(sqlnum, value, negative, (SQLCHAR)precision, 0, false,
+                    overflow_ptr);
+}
+
+
 /**
   Convert a SQL_NUMERIC_STRUCT to a string. Only val and sign are
   read from the struct. precision and scale will be updated on the
@@ -2813,57 +3031,40 @@ void sqlnum_to_str(SQL_NUMERIC_STRUCT *sqlnum, SQLCHAR *numstr,
                    SQLCHAR **numbegin, SQLCHAR reqprec, SQLSCHAR reqscale,
                    int *truncptr)
 {
-  unsigned expanded[8];
-  int i, j;
-  int max_space= 0;
+  sqlnum_uint128 value;
+  SQLCHAR *last;
   int calcprec= 0;
   int trunc= 0; /* truncation indicator */
 
   *numstr--= 0;
+  last= numstr;
 
   /*
      it's expected to have enough space
      (~at least min(39, max(prec, scale+2)) + 3)
   */
 
-  /*
-     expand the packed sqlnum->val so we have space to divide through
-     expansion happens into an array in big-endian form
-  */
-  for (i= 0; i < 8; ++i)
-    expanded[7 - i]= (sqlnum->val[(2 * i) + 1] << 8) | sqlnum->val[2 * i];
+  value.from_bytes(sqlnum->val);
 
-  /* max digits = 39 = log_10(2^128)+1 */
-  for (j= 0; j < 39; ++j)
+  if (value.is_zero())
   {
-    /* skip empty prefix */
-    while (!expanded[max_space])
-      ++max_space;
-    /* if only the last piece has a value, it's the end */
-    if (max_space >= 7)
-    {
-      i= 7;
-      if (!expanded[7])
-      {
-        /* special case for zero, we'll end immediately */
-        if (!*(numstr + 1))
-        {
-          *numstr--= '0';
-          calcprec= 1;
-        }
-        break;
-      }
-    }
-    else
+    *numstr--= '0';
+    calcprec= 1;
+  }
+
+  /* extract the digits nine at a time, from the least significant */
+  while (!value.is_zero())
+  {
+    uint32 chunk= value.divmod(SQLNUM_CHUNK_BASE);
+    bool more= !value.is_zero();
+
+    for (int i= 0; i < SQLNUM_CHUNK_DIGITS && (chunk || more); ++i)
     {
-      /* extract the next digit */
-      sqlnum_unscale_be(expanded, max_space);
+      *numstr--= '0' + (chunk % 10);
+      chunk /= 10;
+      if (++calcprec == reqscale)
+        *numstr--= '.';
     }
-    *numstr--= '0' + (expanded[7] % 10);
-    expanded[7] /= 10;
-    ++calcprec;
-    if (j == reqscale - 1)
-      *numstr--= '.';
   }
 
   sqlnum->scale= reqscale;
@@ -2883,7 +3084,7 @@ void sqlnum_to_str(SQL_NUMERIC_STRUCT *sqlnum, SQLCHAR *numstr,
   /* handle fractional truncation */
   if (calcprec > reqprec && reqscale > 0)
   {
-    SQLCHAR *end= numstr + strlen((char *)numstr) - 1;
+    SQLCHAR *end= last;
     while (calcprec > reqprec && reqscale)
     {
       *end--= 0;
@@ -2899,21 +3100,6 @@ void sqlnum_to_str(SQL_NUMERIC_STRUCT *sqlnum, SQLCHAR *numstr,
     {
       *end--= '\0';
     }
-    else
-    {
-      /* move the dec pt-- ??? */
-      /*
-      char c2, c= numstr[calcprec - reqscale];
-      numstr[calcprec - reqscale]= '.';
-      while (reqscale)
-      {
-        c2= numstr[calcprec + 1 - reqscale];
-        numstr[calcprec + 1 - reqscale]= c;
-        c= c2;
-        --reqscale;
-      }
-      */
-    }
     trunc= SQLNUM_TRUNC_FRAC;
   }
 
@@ -3828,6 +4014,17 @@ void tempBuf::reset()
   cur_pos = 0;
 }
 
+/* Frees the buffer if it grew beyond max_len bytes */
+void tempBuf::shrink(size_t max_len)
+{
+  if (buf_len <= max_len)
+    return;
+
+  free(buf);
+  buf = nullptr;
+  buf_len = cur_pos = 0;
+}
+
 tempBuf::~tempBuf()
 {
   if (buf_len && buf)
@@ -70,9 +70,9 @@ SQLWSTRING mytest(HWND hwnd, DataSource *params)
   {
     // Use the ability of optionStr to convert MBchar -> Wchar
     optionStr e_msg;
-    e_msg = e.message;
+    e_msg = e.message();
     optionStr e_sqlstate;
-    e_sqlstate = e.sqlstate;
+    e_sqlstate = std::string(e.sqlstate);
 
     msg = _W(L"Connection failed with the following error:\n");
     msg.append((const SQLWSTRING &)e_msg);
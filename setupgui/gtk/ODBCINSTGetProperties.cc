@@ -46,7 +46,21 @@ static const char *MYODBC_OPTIONS[][3] = {
   {"SOCKET",            "T", "The Unix socket file if SERVER=localhost"},
   {"INITSTMT",          "T", "Initial statement executed at the connecting time"},
   {"CHARSET",           "T", "The character set to use for the connection"},
+  {"COMPRESSION-ALGORITHMS", "T", "Compression algorithms the connection may use, e.g. zstd,zlib,uncompressed"},
+  {"ZSTD-COMPRESSION-LEVEL", "T", "Compression level for the zstd algorithm, from 1 to 22"},
   {"PREFETCH",          "T", "Prefecth from server by N rows at a time"},
+  {"MAX_LOB_BUFFER",    "T", "Bytes of a LOB value kept in memory between rows"},
+  {"PING_INTERVAL",     "T", "Seconds of inactivity after which a connection check pings the server"},
+  {"POOL_MIN_IDLE",     "T", "Idle pooled sessions kept open regardless of how long they wait"},
+  {"POOL_MAX_IDLE",     "T", "Maximum number of idle pooled sessions per connection string"},
+  {"POOL_MAX_LIFETIME", "T", "Seconds after which a pooled session is closed instead of reused"},
+  {"PIPELINE_WINDOW",   "T", "Sets of an array of parameters sent to the server in one round trip"},
+  {"BULK_LOAD_ROWS",    "T", "Parameter sets from which an INSERT array is sent with LOAD DATA LOCAL INFILE, outside strict SQL mode and into tables without unique keys"},
+  {"RESULT_CACHE_TTL",  "T", "Seconds the results of read-only queries are answered from a client-side cache"},
+  {"RESULT_CACHE_SIZE", "T", "Bytes of query results the client-side cache keeps for the process"},
+  {"MEMORY_SOFT_LIMIT", "T", "Bytes held by the statements of a connection from which forward-only results are read as fetched, as with NO_CACHE, and nothing else runs on the connection until they are read"},
+  {"MEMORY_HARD_LIMIT", "T", "Bytes the statements of a connection may hold; results are read row by row and fail with HY001 past it"},
+  {"PERF_DUMP_INTERVAL", "T", "Seconds between writes of the performance counters to the query log"},
   {"READTIMEOUT",       "T", "The timeout in seconds for attempts to read from the server"},
   {"WRITETIMEOUT",      "T", "The timeout in seconds for attempts to write to the server"},
   {"SSLCA",             "F", "The path to a file with a list of trust SSL CAs"},
@@ -77,6 +91,9 @@ static const char *MYODBC_OPTIONS[][3] = {
   {"AUTO_RECONNECT",    "C", "Enable automatic reconnect"},
   {"ENABLE_DNS_SRV",    "C", "Enable usage of DNS SRV records"},
   {"MULTI_HOST",        "C", "Enable usage of multiple hosts"},
+  {"POOLING",           "C", "Keep disconnected sessions open for reuse by the driver"},
+  {"PIPELINE_STOP_ON_ERROR", "C", "Stop executing an array of parameters at the first failing set"},
+  {"PERF_COUNTERS",     "C", "Keep performance counters of the connection"},
   {"AUTO_IS_NULL",      "C", "Enable SQL_AUTO_IS_NULL"},
   {"ZERO_DATE_TO_MIN",  "C", "Return SQL_NULL_DATA for zero date"},
   {"MIN_DATE_TO_ZERO",  "C", "Bind minimal date as zero date"},
@@ -1898,6 +1898,246 @@ DECLARE_TEST(t_bug36605973_sqlconnect_params)
 
   return OK;
 }
+/*
+  Pool reset keeps the physical connection, clears the session state and
+  applies INITSTMT again.
+*/
+DECLARE_TEST(t_reset_connection)
+{
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+  SQLINTEGER id_before, id_after;
+  SQLUINTEGER dead= SQL_CD_TRUE;
+  SQLRETURN rc;
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL,
+                                        "INITSTMT=SET @init_var=7"));
+
+  ok_sql(hstmt1, "SET @session_var=5");
+  ok_sql(hstmt1, "SELECT CONNECTION_ID()");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  id_before= my_fetch_int(hstmt1, 1);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  rc= SQLSetConnectAttr(hdbc1, SQL_ATTR_RESET_CONNECTION,
+                        (SQLPOINTER)SQL_RESET_CONNECTION_YES, 0);
+  if (!SQL_SUCCEEDED(rc))
+  {
+    free_basic_handles(&henv1, &hdbc1, &hstmt1);
+    skip("Driver manager does not pass SQL_ATTR_RESET_CONNECTION");
+  }
+
+  /* This is how the driver manager checks a connection taken from pool */
+  ok_con(hdbc1, SQLGetConnectAttr(hdbc1, SQL_ATTR_CONNECTION_DEAD, &dead,
+                                  0, NULL));
+  is_num(dead, SQL_CD_FALSE);
+
+  ok_stmt(hstmt1, SQLAllocHandle(SQL_HANDLE_STMT, hdbc1, &hstmt1));
+  ok_sql(hstmt1, "SELECT CONNECTION_ID(), @session_var IS NULL, @init_var");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  id_after= my_fetch_int(hstmt1, 1);
+  is_num(id_after, id_before);
+  is_num(my_fetch_int(hstmt1, 2), 1);
+  is_num(my_fetch_int(hstmt1, 3), 7);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  return OK;
+}
+
+
+/*
+  With POOLING the driver keeps the session of a disconnected connection
+  and hands it to the next connect with the same connection string.
+*/
+DECLARE_TEST(t_driver_pool)
+{
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+  SQLINTEGER id_before, id_after;
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL,
+                                        "POOLING=1;INITSTMT=SET @init_var=7"));
+
+  ok_sql(hstmt1, "SET @session_var=5");
+  ok_sql(hstmt1, "SELECT CONNECTION_ID()");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  id_before= my_fetch_int(hstmt1, 1);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  ok_con(hdbc1, SQLDisconnect(hdbc1));
+  ok_con(hdbc1, get_connection(&hdbc1, NULL, NULL, NULL, NULL,
+                               "POOLING=1;INITSTMT=SET @init_var=7"));
+
+  /* The session is the same one, but reset */
+  ok_con(hdbc1, SQLAllocHandle(SQL_HANDLE_STMT, hdbc1, &hstmt1));
+  ok_sql(hstmt1, "SELECT CONNECTION_ID(), @session_var IS NULL, @init_var");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  id_after= my_fetch_int(hstmt1, 1);
+  is_num(id_after, id_before);
+  is_num(my_fetch_int(hstmt1, 2), 1);
+  is_num(my_fetch_int(hstmt1, 3), 7);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  /* Attributes set before connecting are part of the pool key */
+  ok_stmt(hstmt1, SQLFreeHandle(SQL_HANDLE_STMT, hstmt1));
+  ok_con(hdbc1, SQLDisconnect(hdbc1));
+  ok_con(hdbc1, SQLSetConnectAttr(hdbc1, SQL_ATTR_AUTOCOMMIT,
+                                  (SQLPOINTER)SQL_AUTOCOMMIT_OFF, 0));
+  ok_con(hdbc1, get_connection(&hdbc1, NULL, NULL, NULL, NULL,
+                               "POOLING=1;INITSTMT=SET @init_var=7"));
+
+  ok_con(hdbc1, SQLAllocHandle(SQL_HANDLE_STMT, hdbc1, &hstmt1));
+  ok_sql(hstmt1, "SELECT CONNECTION_ID(), @@autocommit");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is(my_fetch_int(hstmt1, 1) != id_before);
+  is_num(my_fetch_int(hstmt1, 2), 0);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+  ok_con(hdbc1, SQLEndTran(SQL_HANDLE_DBC, hdbc1, SQL_ROLLBACK));
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  return OK;
+}
+
+
+/*
+  The session is set up with one SET statement, which also turns on
+  schema tracking so that the current catalog is known without asking
+  the server.
+*/
+DECLARE_TEST(t_session_setup)
+{
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+  SQLCHAR buf[64], db[64], use[80];
+  SQLINTEGER len;
+
+  is(OK == alloc_basic_handles(&henv1, &hdbc1, &hstmt1));
+
+  ok_sql(hstmt1, "SELECT @@autocommit, DATABASE()");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_num(my_fetch_int(hstmt1, 1), 1);
+  my_fetch_str(hstmt1, db, 2);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  /* USE run as a statement is seen by SQL_ATTR_CURRENT_CATALOG */
+  ok_sql(hstmt1, "DROP DATABASE IF EXISTS t_session_setup");
+  ok_sql(hstmt1, "CREATE DATABASE t_session_setup");
+  ok_sql(hstmt1, "USE t_session_setup");
+  ok_con(hdbc1, SQLGetConnectAttr(hdbc1, SQL_ATTR_CURRENT_CATALOG, buf,
+                                  sizeof(buf), &len));
+  is_num(len, 15);
+  is_str(buf, "t_session_setup", 15);
+
+  sprintf((char *)use, "USE `%s`", (char *)db);
+  ok_sql(hstmt1, use);
+  ok_con(hdbc1, SQLGetConnectAttr(hdbc1, SQL_ATTR_CURRENT_CATALOG, buf,
+                                  sizeof(buf), &len));
+  is_str(buf, db, strlen((char *)db) + 1);
+  ok_sql(hstmt1, "DROP DATABASE IF EXISTS t_session_setup");
+
+  /* Autocommit and isolation set before connecting are in effect */
+  ok_stmt(hstmt1, SQLFreeHandle(SQL_HANDLE_STMT, hstmt1));
+  ok_con(hdbc1, SQLDisconnect(hdbc1));
+  ok_con(hdbc1, SQLSetConnectAttr(hdbc1, SQL_ATTR_AUTOCOMMIT,
+                                  (SQLPOINTER)SQL_AUTOCOMMIT_OFF, 0));
+  ok_con(hdbc1, SQLSetConnectAttr(hdbc1, SQL_ATTR_TXN_ISOLATION,
+                                  (SQLPOINTER)SQL_TXN_READ_COMMITTED, 0));
+  ok_con(hdbc1, get_connection(&hdbc1, NULL, NULL, NULL, NULL, NULL));
+  ok_con(hdbc1, SQLAllocHandle(SQL_HANDLE_STMT, hdbc1, &hstmt1));
+
+  ok_sql(hstmt1, "SELECT @@autocommit, @@session.transaction_isolation");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_num(my_fetch_int(hstmt1, 1), 0);
+  is_str(my_fetch_str(hstmt1, buf, 2), "READ-COMMITTED", 14);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+  ok_con(hdbc1, SQLEndTran(SQL_HANDLE_DBC, hdbc1, SQL_ROLLBACK));
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  return OK;
+}
+
+
+/*
+  Statement handles dropped and allocated again come from the connection's
+  free list. They must not carry over anything from their previous use.
+*/
+DECLARE_TEST(t_stmt_reuse)
+{
+  SQLHSTMT hstmt1;
+  SQLULEN array_size= 0, max_rows= 1;
+  SQLINTEGER value= 0;
+  SQLSMALLINT params= -1;
+  SQLCHAR name[32];
+  int i;
+
+  for (i= 0; i < 3; ++i)
+  {
+    ok_con(hdbc, SQLAllocHandle(SQL_HANDLE_STMT, hdbc, &hstmt1));
+
+    ok_stmt(hstmt1, SQLGetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE,
+                                   &array_size, 0, NULL));
+    is_num(array_size, 1);
+    ok_stmt(hstmt1, SQLGetStmtAttr(hstmt1, SQL_ATTR_MAX_ROWS,
+                                   &max_rows, 0, NULL));
+    is_num(max_rows, 0);
+    ok_stmt(hstmt1, SQLNumParams(hstmt1, &params));
+    is_num(params, 0);
+    ok_stmt(hstmt1, SQLGetCursorName(hstmt1, name, sizeof(name), NULL));
+    is(strcmp((char *)name, "reused") != 0);
+
+    ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE,
+                                   (SQLPOINTER)5, 0));
+    ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_MAX_ROWS,
+                                   (SQLPOINTER)2, 0));
+    ok_stmt(hstmt1, SQLSetCursorName(hstmt1, (SQLCHAR *)"reused", SQL_NTS));
+    ok_stmt(hstmt1, SQLBindParameter(hstmt1, 1, SQL_PARAM_INPUT, SQL_C_LONG,
+                                     SQL_INTEGER, 0, 0, &value, 0, NULL));
+    ok_stmt(hstmt1, SQLPrepare(hstmt1, (SQLCHAR *)"SELECT ?", SQL_NTS));
+    ok_stmt(hstmt1, SQLExecute(hstmt1));
+
+    /* Dropped with the cursor still open */
+    ok_stmt(hstmt1, SQLFreeHandle(SQL_HANDLE_STMT, hstmt1));
+  }
+
+  return OK;
+}
+
+
+/*
+  A host that doesn't answer must not hold up a MULTI_HOST connect until
+  the connect timeout: the next host is tried in parallel.
+*/
+DECLARE_TEST(t_multi_host_unreachable)
+{
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+  SQLCHAR options[512];
+  time_t start;
+
+  if (mysock && mysock[0])
+    skip("The test needs a TCP connection");
+
+  /* 192.0.2.1 is reserved for documentation, nothing answers there */
+  snprintf((char*)options, sizeof(options),
+           "MULTI_HOST=1;SERVER=192.0.2.1:3306,%s:%d", (char*)myserver,
+           myport ? myport : 3306);
+
+  start= time(NULL);
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL, options));
+  is(time(NULL) - start < 10);
+
+  ok_sql(hstmt1, "SELECT 1");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_num(my_fetch_int(hstmt1, 1), 1);
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  return OK;
+}
+
 
 BEGIN_TESTS
   ADD_TEST(t_bug36605973_sqlconnect_params)
@@ -1937,6 +2177,11 @@ BEGIN_TESTS
   ADD_TEST(t_bug63844)
   ADD_TEST(t_bug52996)
   ADD_TEST(t_ssl_align)
+  ADD_TEST(t_reset_connection)
+  ADD_TEST(t_driver_pool)
+  ADD_TEST(t_session_setup)
+  ADD_TEST(t_stmt_reuse)
+  ADD_TEST(t_multi_host_unreachable)
   END_TESTS
 
 
@@ -891,6 +891,176 @@ DECLARE_TEST(t_bug_29282638)
   return OK;
 }
 
+/*
+  Reading large values piece by piece with SQLGetData() from a prepared
+  statement, also leaving some of them untouched.
+*/
+DECLARE_TEST(t_blob_getdata_chunks)
+{
+  SQLCHAR  buf[4096], txt[16];
+  SQLINTEGER id;
+  SQLLEN   len, total, expected;
+  SQLRETURN rc;
+  int      row;
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_blob_getdata_chunks");
+  ok_sql(hstmt, "CREATE TABLE t_blob_getdata_chunks "
+                "(id INT, b LONGBLOB, t MEDIUMTEXT)");
+  ok_sql(hstmt, "INSERT INTO t_blob_getdata_chunks VALUES "
+                "(1, REPEAT('0123456789', 30000), REPEAT('a', 70000)),"
+                "(2, REPEAT('0123456789', 30001), REPEAT('b', 70000)),"
+                "(3, REPEAT('0123456789', 30002), REPEAT('c', 70000)),"
+                "(4, REPEAT('0123456789', 30003), REPEAT('d', 70000)),"
+                "(5, REPEAT('0123456789', 30004), REPEAT('e', 70000))");
+
+  ok_stmt(hstmt, SQLPrepare(hstmt, (SQLCHAR *)
+          "SELECT id, b, t FROM t_blob_getdata_chunks ORDER BY id", SQL_NTS));
+  ok_stmt(hstmt, SQLBindCol(hstmt, 1, SQL_C_LONG, &id, 0, NULL));
+  ok_stmt(hstmt, SQLExecute(hstmt));
+
+  for (row= 1; row <= 5; ++row)
+  {
+    ok_stmt(hstmt, SQLFetch(hstmt));
+    is_num(id, row);
+    expected= 300000 + (row - 1) * 10;
+
+    /* Every other row leaves the large columns alone */
+    if (row % 2 == 0)
+      continue;
+
+    total= 0;
+    while ((rc= SQLGetData(hstmt, 2, SQL_C_BINARY, buf, sizeof(buf), &len))
+           != SQL_NO_DATA)
+    {
+      SQLLEN got= len > (SQLLEN)sizeof(buf) ? (SQLLEN)sizeof(buf) : len;
+      SQLLEN i;
+
+      is(SQL_SUCCEEDED(rc));
+      is_num(len, expected - total);
+      for (i= 0; i < got; ++i)
+        is_num(buf[i], '0' + (total + i) % 10);
+      total+= got;
+    }
+    is_num(total, expected);
+
+    expect_stmt(hstmt, SQLGetData(hstmt, 3, SQL_C_CHAR, txt, sizeof(txt),
+                                  &len), SQL_SUCCESS_WITH_INFO);
+    is_num(len, 70000);
+    is_num(txt[0], 'a' + row - 1);
+    is_num(txt[sizeof(txt) - 1], '\0');
+
+    /* The rest of the text comes in null terminated pieces */
+    total= sizeof(txt) - 1;
+    while ((rc= SQLGetData(hstmt, 3, SQL_C_CHAR, buf, sizeof(buf), &len))
+           != SQL_NO_DATA)
+    {
+      SQLLEN got= len >= (SQLLEN)sizeof(buf) ? (SQLLEN)sizeof(buf) - 1 : len;
+
+      is(SQL_SUCCEEDED(rc));
+      is_num(len, 70000 - total);
+      is_num(buf[0], 'a' + row - 1);
+      is_num(buf[got - 1], 'a' + row - 1);
+      is_num(buf[got], '\0');
+      total+= got;
+    }
+    is_num(total, 70000);
+  }
+
+  expect_stmt(hstmt, SQLFetch(hstmt), SQL_NO_DATA);
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_UNBIND));
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_blob_getdata_chunks");
+
+  return OK;
+}
+
+/*
+  Data-at-exec values put in many chunks. With server side prepared
+  statements the binary and character ones are streamed to the server,
+  a surrogate pair and single bytes split over chunks must survive that.
+*/
+DECLARE_TEST(t_putdata_stream)
+{
+  SQLCHAR    chunk[4096], id[]= "7", buf[64];
+  SQLWCHAR   w[4];
+  SQLLEN     b_len= SQL_DATA_AT_EXEC, t_len= SQL_DATA_AT_EXEC,
+             id_len= SQL_DATA_AT_EXEC;
+  SQLPOINTER token;
+  SQLRETURN  rc;
+  size_t     wsize;
+  int        i, j;
+
+  if (sizeof(SQLWCHAR) == 2)
+  {
+    w[0]= 'a'; w[1]= 0xd83d; w[2]= 0xde00; w[3]= 'b';
+    wsize= 4 * sizeof(SQLWCHAR);
+  }
+  else
+  {
+    w[0]= 'a'; w[1]= (SQLWCHAR)0x1f600; w[2]= 'b';
+    wsize= 3 * sizeof(SQLWCHAR);
+  }
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_putdata_stream");
+  ok_sql(hstmt, "CREATE TABLE t_putdata_stream (b LONGBLOB, "
+                "t LONGTEXT CHARACTER SET utf8mb4, id INT)");
+
+  ok_stmt(hstmt, SQLPrepare(hstmt, (SQLCHAR *)
+          "INSERT INTO t_putdata_stream VALUES (?, ?, ?)", SQL_NTS));
+  ok_stmt(hstmt, SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_BINARY,
+                                  SQL_LONGVARBINARY, 0, 0, (SQLPOINTER)1,
+                                  0, &b_len));
+  ok_stmt(hstmt, SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT, SQL_C_WCHAR,
+                                  SQL_WLONGVARCHAR, 0, 0, (SQLPOINTER)2,
+                                  0, &t_len));
+  ok_stmt(hstmt, SQLBindParameter(hstmt, 3, SQL_PARAM_INPUT, SQL_C_CHAR,
+                                  SQL_INTEGER, 0, 0, (SQLPOINTER)3,
+                                  0, &id_len));
+
+  expect_stmt(hstmt, SQLExecute(hstmt), SQL_NEED_DATA);
+
+  while ((rc= SQLParamData(hstmt, &token)) == SQL_NEED_DATA)
+  {
+    switch ((size_t)token)
+    {
+    case 1:
+      for (i= 0; i < 64; ++i)
+      {
+        for (j= 0; j < (int)sizeof(chunk); ++j)
+          chunk[j]= '0' + (i + j) % 10;
+        ok_stmt(hstmt, SQLPutData(hstmt, chunk, sizeof(chunk)));
+      }
+      break;
+    case 2:
+      for (i= 0; i < (int)wsize; ++i)
+        ok_stmt(hstmt, SQLPutData(hstmt, (SQLCHAR *)w + i, 1));
+      break;
+    case 3:
+      ok_stmt(hstmt, SQLPutData(hstmt, id, SQL_NTS));
+      break;
+    default:
+      return FAIL;
+    }
+  }
+  ok_stmt(hstmt, rc);
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_RESET_PARAMS));
+
+  ok_sql(hstmt, "SELECT id, LENGTH(b), SUBSTRING(b, 4095, 4), HEX(t) "
+                "FROM t_putdata_stream");
+  ok_stmt(hstmt, SQLFetch(hstmt));
+  is_num(my_fetch_int(hstmt, 1), 7);
+  is_num(my_fetch_int(hstmt, 2), 64 * sizeof(chunk));
+  is_str(my_fetch_str(hstmt, buf, 3), "4512", 4);
+  is_str(my_fetch_str(hstmt, buf, 4), "61F09F988062", 12);
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_putdata_stream");
+
+  return OK;
+}
+
+
 BEGIN_TESTS
   ADD_TEST(t_bug_29282638)
   ADD_TEST(t_blob)
@@ -899,12 +1069,14 @@ BEGIN_TESTS
   ADD_TEST(t_putdata1)
   ADD_TEST(t_putdata2)
   ADD_TEST(t_putdata3)
+  ADD_TEST(t_putdata_stream)
   ADD_TEST(t_blob_bug)
   ADD_TEST(t_text_fetch)
   ADD_TEST(getdata_lenonly)
   ADD_TEST(t_bug9781)
   ADD_TEST(t_bug10562)
   ADD_TEST(t_bug_11746572)
+  ADD_TEST(t_blob_getdata_chunks)
 END_TESTS
 
 
@@ -3418,6 +3418,53 @@ DECLARE_TEST(t_18805455)
 }
 
 
+/*
+  Cursor names are unique within a connection, and found again without
+  regard to case.
+*/
+DECLARE_TEST(t_duplicate_cursor_name)
+{
+  SQLHSTMT hstmt1;
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_dup_cursor");
+  ok_sql(hstmt, "CREATE TABLE t_dup_cursor (id INT PRIMARY KEY, val INT)");
+  ok_sql(hstmt, "INSERT INTO t_dup_cursor VALUES (1, 10), (2, 20)");
+
+  ok_con(hdbc, SQLAllocHandle(SQL_HANDLE_STMT, hdbc, &hstmt1));
+
+  ok_stmt(hstmt, SQLSetCursorName(hstmt, (SQLCHAR *)"dup_cur", SQL_NTS));
+  expect_stmt(hstmt1, SQLSetCursorName(hstmt1, (SQLCHAR *)"DUP_CUR", SQL_NTS),
+              SQL_ERROR);
+  is_num(check_sqlstate(hstmt1, "3C000"), OK);
+
+  /* Setting the same name again on the same statement is fine */
+  ok_stmt(hstmt, SQLSetCursorName(hstmt, (SQLCHAR *)"dup_cur", SQL_NTS));
+
+  ok_stmt(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE,
+                                (SQLPOINTER)SQL_CURSOR_STATIC, 0));
+  ok_sql(hstmt, "SELECT * FROM t_dup_cursor ORDER BY id");
+  ok_stmt(hstmt, SQLFetch(hstmt));
+
+  ok_sql(hstmt1, "UPDATE t_dup_cursor SET val = 11 WHERE CURRENT OF Dup_Cur");
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+  ok_sql(hstmt, "SELECT val FROM t_dup_cursor WHERE id = 1");
+  ok_stmt(hstmt, SQLFetch(hstmt));
+  is_num(my_fetch_int(hstmt, 1), 11);
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+  /* The name is free again once its statement is dropped */
+  ok_stmt(hstmt1, SQLSetCursorName(hstmt1, (SQLCHAR *)"other_cur", SQL_NTS));
+  ok_stmt(hstmt1, SQLFreeHandle(SQL_HANDLE_STMT, hstmt1));
+  ok_con(hdbc, SQLAllocHandle(SQL_HANDLE_STMT, hdbc, &hstmt1));
+  ok_stmt(hstmt1, SQLSetCursorName(hstmt1, (SQLCHAR *)"other_cur", SQL_NTS));
+  ok_stmt(hstmt1, SQLFreeHandle(SQL_HANDLE_STMT, hstmt1));
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_dup_cursor");
+  return OK;
+}
+
+
 BEGIN_TESTS
   ADD_TEST(my_positioned_cursor)
   ADD_TEST(my_setpos_cursor)
@@ -3468,6 +3515,7 @@ BEGIN_TESTS
   ADD_TEST(t_bug39961)
   ADD_TEST(t_bug41946)
   ADD_TEST(t_18805455)
+  ADD_TEST(t_duplicate_cursor_name)
   /*ADD_TEST(t_sqlputdata)*/
 END_TESTS
 
@@ -1431,6 +1431,61 @@ DECLARE_TEST(t_date_overflow)
 
 
 
+/*
+  Canonical server values take the fixed-format parsing path, anything
+  else still goes through the generic one.
+*/
+DECLARE_TEST(t_datetime_text_formats)
+{
+  SQL_TIMESTAMP_STRUCT ts;
+  SQL_DATE_STRUCT d;
+  SQL_TIME_STRUCT t;
+
+  ok_sql(hstmt, "SELECT CAST('2021-03-04 05:06:07.25' AS DATETIME(6)),"
+                "'2021-03-04T05:06:07', CAST('2021-03-04' AS DATE),"
+                "CAST('12:34:56' AS TIME), '1:2:3'");
+  ok_stmt(hstmt, SQLFetch(hstmt));
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 1, SQL_C_TYPE_TIMESTAMP, &ts, 0, NULL));
+  is_num(ts.year, 2021);
+  is_num(ts.month, 3);
+  is_num(ts.day, 4);
+  is_num(ts.hour, 5);
+  is_num(ts.minute, 6);
+  is_num(ts.second, 7);
+  is_num(ts.fraction, 250000000);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 2, SQL_C_TYPE_TIMESTAMP, &ts, 0, NULL));
+  is_num(ts.year, 2021);
+  is_num(ts.month, 3);
+  is_num(ts.day, 4);
+  is_num(ts.hour, 5);
+  is_num(ts.minute, 6);
+  is_num(ts.second, 7);
+  is_num(ts.fraction, 0);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 3, SQL_C_TYPE_DATE, &d, 0, NULL));
+  is_num(d.year, 2021);
+  is_num(d.month, 3);
+  is_num(d.day, 4);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 4, SQL_C_TYPE_TIME, &t, 0, NULL));
+  is_num(t.hour, 12);
+  is_num(t.minute, 34);
+  is_num(t.second, 56);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 5, SQL_C_TYPE_TIME, &t, 0, NULL));
+  is_num(t.hour, 1);
+  is_num(t.minute, 2);
+  is_num(t.second, 3);
+
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+  return OK;
+}
+
+
+
 BEGIN_TESTS
   // ADD_TEST(t_bug60646)
   ADD_TEST(t_bug37342)
@@ -1455,6 +1510,7 @@ BEGIN_TESTS
   ADD_TEST(t_bug30939)
   ADD_TEST(t_bug60648)
   ADD_TEST(t_b13975271)
+  ADD_TEST(t_datetime_text_formats)
 END_TESTS
 
 
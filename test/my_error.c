@@ -861,6 +861,60 @@ DECLARE_TEST(t_bug25671389)
 }
 
 
+/*
+  Warnings from chunked SQLGetData keep their SQLSTATE and text, and the
+  record and field interfaces see the same message. The fractional
+  truncation warning comes with its text.
+*/
+DECLARE_TEST(t_diag_lazy_message)
+{
+  SQLCHAR     buf[4], state[6], msg[SQL_MAX_MESSAGE_LENGTH];
+  SQLCHAR     field_msg[SQL_MAX_MESSAGE_LENGTH], field_state[6];
+  SQLINTEGER  native;
+  SQLSMALLINT len;
+  SQLINTEGER  num;
+  SQLLEN      ind;
+  int         i;
+
+  ok_sql(hstmt, "SELECT REPEAT('x', 20), 1.25");
+  ok_stmt(hstmt, SQLFetch(hstmt));
+
+  for (i= 0; i < 6; ++i)
+  {
+    expect_stmt(hstmt, SQLGetData(hstmt, 1, SQL_C_CHAR, buf, sizeof(buf),
+                                  &ind), SQL_SUCCESS_WITH_INFO);
+    ok_stmt(hstmt, SQLGetDiagRec(SQL_HANDLE_STMT, hstmt, 1, state, &native,
+                                 msg, sizeof(msg), &len));
+    is_str(state, "01004", 5);
+    is(strstr((char *)msg, "[MySQL][ODBC") == (char *)msg);
+    is_num(len, strlen((char *)msg));
+
+    ok_stmt(hstmt, SQLGetDiagField(SQL_HANDLE_STMT, hstmt, 1,
+                                   SQL_DIAG_MESSAGE_TEXT, field_msg,
+                                   sizeof(field_msg), &len));
+    is_str(field_msg, msg, strlen((char *)msg) + 1);
+    ok_stmt(hstmt, SQLGetDiagField(SQL_HANDLE_STMT, hstmt, 1,
+                                   SQL_DIAG_SQLSTATE, field_state,
+                                   sizeof(field_state), &len));
+    is_str(field_state, "01004", 5);
+  }
+  ok_stmt(hstmt, SQLGetData(hstmt, 1, SQL_C_CHAR, buf, sizeof(buf), &ind));
+  is_num(ind, 2);
+
+  expect_stmt(hstmt, SQLGetData(hstmt, 2, SQL_C_LONG, &num, 0, NULL),
+              SQL_SUCCESS_WITH_INFO);
+  is_num(num, 1);
+  ok_stmt(hstmt, SQLGetDiagRec(SQL_HANDLE_STMT, hstmt, 1, state, &native,
+                               msg, sizeof(msg), &len));
+  is_str(state, "01S07", 5);
+  is(strstr((char *)msg, "Fractional truncation") != NULL);
+
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+  return OK;
+}
+
+
 BEGIN_TESTS
   ADD_TEST(t_passwordexpire)
   ADD_TEST(t_bug13542600)
@@ -892,6 +946,7 @@ BEGIN_TESTS
   ADD_TEST(getdata_need_nullind)
   ADD_TEST(sqlerror)
   ADD_TEST(t_bug27158)
+  ADD_TEST(t_diag_lazy_message)
   // ADD_TOFIX(t_bug49466) TODO: Fix
   // ADD_TEST(t_cleartext_password) TODO: Fix Segfault
 END_TESTS
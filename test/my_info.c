@@ -456,6 +456,50 @@ DECLARE_TEST(t_bug14639)
 }
 
 
+/*
+  SQL_ATTR_CONNECTION_DEAD answers from the connection state and notices
+  a killed connection even when it would not ping the server yet.
+*/
+DECLARE_TEST(t_connection_dead_passive)
+{
+  SQLINTEGER connection_id;
+  SQLUINTEGER is_dead= SQL_CD_TRUE;
+  char buf[100];
+  int i;
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL, "PING_INTERVAL=3600"));
+  ok_sql(hstmt1, "SELECT connection_id()");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  connection_id= my_fetch_int(hstmt1, 1);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  for (i= 0; i < 3; ++i)
+  {
+    ok_con(hdbc1, SQLGetConnectAttr(hdbc1, SQL_ATTR_CONNECTION_DEAD, &is_dead,
+                                    sizeof(is_dead), 0));
+    is_num(is_dead, SQL_CD_FALSE);
+  }
+
+  sprintf(buf, "KILL %d", connection_id);
+  ok_stmt(hstmt, SQLExecDirect(hstmt, (SQLCHAR *)buf, SQL_NTS));
+
+  /* Give the server a moment to close the socket */
+  for (i= 0; i < 10 && is_dead == SQL_CD_FALSE; ++i)
+  {
+    ok_con(hdbc1, SQLGetConnectAttr(hdbc1, SQL_ATTR_CONNECTION_DEAD, &is_dead,
+                                    sizeof(is_dead), 0));
+    if (is_dead == SQL_CD_FALSE)
+      sleep(1);
+  }
+  is_num(is_dead, SQL_CD_TRUE);
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  return OK;
+}
+
 /**
  Bug #31055: Uninitiated memory returned by SQLGetFunctions() with
  SQL_API_ODBC3_ALL_FUNCTION
@@ -848,6 +892,7 @@ BEGIN_TESTS
   ADD_TEST(t_bug28657)
   ADD_TEST(t_bug30626)
   ADD_TEST(t_bug14639)
+  ADD_TEST(t_connection_dead_passive)
 #ifndef USE_IODBC
   ADD_TEST(t_getkeywordinfo)
 #endif
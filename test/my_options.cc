@@ -520,7 +520,7 @@ do { \
 }
 
 /*
-  Use mysql client library implementation of DNS+SRV
+  Connect through DNS+SRV
 */
 DECLARE_TEST(t_wl14362)
 {
@@ -562,6 +562,531 @@ DECLARE_TEST(t_wl14362)
   return OK;
 }
 
+/*
+  DNS+SRV records from a local file instead of DNS. The record with
+  target "." must be ignored, the other one must be used.
+*/
+DECLARE_TEST(t_dns_srv_file)
+{
+#ifdef _WIN32
+  SKIP_REASON = "The test sets environment variables the POSIX way\n";
+  return SKIP;
+#else
+  if ((mysock && mysock[0]) || myport)
+  {
+    SKIP_REASON = "The test needs a TCP connection to the default port\n";
+    return SKIP;
+  }
+
+  const char *srv_file = "odbc_srv_records.txt";
+  {
+    std::ofstream out(srv_file);
+    out << "; test records" << std::endl;
+    out << "_mysql._tcp.odbc.test. 60 IN SRV 0 100 3306 ." << std::endl;
+    out << "_mysql._tcp.odbc.test. 60 IN SRV 5 10 3306 " <<
+           (char*)myserver << std::endl;
+  }
+  setenv("MYODBC_DNS_SRV_FILE", srv_file, 1);
+
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+  int rc = alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1,
+             (SQLCHAR*)USE_DRIVER, myuid, mypwd, mydb,
+             (SQLCHAR*)"ENABLE_DNS_SRV=1;SERVER=_mysql._tcp.odbc.test");
+
+  unsetenv("MYODBC_DNS_SRV_FILE");
+  remove(srv_file);
+  is(OK == rc);
+
+  ok_sql(hstmt1, "SELECT 1");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_num(my_fetch_int(hstmt1, 1), 1);
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  return OK;
+#endif
+}
+
+/*
+  Choosing the compression algorithm and the zstd level
+*/
+DECLARE_TEST(t_compression_algorithms)
+{
+  SQLCHAR buf[64];
+
+  if (!mysql_min_version(hdbc, "8.0.18", 6))
+  {
+    SKIP_REASON = "The server does not support compression algorithms\n";
+    return SKIP;
+  }
+
+  {
+    DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+    is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1,
+               NULL, NULL, NULL, NULL,
+               (SQLCHAR*)"COMPRESSION-ALGORITHMS=zstd;ZSTD-COMPRESSION-LEVEL=7"));
+
+    ok_sql(hstmt1, "SHOW SESSION STATUS LIKE 'Compression_%'");
+    while (SQLFetch(hstmt1) == SQL_SUCCESS)
+    {
+      std::string name = (const char*)my_fetch_str(hstmt1, buf, 1);
+      if (name == "Compression_algorithm")
+        is_str(my_fetch_str(hstmt1, buf, 2), "zstd", 4);
+      else if (name == "Compression_level")
+        is_num(my_fetch_int(hstmt1, 2), 7);
+    }
+    free_basic_handles(&henv1, &hdbc1, &hstmt1);
+  }
+
+  {
+    SQLHDBC hdbc1;
+    ok_env(henv, SQLAllocHandle(SQL_HANDLE_DBC, henv, &hdbc1));
+    expect_dbc(hdbc1, get_connection(&hdbc1, NULL, NULL, NULL, NULL,
+                          (SQLCHAR*)"ZSTD-COMPRESSION-LEVEL=30"), SQL_ERROR);
+    ok_con(hdbc1, SQLFreeHandle(SQL_HANDLE_DBC, hdbc1));
+  }
+
+  return OK;
+}
+
+/*
+  The second TLS connection to the same server resumes the session of the
+  first one.
+*/
+#define MYSQL_ATTR_TLS_SESSION_REUSED SQL_DRIVER_CONNECT_ATTR_BASE + 0x00002000
+
+DECLARE_TEST(t_tls_session_reuse)
+{
+  SQLCHAR buf[64];
+
+  if (mysock && mysock[0])
+  {
+    SKIP_REASON = "The test needs a TCP connection\n";
+    return SKIP;
+  }
+
+  if (!mysql_min_version(hdbc, "8.0.29", 6))
+  {
+    SKIP_REASON = "The server does not support TLS session resumption\n";
+    return SKIP;
+  }
+
+  for (int i = 0; i < 2; ++i)
+  {
+    SQLUINTEGER reused = 2;
+    DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+    is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1,
+               NULL, NULL, NULL, NULL, (SQLCHAR*)"SSLMODE=REQUIRED"));
+
+    ok_sql(hstmt1, "SHOW SESSION STATUS LIKE 'Ssl_cipher'");
+    ok_stmt(hstmt1, SQLFetch(hstmt1));
+    is(strlen((const char*)my_fetch_str(hstmt1, buf, 2)) > 0);
+    ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+    ok_con(hdbc1, SQLGetConnectAttr(hdbc1, MYSQL_ATTR_TLS_SESSION_REUSED,
+                                    &reused, 0, NULL));
+    if (i)
+      is_num(reused, SQL_TRUE);
+
+    free_basic_handles(&henv1, &hdbc1, &hstmt1);
+  }
+
+  return OK;
+}
+
+/*
+  With RESULT_CACHE_TTL a repeated SELECT is answered without the server,
+  until the driver changes the table or the cache is not to be used. The
+  SET statements and the schema of the session are part of the key. A
+  query calling a stored function always reaches the server.
+*/
+#define MYSQL_ATTR_RESULT_CACHE_TTL SQL_DRIVER_CONNECT_ATTR_BASE + 0x00002001
+
+DECLARE_TEST(t_result_cache)
+{
+  SQLINTEGER id = 1;
+  SQLCHAR buf[16];
+  SQLHSTMT hstmt2;
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_result_cache");
+  ok_sql(hstmt, "DROP FUNCTION IF EXISTS t_result_cache_run");
+  ok_sql(hstmt, "CREATE TABLE t_result_cache (id INT, code CHAR(3))");
+  ok_sql(hstmt, "INSERT INTO t_result_cache VALUES (1, 'EUR'), (2, 'USD')");
+  ok_sql(hstmt, "DROP DATABASE IF EXISTS t_result_cache_db");
+  ok_sql(hstmt, "CREATE DATABASE t_result_cache_db");
+  ok_sql(hstmt, "CREATE TABLE t_result_cache_db.t_result_cache "
+                "(id INT, code CHAR(3))");
+  ok_sql(hstmt, "INSERT INTO t_result_cache_db.t_result_cache "
+                "VALUES (1, 'JPY')");
+  ok_sql(hstmt, "CREATE FUNCTION t_result_cache_run() RETURNS INT "
+                "NOT DETERMINISTIC NO SQL RETURN 1");
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1,
+             NULL, NULL, NULL, NULL,
+             (SQLCHAR*)"NO_SSPS=1;RESULT_CACHE_TTL=600;MULTI_STATEMENTS=1"));
+  ok_con(hdbc1, SQLAllocHandle(SQL_HANDLE_STMT, hdbc1, &hstmt2));
+
+  ok_stmt(hstmt1, SQLPrepare(hstmt1, (SQLCHAR*)"SELECT code "
+          "FROM t_result_cache WHERE id = ?", SQL_NTS));
+  ok_stmt(hstmt1, SQLBindParameter(hstmt1, 1, SQL_PARAM_INPUT, SQL_C_LONG,
+                                   SQL_INTEGER, 0, 0, &id, 0, NULL));
+
+  auto fetch_code = [&]() -> std::string
+  {
+    std::string code;
+    if (SQL_SUCCEEDED(SQLExecute(hstmt1)) &&
+        SQL_SUCCEEDED(SQLFetch(hstmt1)))
+      code = (const char*)my_fetch_str(hstmt1, buf, 1);
+    if (SQLFetch(hstmt1) != SQL_NO_DATA)
+      code = "more rows";
+    SQLFreeStmt(hstmt1, SQL_CLOSE);
+    return code;
+  };
+
+  auto fetch_twice = [&](const char *query) -> std::string
+  {
+    std::string code;
+    for (int i = 0; i < 2; ++i)
+    {
+      code.clear();
+      if (SQL_SUCCEEDED(SQLExecDirect(hstmt2, (SQLCHAR*)query, SQL_NTS)) &&
+          SQL_SUCCEEDED(SQLFetch(hstmt2)))
+        code = (const char*)my_fetch_str(hstmt2, buf, 1);
+      SQLFreeStmt(hstmt2, SQL_CLOSE);
+    }
+    return code;
+  };
+
+  /* Com_select of the session, reading it may count as a SELECT itself */
+  auto com_select = [&]() -> int
+  {
+    int n = -1;
+    if (SQL_SUCCEEDED(SQLExecDirect(hstmt2, (SQLCHAR*)
+                      "SHOW SESSION STATUS LIKE 'Com_select'", SQL_NTS)) &&
+        SQL_SUCCEEDED(SQLFetch(hstmt2)))
+      n = my_fetch_int(hstmt2, 2);
+    SQLFreeStmt(hstmt2, SQL_CLOSE);
+    return n;
+  };
+
+  int base = com_select();
+  int overhead = com_select() - base;
+  int reads = 0;
+  base += 2 * overhead;
+
+  /* Counts the SELECTs that reached the server */
+  auto runs = [&]() -> int
+  {
+    return com_select() - base - ++reads * overhead;
+  };
+
+  for (int i = 0; i < 3; ++i)
+    is_str(fetch_code().c_str(), "EUR", 4);
+  is_num(runs(), 1);
+
+  /* Deterministic built-in functions are cached, stored functions not */
+  is_str(fetch_twice("SELECT LOWER(code) FROM t_result_cache "
+                     "WHERE id = 1").c_str(), "eur", 4);
+  is_num(runs(), 2);
+  is_str(fetch_twice("SELECT t_result_cache_run() FROM t_result_cache "
+                     "WHERE id = 1").c_str(), "1", 2);
+  is_num(runs(), 4);
+  std::string qualified = std::string("SELECT CONCAT(code, `") +
+                          (const char*)mydb + "`.t_result_cache_run()) "
+                          "FROM t_result_cache WHERE id = 1";
+  is_str(fetch_twice(qualified.c_str()).c_str(), "EUR1", 5);
+  is_num(runs(), 6);
+
+  /* Another parameter value is another query */
+  id = 2;
+  is_str(fetch_code().c_str(), "USD", 4);
+  is_str(fetch_code().c_str(), "USD", 4);
+  is_num(runs(), 7);
+
+  /* A change made through the driver, on any connection, drops the result */
+  ok_sql(hstmt, "UPDATE t_result_cache SET code = 'GBP' WHERE id = 2");
+  is_str(fetch_code().c_str(), "GBP", 4);
+  is_num(runs(), 8);
+
+  /* Results of the session before the SET are not served after it */
+  ok_sql(hstmt2, "SET SESSION time_zone = '+01:00'");
+  is_str(fetch_code().c_str(), "GBP", 4);
+  ok_sql(hstmt2, "SET SESSION time_zone = '+01:00'");
+  is_str(fetch_code().c_str(), "GBP", 4);
+  is_num(runs(), 9);
+
+  /* Nothing is cached inside a transaction */
+  ok_con(hdbc1, SQLSetConnectAttr(hdbc1, SQL_ATTR_AUTOCOMMIT,
+                                  (SQLPOINTER)SQL_AUTOCOMMIT_OFF, 0));
+  is_str(fetch_code().c_str(), "GBP", 4);
+  is_str(fetch_code().c_str(), "GBP", 4);
+  is_num(runs(), 11);
+  ok_con(hdbc1, SQLEndTran(SQL_HANDLE_DBC, hdbc1, SQL_COMMIT));
+  ok_con(hdbc1, SQLSetConnectAttr(hdbc1, SQL_ATTR_AUTOCOMMIT,
+                                  (SQLPOINTER)SQL_AUTOCOMMIT_ON, 0));
+
+  /*
+    A text with more than one statement drops all results, and the session
+    it may have changed caches nothing more. Its SELECT counts too.
+  */
+  is_str(fetch_code().c_str(), "GBP", 4);
+  ok_sql(hstmt2, "SELECT 1; UPDATE t_result_cache SET code = 'CHF' "
+                 "WHERE id = 2");
+  ok_stmt(hstmt2, SQLFreeStmt(hstmt2, SQL_CLOSE));
+  is_str(fetch_code().c_str(), "CHF", 4);
+  is_str(fetch_code().c_str(), "CHF", 4);
+  is_num(runs(), 15);
+
+  /* The statement can turn the cache off */
+  SQLLEN ttl = 0;
+  ok_stmt(hstmt1, SQLGetStmtAttr(hstmt1, MYSQL_ATTR_RESULT_CACHE_TTL,
+                                 &ttl, 0, NULL));
+  is_num(ttl, -1);
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, MYSQL_ATTR_RESULT_CACHE_TTL,
+                                 (SQLPOINTER)0, 0));
+  is_str(fetch_code().c_str(), "CHF", 4);
+  is_num(runs(), 16);
+
+  /* The same text after a USE reads another table */
+  ok_sql(hstmt2, "SELECT code FROM t_result_cache WHERE id = 1");
+  ok_stmt(hstmt2, SQLFetch(hstmt2));
+  is_str(my_fetch_str(hstmt2, buf, 1), "EUR", 4);
+  ok_stmt(hstmt2, SQLFreeStmt(hstmt2, SQL_CLOSE));
+  ok_sql(hstmt2, "USE t_result_cache_db");
+  ok_sql(hstmt2, "SELECT code FROM t_result_cache WHERE id = 1");
+  ok_stmt(hstmt2, SQLFetch(hstmt2));
+  is_str(my_fetch_str(hstmt2, buf, 1), "JPY", 4);
+  ok_stmt(hstmt2, SQLFreeStmt(hstmt2, SQL_CLOSE));
+
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_RESET_PARAMS));
+  ok_stmt(hstmt2, SQLFreeHandle(SQL_HANDLE_STMT, hstmt2));
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  ok_sql(hstmt, "DROP FUNCTION IF EXISTS t_result_cache_run");
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_result_cache");
+  ok_sql(hstmt, "DROP DATABASE IF EXISTS t_result_cache_db");
+
+  return OK;
+}
+
+/*
+  MYSQL_ATTR_MEMORY_USED tells what the rows of a stored result take.
+  Under MEMORY_HARD_LIMIT the rows are read one by one, until they would
+  take the connection over it. Past MEMORY_SOFT_LIMIT forward-only results
+  are read as they are fetched.
+*/
+#define MYSQL_ATTR_MEMORY_USED SQL_DRIVER_CONNECT_ATTR_BASE + 0x00002002
+
+DECLARE_TEST(t_memory_limits)
+{
+  SQLULEN used = 0, conn_used = 0;
+  SQLLEN row_count = 0;
+  SQLHSTMT hstmt2;
+  int rows = 0;
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_memory_limits");
+  ok_sql(hstmt, "CREATE TABLE t_memory_limits (id INT, val VARCHAR(1000))");
+  ok_sql(hstmt, "INSERT INTO t_memory_limits VALUES (1, REPEAT('a', 1000)),"
+                "(2, REPEAT('b', 1000)), (3, REPEAT('c', 1000)),"
+                "(4, REPEAT('d', 1000)), (5, REPEAT('e', 1000))");
+  for (int i = 0; i < 5; ++i)
+    ok_sql(hstmt, "INSERT INTO t_memory_limits SELECT * FROM t_memory_limits");
+
+  /* 160 rows of 1000 bytes are stored by a static cursor */
+  ok_stmt(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE,
+                                (SQLPOINTER)SQL_CURSOR_STATIC, 0));
+  ok_sql(hstmt, "SELECT * FROM t_memory_limits");
+  ok_stmt(hstmt, SQLGetStmtAttr(hstmt, MYSQL_ATTR_MEMORY_USED,
+                                &used, 0, NULL));
+  is(used > 160 * 1000);
+  ok_con(hdbc, SQLGetConnectAttr(hdbc, MYSQL_ATTR_MEMORY_USED,
+                                 &conn_used, 0, NULL));
+  is(conn_used >= used);
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+  ok_stmt(hstmt, SQLGetStmtAttr(hstmt, MYSQL_ATTR_MEMORY_USED,
+                                &used, 0, NULL));
+  is(used < 160 * 1000);
+  ok_stmt(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_CURSOR_TYPE,
+                                (SQLPOINTER)SQL_CURSOR_FORWARD_ONLY, 0));
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1,
+             NULL, NULL, NULL, NULL,
+             (SQLCHAR*)"MEMORY_HARD_LIMIT=65536"));
+  ok_con(hdbc1, SQLAllocHandle(SQL_HANDLE_STMT, hdbc1, &hstmt2));
+
+  /* The rows are read one by one until they are too much */
+  expect_sql(hstmt1, "SELECT * FROM t_memory_limits", SQL_ERROR);
+  is_num(check_sqlstate(hstmt1, "HY001"), OK);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  /* A scrollable cursor the same */
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE,
+                                 (SQLPOINTER)SQL_CURSOR_STATIC, 0));
+  expect_sql(hstmt1, "SELECT * FROM t_memory_limits", SQL_ERROR);
+  is_num(check_sqlstate(hstmt1, "HY001"), OK);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+  ok_con(hdbc1, SQLGetConnectAttr(hdbc1, MYSQL_ATTR_MEMORY_USED,
+                                  &conn_used, 0, NULL));
+  is(conn_used < 65536);
+
+  /* A small result fits */
+  ok_sql(hstmt1, "SELECT id FROM t_memory_limits WHERE id = 1");
+  rows = 0;
+  while (SQL_SUCCEEDED(SQLFetch(hstmt1)))
+    ++rows;
+  is_num(rows, 32);
+  ok_stmt(hstmt1, SQLFetchScroll(hstmt1, SQL_FETCH_ABSOLUTE, 2));
+  is_num(my_fetch_int(hstmt1, 1), 1);
+  ok_con(hdbc1, SQLGetConnectAttr(hdbc1, MYSQL_ATTR_MEMORY_USED,
+                                  &conn_used, 0, NULL));
+  is(conn_used > 0 && conn_used < 65536);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  /* Forward-only too, with the connection free for other statements */
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_CURSOR_TYPE,
+                                 (SQLPOINTER)SQL_CURSOR_FORWARD_ONLY, 0));
+  ok_sql(hstmt1, "SELECT id FROM t_memory_limits WHERE id = 1");
+  ok_stmt(hstmt1, SQLRowCount(hstmt1, &row_count));
+  is_num(row_count, 32);
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  ok_sql(hstmt2, "SELECT COUNT(*) FROM t_memory_limits");
+  ok_stmt(hstmt2, SQLFetch(hstmt2));
+  is_num(my_fetch_int(hstmt2, 1), 160);
+  ok_stmt(hstmt2, SQLFreeStmt(hstmt2, SQL_CLOSE));
+  rows = 1;
+  while (SQL_SUCCEEDED(SQLFetch(hstmt1)))
+    ++rows;
+  is_num(rows, 32);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  ok_stmt(hstmt2, SQLFreeHandle(SQL_HANDLE_STMT, hstmt2));
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  /*
+    Past MEMORY_SOFT_LIMIT a forward-only result is read as it is fetched,
+    as with NO_CACHE. Nothing is stored, and the connection can't run
+    another statement until the result is read.
+  */
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1,
+             NULL, NULL, NULL, NULL, (SQLCHAR*)"MEMORY_SOFT_LIMIT=1"));
+  ok_con(hdbc1, SQLAllocHandle(SQL_HANDLE_STMT, hdbc1, &hstmt2));
+
+  ok_sql(hstmt1, "SELECT * FROM t_memory_limits");
+  ok_stmt(hstmt1, SQLGetStmtAttr(hstmt1, MYSQL_ATTR_MEMORY_USED,
+                                 &used, 0, NULL));
+  is(used < 65536);
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  expect_sql(hstmt2, "SELECT 1", SQL_ERROR);
+  rows = 1;
+  while (SQL_SUCCEEDED(SQLFetch(hstmt1)))
+    ++rows;
+  is_num(rows, 160);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+  ok_sql(hstmt2, "SELECT 1");
+  ok_stmt(hstmt2, SQLFreeStmt(hstmt2, SQL_CLOSE));
+
+  ok_stmt(hstmt2, SQLFreeHandle(SQL_HANDLE_STMT, hstmt2));
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_memory_limits");
+
+  return OK;
+}
+
+
+/*
+  A dropped statement handle kept for reuse gives back buffers that grew
+  beyond what a new statement would have.
+*/
+DECLARE_TEST(t_recycled_memory)
+{
+  SQLHSTMT hstmt1;
+  SQLULEN used = 0;
+  SQLLEN len = SQL_NTS;
+  std::string big(200000, 'x');
+
+  ok_con(hdbc, SQLAllocHandle(SQL_HANDLE_STMT, hdbc, &hstmt1));
+  ok_stmt(hstmt1, SQLBindParameter(hstmt1, 1, SQL_PARAM_INPUT, SQL_C_CHAR,
+                                   SQL_VARCHAR, big.size(), 0,
+                                   (SQLPOINTER)big.c_str(), 0, &len));
+  ok_sql(hstmt1, "SELECT LENGTH(?)");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_num(my_fetch_int(hstmt1, 1), 200000);
+  ok_stmt(hstmt1, SQLGetStmtAttr(hstmt1, MYSQL_ATTR_MEMORY_USED,
+                                 &used, 0, NULL));
+  is(used > 200000);
+  ok_stmt(hstmt1, SQLFreeHandle(SQL_HANDLE_STMT, hstmt1));
+
+  /* The handle comes back from the connection's free list */
+  ok_con(hdbc, SQLAllocHandle(SQL_HANDLE_STMT, hdbc, &hstmt1));
+  ok_stmt(hstmt1, SQLGetStmtAttr(hstmt1, MYSQL_ATTR_MEMORY_USED,
+                                 &used, 0, NULL));
+  is(used < 65536);
+
+  /* A large literal is kept in the copies of the query text */
+  std::string query = "SELECT LENGTH('" + big + "')";
+  ok_stmt(hstmt1, SQLExecDirect(hstmt1, (SQLCHAR *)query.c_str(), SQL_NTS));
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_num(my_fetch_int(hstmt1, 1), 200000);
+  ok_stmt(hstmt1, SQLGetStmtAttr(hstmt1, MYSQL_ATTR_MEMORY_USED,
+                                 &used, 0, NULL));
+  is(used > 200000);
+  ok_stmt(hstmt1, SQLFreeHandle(SQL_HANDLE_STMT, hstmt1));
+
+  ok_con(hdbc, SQLAllocHandle(SQL_HANDLE_STMT, hdbc, &hstmt1));
+  ok_stmt(hstmt1, SQLGetStmtAttr(hstmt1, MYSQL_ATTR_MEMORY_USED,
+                                 &used, 0, NULL));
+  is(used < 65536);
+  ok_stmt(hstmt1, SQLFreeHandle(SQL_HANDLE_STMT, hstmt1));
+
+  return OK;
+}
+
+
+#define MYSQL_ATTR_PERF_COUNTERS SQL_DRIVER_CONNECT_ATTR_BASE + 0x00002003
+
+DECLARE_TEST(t_perf_counters)
+{
+  SQLCHAR report[4096], small[8];
+  SQLINTEGER len = 0;
+  int rows = 0;
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+
+  /* Without PERF_COUNTERS the connection has nothing to report */
+  ok_con(hdbc, SQLGetConnectAttr(hdbc, MYSQL_ATTR_PERF_COUNTERS,
+                                 report, sizeof(report), &len));
+  is_num(len, 0);
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1,
+             NULL, NULL, NULL, NULL, (SQLCHAR*)"PERF_COUNTERS=1"));
+
+  ok_sql(hstmt1, "SELECT 1 UNION ALL SELECT 2 UNION ALL SELECT 3");
+  while (SQL_SUCCEEDED(SQLFetch(hstmt1)))
+    ++rows;
+  is_num(rows, 3);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  ok_con(hdbc1, SQLGetConnectAttr(hdbc1, MYSQL_ATTR_PERF_COUNTERS,
+                                  report, sizeof(report), &len));
+  is(len > 0);
+  is(strstr((char *)report, "executes=1;") != NULL);
+  is(strstr((char *)report, "rows_fetched=3;") != NULL);
+
+  /* The process counters include this connection */
+  ok_env(henv1, SQLGetEnvAttr(henv1, MYSQL_ATTR_PERF_COUNTERS,
+                              report, sizeof(report), &len));
+  is(len > 0);
+  is(strstr((char *)report, "rows_fetched=") != NULL);
+
+  is_num(SQLGetEnvAttr(henv1, MYSQL_ATTR_PERF_COUNTERS,
+                       small, sizeof(small), &len), SQL_SUCCESS_WITH_INFO);
+  is_num(strlen((char *)small), sizeof(small) - 1);
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  return OK;
+}
+
 struct test_params
 {
   int no_catalog;
@@ -1123,6 +1648,13 @@ BEGIN_TESTS
   ADD_TEST(t_wl13883)
   ADD_TEST(t_wl14490)
   ADD_TEST(t_wl14362)
+  ADD_TEST(t_dns_srv_file)
+  ADD_TEST(t_compression_algorithms)
+  ADD_TEST(t_tls_session_reuse)
+  ADD_TEST(t_result_cache)
+  ADD_TEST(t_memory_limits)
+  ADD_TEST(t_recycled_memory)
+  ADD_TEST(t_perf_counters)
 END_TESTS
 
 RUN_TESTS
@@ -2578,6 +2578,327 @@ DECLARE_TEST(t_wl15967)
 }
 
 
+/*
+  Array of parameters for an UPDATE sent a window of sets at a time. A
+  failing set stops its window on the server, the sets after it are sent
+  again unless PIPELINE_STOP_ON_ERROR is set.
+*/
+DECLARE_TEST(t_paramarray_pipeline)
+{
+  SQLINTEGER   u[10], id[10];
+  SQLUSMALLINT status[10];
+  SQLULEN      processed;
+  SQLLEN       rows;
+  int          i, stop;
+
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+
+  for (stop= 0; stop < 2; ++stop)
+  {
+    is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL,
+                                          NULL, NULL, NULL, stop ?
+                                          "PIPELINE_WINDOW=4;PIPELINE_STOP_ON_ERROR=1" :
+                                          "PIPELINE_WINDOW=4"));
+
+    ok_sql(hstmt1, "DROP TABLE IF EXISTS t_paramarray_pipeline");
+    ok_sql(hstmt1, "CREATE TABLE t_paramarray_pipeline "
+                   "(id INT PRIMARY KEY, u INT UNIQUE)");
+    ok_sql(hstmt1, "INSERT INTO t_paramarray_pipeline VALUES (1,1),(2,2),"
+                   "(3,3),(4,4),(5,5),(6,6),(7,7),(8,8),(9,9),(10,10)");
+
+    for (i= 0; i < 10; ++i)
+    {
+      id[i]= i + 1;
+      u[i]= i + 101;
+    }
+    /* Duplicates the value the 3rd set gives */
+    u[4]= 103;
+
+    ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_PARAMSET_SIZE,
+                                   (SQLPOINTER)10, 0));
+    ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_PARAM_STATUS_PTR,
+                                   status, 0));
+    ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_PARAMS_PROCESSED_PTR,
+                                   &processed, 0));
+    ok_stmt(hstmt1, SQLBindParameter(hstmt1, 1, SQL_PARAM_INPUT, SQL_C_LONG,
+                                     SQL_INTEGER, 0, 0, u, 0, NULL));
+    ok_stmt(hstmt1, SQLBindParameter(hstmt1, 2, SQL_PARAM_INPUT, SQL_C_LONG,
+                                     SQL_INTEGER, 0, 0, id, 0, NULL));
+
+    expect_stmt(hstmt1, SQLExecDirect(hstmt1, (SQLCHAR *)
+                "UPDATE t_paramarray_pipeline SET u = ? WHERE id = ?", SQL_NTS),
+                SQL_SUCCESS_WITH_INFO);
+
+    is_num(processed, stop ? 5 : 10);
+    for (i= 0; i < 10; ++i)
+    {
+      is_num(status[i], i == 4 ? SQL_PARAM_ERROR :
+                        (stop && i > 4) ? SQL_PARAM_UNUSED : SQL_PARAM_SUCCESS);
+    }
+    ok_stmt(hstmt1, SQLRowCount(hstmt1, &rows));
+    is_num(rows, stop ? 4 : 9);
+
+    ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_PARAMSET_SIZE,
+                                   (SQLPOINTER)1, 0));
+    ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_RESET_PARAMS));
+
+    ok_sql(hstmt1, "SELECT COUNT(*) FROM t_paramarray_pipeline WHERE u > 100");
+    ok_stmt(hstmt1, SQLFetch(hstmt1));
+    is_num(my_fetch_int(hstmt1, 1), stop ? 4 : 9);
+    ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+    ok_sql(hstmt1, "DROP TABLE IF EXISTS t_paramarray_pipeline");
+    free_basic_handles(&henv1, &hdbc1, &hstmt1);
+  }
+
+  return OK;
+}
+
+
+/*
+  Query texts the pipeline has to take care of: a trailing ';' and comment
+  must not end up between the statements of a window, and a text with more
+  than one statement is executed a set at a time.
+*/
+DECLARE_TEST(t_paramarray_pipeline_text)
+{
+  SQLINTEGER   u[6], id[6];
+  SQLUSMALLINT status[6];
+  SQLULEN      processed;
+  SQLLEN       rows;
+  int          i;
+
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL,
+                                        NULL, NULL, NULL,
+                                        "PIPELINE_WINDOW=4;NO_SSPS=1;"
+                                        "MULTI_STATEMENTS=1"));
+
+  ok_sql(hstmt1, "DROP TABLE IF EXISTS t_paramarray_pipeline_text");
+  ok_sql(hstmt1, "CREATE TABLE t_paramarray_pipeline_text "
+                 "(id INT PRIMARY KEY, u INT, v INT)");
+  ok_sql(hstmt1, "INSERT INTO t_paramarray_pipeline_text VALUES (1,1,0),"
+                 "(2,2,0),(3,3,0),(4,4,0),(5,5,0),(6,6,0)");
+
+  for (i= 0; i < 6; ++i)
+  {
+    id[i]= i + 1;
+    u[i]= i + 101;
+  }
+
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_PARAMSET_SIZE,
+                                 (SQLPOINTER)6, 0));
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_PARAM_STATUS_PTR,
+                                 status, 0));
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_PARAMS_PROCESSED_PTR,
+                                 &processed, 0));
+  ok_stmt(hstmt1, SQLBindParameter(hstmt1, 1, SQL_PARAM_INPUT, SQL_C_LONG,
+                                   SQL_INTEGER, 0, 0, u, 0, NULL));
+  ok_stmt(hstmt1, SQLBindParameter(hstmt1, 2, SQL_PARAM_INPUT, SQL_C_LONG,
+                                   SQL_INTEGER, 0, 0, id, 0, NULL));
+
+  ok_stmt(hstmt1, SQLExecDirect(hstmt1, (SQLCHAR *)
+          "UPDATE t_paramarray_pipeline_text SET u = ? WHERE id = ? ; "
+          "-- ends with a comment", SQL_NTS));
+
+  is_num(processed, 6);
+  for (i= 0; i < 6; ++i)
+  {
+    is_num(status[i], SQL_PARAM_SUCCESS);
+  }
+  ok_stmt(hstmt1, SQLRowCount(hstmt1, &rows));
+  is_num(rows, 6);
+
+  /* Two statements per set, the second one uses the 3rd parameter */
+  for (i= 0; i < 6; ++i)
+  {
+    u[i]= i + 201;
+  }
+  ok_stmt(hstmt1, SQLBindParameter(hstmt1, 3, SQL_PARAM_INPUT, SQL_C_LONG,
+                                   SQL_INTEGER, 0, 0, id, 0, NULL));
+
+  ok_stmt(hstmt1, SQLExecDirect(hstmt1, (SQLCHAR *)
+          "UPDATE t_paramarray_pipeline_text SET u = ? WHERE id = ?;"
+          "UPDATE t_paramarray_pipeline_text SET v = v + 1 WHERE id = ?;",
+          SQL_NTS));
+
+  is_num(processed, 6);
+  for (i= 0; i < 6; ++i)
+  {
+    is_num(status[i], SQL_PARAM_SUCCESS);
+  }
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_PARAMSET_SIZE,
+                                 (SQLPOINTER)1, 0));
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_RESET_PARAMS));
+
+  ok_sql(hstmt1, "SELECT COUNT(*), SUM(v) FROM t_paramarray_pipeline_text "
+                 "WHERE u > 200");
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_num(my_fetch_int(hstmt1, 1), 6);
+  is_num(my_fetch_int(hstmt1, 2), 6);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  ok_sql(hstmt1, "DROP TABLE IF EXISTS t_paramarray_pipeline_text");
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  return OK;
+}
+
+
+/* LOAD DATA statements the session has run so far */
+static int count_bulk_loads(SQLHSTMT hstmt, int *count)
+{
+  ok_sql(hstmt, "SHOW SESSION STATUS LIKE 'Com_load'");
+  ok_stmt(hstmt, SQLFetch(hstmt));
+  *count= my_fetch_int(hstmt, 2);
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+  return OK;
+}
+
+
+/*
+  Array of parameters for a plain INSERT sent with LOAD DATA LOCAL INFILE.
+  Values with quotes, tabs and new lines, NULLs and ignored sets must come
+  out as the regular path would insert them, which is also what happens if
+  the server does not allow local files. A truncated value gives its set
+  a warning. In strict SQL mode or with a unique key the sets are inserted
+  one by one, a bad value or a duplicate failing on its own.
+*/
+DECLARE_TEST(t_paramarray_bulk_load)
+{
+  SQLINTEGER   id[7]= {1, 2, 3, 4, 5, 6, 7};
+  SQLCHAR      str[7][16]= {"plain", "it's", "a\tb", "line\nnext", "back\\",
+                            "", "far too long"};
+  SQLLEN       str_ind[7]= {SQL_NTS, SQL_NTS, SQL_NTS, SQL_NTS, SQL_NTS,
+                            SQL_NULL_DATA, SQL_NTS};
+  SQLUSMALLINT operation[7]= {SQL_PARAM_PROCEED, SQL_PARAM_PROCEED,
+                              SQL_PARAM_PROCEED, SQL_PARAM_IGNORE,
+                              SQL_PARAM_PROCEED, SQL_PARAM_PROCEED,
+                              SQL_PARAM_PROCEED};
+  SQLUSMALLINT status[7];
+  SQLULEN      processed;
+  SQLCHAR      buf[16];
+  SQLLEN       len;
+  SQLHSTMT     hstmt2;
+  int          i, loads, loads_before;
+  const SQLCHAR *insert= (SQLCHAR *)
+    "INSERT INTO t_paramarray_bulk_load (id, s) VALUES (?, ?)";
+
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL,
+                                        "ENABLE_LOCAL_INFILE=1;BULK_LOAD_ROWS=3"));
+  ok_con(hdbc1, SQLAllocHandle(SQL_HANDLE_STMT, hdbc1, &hstmt2));
+
+  ok_sql(hstmt2, "SET SESSION sql_mode = ''");
+  ok_sql(hstmt2, "DROP TABLE IF EXISTS t_paramarray_bulk_load");
+  ok_sql(hstmt2, "CREATE TABLE t_paramarray_bulk_load "
+                 "(id INT, s VARCHAR(10))");
+
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_PARAMSET_SIZE,
+                                 (SQLPOINTER)7, 0));
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_PARAM_STATUS_PTR,
+                                 status, 0));
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_PARAM_OPERATION_PTR,
+                                 operation, 0));
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_PARAMS_PROCESSED_PTR,
+                                 &processed, 0));
+  ok_stmt(hstmt1, SQLBindParameter(hstmt1, 1, SQL_PARAM_INPUT, SQL_C_LONG,
+                                   SQL_INTEGER, 0, 0, id, 0, NULL));
+  ok_stmt(hstmt1, SQLBindParameter(hstmt1, 2, SQL_PARAM_INPUT, SQL_C_CHAR,
+                                   SQL_VARCHAR, 16, 0, str, 16, str_ind));
+
+  /* The truncation warning names its line, which is mapped to the set */
+  is(OK == count_bulk_loads(hstmt2, &loads_before));
+  expect_stmt(hstmt1, SQLExecDirect(hstmt1, (SQLCHAR *)insert, SQL_NTS),
+              SQL_SUCCESS_WITH_INFO);
+  is(OK == count_bulk_loads(hstmt2, &loads));
+  is_num(loads, loads_before + 1);
+
+  is_num(processed, 7);
+  for (i= 0; i < 7; ++i)
+  {
+    is_num(status[i], i == 3 ? SQL_PARAM_UNUSED :
+                      i == 6 ? SQL_PARAM_SUCCESS_WITH_INFO : SQL_PARAM_SUCCESS);
+  }
+
+  ok_sql(hstmt2, "SELECT id, s FROM t_paramarray_bulk_load ORDER BY id");
+  for (i= 0; i < 7; ++i)
+  {
+    if (i == 3)
+      continue;
+
+    ok_stmt(hstmt2, SQLFetch(hstmt2));
+    is_num(my_fetch_int(hstmt2, 1), id[i]);
+    ok_stmt(hstmt2, SQLGetData(hstmt2, 2, SQL_C_CHAR, buf, sizeof(buf), &len));
+    if (i == 5)
+    {
+      is_num(len, SQL_NULL_DATA);
+    }
+    else if (i == 6)
+    {
+      is_str(buf, "far too lo", 11);
+    }
+    else
+    {
+      is_str(buf, str[i], strlen((char *)str[i]) + 1);
+    }
+  }
+  expect_stmt(hstmt2, SQLFetch(hstmt2), SQL_NO_DATA);
+  ok_stmt(hstmt2, SQLFreeStmt(hstmt2, SQL_CLOSE));
+
+  /* In strict mode the long value fails, as its INSERT does */
+  ok_sql(hstmt2, "DELETE FROM t_paramarray_bulk_load");
+  ok_sql(hstmt2, "SET SESSION sql_mode = 'STRICT_TRANS_TABLES'");
+  expect_stmt(hstmt1, SQLExecDirect(hstmt1, (SQLCHAR *)insert, SQL_NTS),
+              SQL_SUCCESS_WITH_INFO);
+  is(OK == count_bulk_loads(hstmt2, &loads_before));
+  is_num(loads_before, loads);
+
+  for (i= 0; i < 7; ++i)
+  {
+    is_num(status[i], i == 3 ? SQL_PARAM_UNUSED :
+                      i == 6 ? SQL_PARAM_ERROR : SQL_PARAM_SUCCESS);
+  }
+
+  ok_sql(hstmt2, "SELECT COUNT(*) FROM t_paramarray_bulk_load");
+  ok_stmt(hstmt2, SQLFetch(hstmt2));
+  is_num(my_fetch_int(hstmt2, 1), 5);
+  ok_stmt(hstmt2, SQLFreeStmt(hstmt2, SQL_CLOSE));
+
+  /* With a unique key the duplicate fails on its own, not skipped */
+  ok_sql(hstmt2, "DELETE FROM t_paramarray_bulk_load");
+  ok_sql(hstmt2, "SET SESSION sql_mode = ''");
+  ok_sql(hstmt2, "ALTER TABLE t_paramarray_bulk_load ADD PRIMARY KEY (id)");
+  id[1]= 1;
+  expect_stmt(hstmt1, SQLExecDirect(hstmt1, (SQLCHAR *)insert, SQL_NTS),
+              SQL_SUCCESS_WITH_INFO);
+  is(OK == count_bulk_loads(hstmt2, &loads_before));
+  is_num(loads_before, loads);
+
+  for (i= 0; i < 7; ++i)
+  {
+    is_num(status[i], i == 1 ? SQL_PARAM_ERROR :
+                      i == 3 ? SQL_PARAM_UNUSED : SQL_PARAM_SUCCESS);
+  }
+
+  ok_sql(hstmt2, "SELECT COUNT(*) FROM t_paramarray_bulk_load");
+  ok_stmt(hstmt2, SQLFetch(hstmt2));
+  is_num(my_fetch_int(hstmt2, 1), 5);
+  ok_stmt(hstmt2, SQLFreeStmt(hstmt2, SQL_CLOSE));
+
+  ok_sql(hstmt2, "DROP TABLE IF EXISTS t_paramarray_bulk_load");
+  ok_stmt(hstmt2, SQLFreeHandle(SQL_HANDLE_STMT, hstmt2));
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  return OK;
+}
+
+
 BEGIN_TESTS
   ADD_TEST(t_wl15967)
   ADD_TEST(t_odbcoutparams)
@@ -2605,6 +2926,9 @@ BEGIN_TESTS
   ADD_TEST(paramarray_by_column)
   ADD_TEST(paramarray_ignore_paramset)
   ADD_TEST(paramarray_select)
+  ADD_TEST(t_paramarray_pipeline)
+  ADD_TEST(t_paramarray_pipeline_text)
+  ADD_TEST(t_paramarray_bulk_load)
 #ifndef USE_IODBC
   ADD_TEST(t_bug56804)
 #endif
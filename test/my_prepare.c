@@ -1287,6 +1287,153 @@ DECLARE_TEST(t_bug31667091)
   return OK;
 }
 
+/*
+  SQLNumResultCols and SQLDescribeCol before SQLExecute get the columns
+  from the server without running the query, also when the statement is
+  not prepared on the server and its parameters are not bound yet.
+*/
+DECLARE_TEST(t_prep_describe_no_exec)
+{
+  SQLSMALLINT ncol, name_len, type, scale, nullable;
+  SQLULEN     size;
+  SQLCHAR     name[32];
+  SQLINTEGER  id= 2;
+
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_prep_describe");
+  ok_sql(hstmt, "CREATE TABLE t_prep_describe (id INT NOT NULL, "
+                "name VARCHAR(20))");
+  ok_sql(hstmt, "INSERT INTO t_prep_describe VALUES (1, 'a'), (2, 'b')");
+  ok_sql(hstmt, "SET @hits = 0");
+
+  /* No markers, the statement runs through the text protocol */
+  ok_stmt(hstmt, SQLPrepare(hstmt, (SQLCHAR *)"SELECT id, name, "
+                            "@hits := @hits + 1 AS hits FROM t_prep_describe",
+                            SQL_NTS));
+  ok_stmt(hstmt, SQLNumResultCols(hstmt, &ncol));
+  is_num(ncol, 3);
+  ok_stmt(hstmt, SQLDescribeCol(hstmt, 2, name, sizeof(name), &name_len,
+                                &type, &size, &scale, &nullable));
+  is_str(name, "name", 5);
+  is_num(size, 20);
+  is_num(nullable, SQL_NULLABLE);
+  ok_stmt(hstmt, SQLDescribeCol(hstmt, 1, name, sizeof(name), &name_len,
+                                &type, &size, &scale, &nullable));
+  is_str(name, "id", 3);
+  is_num(type, SQL_INTEGER);
+  is_num(nullable, SQL_NO_NULLS);
+
+  ok_stmt(hstmt, SQLExecute(hstmt));
+  is_num(my_print_non_format_result(hstmt), 2);
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+  /* Only the execution has counted the rows */
+  ok_sql(hstmt, "SELECT @hits");
+  ok_stmt(hstmt, SQLFetch(hstmt));
+  is_num(my_fetch_int(hstmt, 1), 2);
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+  /* Markers with prepared statements disabled, nothing bound yet */
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL, NULL,
+                                        NULL, NULL, "NO_SSPS=1"));
+
+  ok_stmt(hstmt1, SQLPrepare(hstmt1, (SQLCHAR *)"SELECT name FROM "
+                             "t_prep_describe WHERE id = ?", SQL_NTS));
+  ok_stmt(hstmt1, SQLNumResultCols(hstmt1, &ncol));
+  is_num(ncol, 1);
+  ok_stmt(hstmt1, SQLDescribeCol(hstmt1, 1, name, sizeof(name), &name_len,
+                                 &type, &size, &scale, &nullable));
+  is_str(name, "name", 5);
+
+  /* Describing didn't stand in for the missing parameter */
+  expect_stmt(hstmt1, SQLExecute(hstmt1), SQL_ERROR);
+  is_num(check_sqlstate(hstmt1, "07001"), OK);
+
+  ok_stmt(hstmt1, SQLBindParameter(hstmt1, 1, SQL_PARAM_INPUT, SQL_C_LONG,
+                                   SQL_INTEGER, 0, 0, &id, 0, NULL));
+  ok_stmt(hstmt1, SQLExecute(hstmt1));
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_str(my_fetch_str(hstmt1, name, 1), "b", 2);
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_prep_describe");
+
+  return OK;
+}
+
+
+/* Re-executing a prepared statement keeps its IRD until the columns change */
+DECLARE_TEST(t_prep_reexecute)
+{
+  SQLSMALLINT ncol, name_len, type, scale, nullable;
+  SQLULEN     size;
+  SQLCHAR     name[32], value[64];
+  SQLINTEGER  id;
+  SQLHSTMT    hstmt2;
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_prep_reexecute");
+  ok_sql(hstmt, "CREATE TABLE t_prep_reexecute (id INT NOT NULL, "
+                "name VARCHAR(20))");
+  ok_sql(hstmt, "INSERT INTO t_prep_reexecute VALUES (1, 'a'), (2, 'bb'), "
+                "(3, 'ccc')");
+
+  ok_stmt(hstmt, SQLPrepare(hstmt, (SQLCHAR *)"SELECT name FROM "
+                            "t_prep_reexecute WHERE id = ?", SQL_NTS));
+  ok_stmt(hstmt, SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_LONG,
+                                  SQL_INTEGER, 0, 0, &id, 0, NULL));
+
+  for (id= 1; id <= 3; ++id)
+  {
+    ok_stmt(hstmt, SQLExecute(hstmt));
+    ok_stmt(hstmt, SQLFetch(hstmt));
+    is_num(strlen(my_fetch_str(hstmt, value, 1)), id);
+    expect_stmt(hstmt, SQLFetch(hstmt), SQL_NO_DATA);
+
+    ok_stmt(hstmt, SQLDescribeCol(hstmt, 1, name, sizeof(name), &name_len,
+                                  &type, &size, &scale, &nullable));
+    is_str(name, "name", 5);
+    is_num(size, 20);
+
+    /*
+      Every other time the cursor is left open for SQLExecute to close.
+      With the metadata kept, a closed cursor still can't be fetched from.
+    */
+    if (id % 2)
+    {
+      ok_stmt(hstmt, SQLCloseCursor(hstmt));
+      expect_stmt(hstmt, SQLFetch(hstmt), SQL_ERROR);
+      is_num(check_sqlstate(hstmt, "24000"), OK);
+    }
+  }
+
+  /* The columns change under the statement, the IRD has to follow */
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+  expect_stmt(hstmt, SQLFetch(hstmt), SQL_ERROR);
+  is_num(check_sqlstate(hstmt, "24000"), OK);
+  ok_con(hdbc, SQLAllocHandle(SQL_HANDLE_STMT, hdbc, &hstmt2));
+  ok_sql(hstmt2, "ALTER TABLE t_prep_reexecute MODIFY name VARCHAR(40)");
+  ok_stmt(hstmt2, SQLFreeHandle(SQL_HANDLE_STMT, hstmt2));
+
+  id= 2;
+  ok_stmt(hstmt, SQLExecute(hstmt));
+  ok_stmt(hstmt, SQLNumResultCols(hstmt, &ncol));
+  is_num(ncol, 1);
+  ok_stmt(hstmt, SQLDescribeCol(hstmt, 1, name, sizeof(name), &name_len,
+                                &type, &size, &scale, &nullable));
+  is_num(size, 40);
+  ok_stmt(hstmt, SQLFetch(hstmt));
+  is_str(my_fetch_str(hstmt, value, 1), "bb", 3);
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_RESET_PARAMS));
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_prep_reexecute");
+
+  return OK;
+}
+
 BEGIN_TESTS
   ADD_TEST(t_prep_basic)
   ADD_TEST(t_prep_buffer_length)
@@ -1306,6 +1453,8 @@ BEGIN_TESTS
   ADD_TEST(t_bug67702)
   ADD_TEST(t_bug68243)
   ADD_TEST(t_bug67920)
+  ADD_TEST(t_prep_describe_no_exec)
+  ADD_TEST(t_prep_reexecute)
   ADD_TODO(t_bug31667091)
 END_TESTS
 
@@ -1425,6 +1425,90 @@ DECLARE_TEST(t_bug28098219)
   return OK;
 }
 
+/*
+  Row arrays bound by column over a buffered text protocol result, with
+  NULLs and an out of range value in the block.
+*/
+DECLARE_TEST(t_column_wise_block)
+{
+  SQLINTEGER  id[4];
+  SQLBIGINT   big[4];
+  SQLDOUBLE   dbl[4];
+  SQLCHAR     str[4][8];
+  SQLLEN      id_len[4], big_len[4], dbl_len[4], str_len[4];
+  SQLUSMALLINT status[4];
+  SQLULEN     fetched= 0;
+  DECLARE_BASIC_HANDLES(henv1, hdbc1, hstmt1);
+
+  is(OK == alloc_basic_handles_with_opt(&henv1, &hdbc1, &hstmt1, NULL,
+                                        NULL, NULL, NULL, "NO_SSPS=1"));
+
+  ok_sql(hstmt1, "DROP TABLE IF EXISTS t_column_wise_block");
+  ok_sql(hstmt1, "CREATE TABLE t_column_wise_block (k INT, id BIGINT, "
+                 "big BIGINT, n INT, s VARCHAR(20))");
+  ok_sql(hstmt1, "INSERT INTO t_column_wise_block VALUES "
+                 "(1, 1, -9000000000, 10, 'a'), (2, 2, NULL, NULL, NULL),"
+                 "(3, 3000000000, 3, 30, 'c'), (4, 4, 4, -40, 'd'),"
+                 "(5, 5, 5, 50, 'e')");
+
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_ARRAY_SIZE,
+                                 (SQLPOINTER)4, 0));
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROW_STATUS_PTR, status, 0));
+  ok_stmt(hstmt1, SQLSetStmtAttr(hstmt1, SQL_ATTR_ROWS_FETCHED_PTR,
+                                 &fetched, 0));
+
+  ok_sql(hstmt1, "SELECT id, big, n, s FROM t_column_wise_block ORDER BY k");
+
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 1, SQL_C_LONG, id, 0, id_len));
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 2, SQL_C_SBIGINT, big, 0, big_len));
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 3, SQL_C_DOUBLE, dbl, 0, dbl_len));
+  ok_stmt(hstmt1, SQLBindCol(hstmt1, 4, SQL_C_CHAR, str, sizeof(str[0]),
+                             str_len));
+
+  expect_stmt(hstmt1, SQLFetch(hstmt1), SQL_SUCCESS_WITH_INFO);
+  is_num(fetched, 4);
+
+  is_num(status[0], SQL_ROW_SUCCESS);
+  is_num(id[0], 1);
+  is_num(big[0], -9000000000LL);
+  is_num(dbl[0], 10.0);
+  is_str(str[0], "a", 2);
+
+  is_num(status[1], SQL_ROW_SUCCESS);
+  is_num(id[1], 2);
+  is_num(big_len[1], SQL_NULL_DATA);
+  is_num(dbl_len[1], SQL_NULL_DATA);
+  is_num(str_len[1], SQL_NULL_DATA);
+
+  /* Only the row with the value that does not fit SQL_C_LONG fails */
+  is_num(status[2], SQL_ROW_ERROR);
+  is_num(big[2], 3);
+  is_num(dbl[2], 30.0);
+  is_str(str[2], "c", 2);
+
+  is_num(status[3], SQL_ROW_SUCCESS);
+  is_num(id[3], 4);
+  is_num(id_len[3], sizeof(SQLINTEGER));
+  is_num(big[3], 4);
+  is_num(dbl[3], -40.0);
+  is_str(str[3], "d", 2);
+
+  ok_stmt(hstmt1, SQLFetch(hstmt1));
+  is_num(fetched, 1);
+  is_num(status[0], SQL_ROW_SUCCESS);
+  is_num(id[0], 5);
+  is_num(big[0], 5);
+  is_num(status[1], SQL_ROW_NOROW);
+
+  expect_stmt(hstmt1, SQLFetch(hstmt1), SQL_NO_DATA);
+
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+  ok_sql(hstmt1, "DROP TABLE IF EXISTS t_column_wise_block");
+  free_basic_handles(&henv1, &hdbc1, &hstmt1);
+
+  return OK;
+}
+
 BEGIN_TESTS
   // ADD_TEST(t_bug11766437) TODO: fix Solaris Sparc
   ADD_TEST(t_bug32420)
@@ -1451,6 +1535,7 @@ BEGIN_TESTS
   ADD_TEST(t_bug17311065)
   ADD_TEST(t_prefetch_bug)
   ADD_TEST(t_bug28098219)
+  ADD_TEST(t_column_wise_block)
 END_TESTS
 
 
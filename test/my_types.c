@@ -1010,6 +1010,70 @@ DECLARE_TEST(t_sqlnum_from_str)
   is(OK == sqlnum_test_from_str(hstmt, "340282366920938463463374607431768211456", 39, 0, 1, expdata, 0, 1)); /* MAX+1 */}
   {SQLCHAR expdata[SQL_MAX_NUMERIC_LEN] = { 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 };
   is(OK == sqlnum_test_from_str(hstmt, "0", 1, 0, 1, expdata, 0, 0)); }
+  /* digits beyond the requested scale are truncated, not an overflow */
+  is(sqlnum_test_from_str(hstmt, "'1.00000000000000000000000000000000000000000005'",
+                          2, 1, 1, NULL, 10, 2) == OK);
+
+  return OK;
+}
+
+
+/*
+  Retrieving SQL_NUMERIC_STRUCT from a server-side prepared statement,
+  where integers are converted from their binary value and DECIMAL is
+  parsed straight from the bind buffer.
+*/
+DECLARE_TEST(t_sqlnum_ssps)
+{
+  SQL_NUMERIC_STRUCT num[3];
+  SQLHANDLE ard;
+  SQLCHAR prec[3] = {19, 22, 29};
+  SQLSCHAR scale[3] = {0, 2, 9};
+  SQLCHAR expdata[3][SQL_MAX_NUMERIC_LEN] = {
+    /* 1234567890123 */
+    {0xCB,0x04,0xFB,0x71,0x1F,0x01,0,0,0,0,0,0,0,0,0,0},
+    /* 18446744073709551615 with scale 2 */
+    {0x9C,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0x63,0,0,0,0,0,0,0},
+    /* 12345678901234567890.123456789 with scale 9 */
+    {0x15,0x81,0x39,0x6E,0xB1,0xC9,0xBE,0x46,0x32,0x1B,0xE4,0x27,0,0,0,0}};
+  SQLCHAR expsign[3] = {0, 1, 1};
+  int i;
+
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_sqlnum_ssps");
+  ok_sql(hstmt, "CREATE TABLE t_sqlnum_ssps (i BIGINT, u BIGINT UNSIGNED, "
+                "d DECIMAL(38,9))");
+  ok_sql(hstmt, "INSERT INTO t_sqlnum_ssps VALUES (-1234567890123, "
+                "18446744073709551615, 12345678901234567890.123456789)");
+
+  ok_stmt(hstmt, SQLPrepare(hstmt, (SQLCHAR *)
+                            "SELECT i, u, d FROM t_sqlnum_ssps", SQL_NTS));
+  ok_stmt(hstmt, SQLExecute(hstmt));
+
+  ok_stmt(hstmt, SQLGetStmtAttr(hstmt, SQL_ATTR_APP_ROW_DESC, &ard, 0, NULL));
+  for (i = 0; i < 3; ++i)
+  {
+    ok_desc(ard, SQLSetDescField(ard, i + 1, SQL_DESC_TYPE,
+      (SQLPOINTER)SQL_C_NUMERIC, SQL_IS_INTEGER));
+    ok_desc(ard, SQLSetDescField(ard, i + 1, SQL_DESC_PRECISION,
+      (SQLPOINTER)(size_t)prec[i], SQL_IS_INTEGER));
+    ok_desc(ard, SQLSetDescField(ard, i + 1, SQL_DESC_SCALE,
+      (SQLPOINTER)(size_t)scale[i], SQL_IS_INTEGER));
+    ok_desc(ard, SQLSetDescField(ard, i + 1, SQL_DESC_DATA_PTR,
+      &num[i], SQL_IS_POINTER));
+  }
+
+  ok_stmt(hstmt, SQLFetch(hstmt));
+
+  for (i = 0; i < 3; ++i)
+  {
+    is_num(num[i].precision, prec[i]);
+    is_num(num[i].scale, scale[i]);
+    is_num(num[i].sign, expsign[i]);
+    is(!memcmp(num[i].val, expdata[i], SQL_MAX_NUMERIC_LEN));
+  }
+
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+  ok_sql(hstmt, "DROP TABLE IF EXISTS t_sqlnum_ssps");
 
   return OK;
 }
@@ -1140,6 +1204,18 @@ DECLARE_TEST(t_sqlnum_to_str)
   {SQLCHAR numdata[]= {0xD5, 0x50, 0x94, 0x49, 0,0,0,0,0,0,0,0,0,0,0,0};
    is(OK == sqlnum_test_to_str(hstmt, numdata, 10, 20, 1, "0.00000000001234456789", ""));}
 
+  /* values at the boundaries of the 9 digit chunks */
+  {SQLCHAR numdata[]= {0xFF, 0xC9, 0x9A, 0x3B, 0,0,0,0,0,0,0,0,0,0,0,0};
+   is(OK == sqlnum_test_to_str(hstmt, numdata, 9, 9, 1, "0.999999999", ""));}
+  {SQLCHAR numdata[]= {0x00, 0xCA, 0x9A, 0x3B, 0,0,0,0,0,0,0,0,0,0,0,0};
+   is(OK == sqlnum_test_to_str(hstmt, numdata, 10, 9, 1, "1.000000000", ""));}
+  {SQLCHAR numdata[]= {0x00, 0xCA, 0x9A, 0x3B, 0,0,0,0,0,0,0,0,0,0,0,0};
+   is(OK == sqlnum_test_to_str(hstmt, numdata, 10, 0, 0, "-1000000000", ""));}
+  {SQLCHAR numdata[]= {0x00, 0x00, 0x64, 0xA7, 0xB3, 0xB6, 0xE0, 0x0D,
+                       0,0,0,0,0,0,0,0};
+   is(OK == sqlnum_test_to_str(hstmt, numdata, 19, 9, 1,
+                               "1000000000.000000000", ""));}
+
   return OK;
 }
 
@@ -1636,6 +1712,75 @@ DECLARE_TEST(t_wide_character_info)
   return OK;
 }
 
+
+/*
+  Numeric conversions of the text values: overflow of the target C type
+  must give 22003 and a dropped fractional part 01S07.
+*/
+DECLARE_TEST(t_numeric_text_conversion)
+{
+  SQLINTEGER int_val= 0;
+  SQLUINTEGER uint_val= 0;
+  SQLBIGINT bigint_val= 0;
+  SQLUBIGINT ubigint_val= 0;
+  SQLDOUBLE double_val= 0;
+  SQLREAL float_val= 0;
+  SQLLEN outlen= 0;
+
+  ok_sql(hstmt, "SELECT 2147483647, 2147483648, -2147483648, 12.75, "
+                "'1.5e3', 18446744073709551615, -1, 1e300, "
+                "0.1, '-00000001234.500'");
+  ok_stmt(hstmt, SQLFetch(hstmt));
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 1, SQL_C_LONG, &int_val, 0, &outlen));
+  is_num(int_val, 2147483647);
+
+  expect_stmt(hstmt, SQLGetData(hstmt, 2, SQL_C_LONG, &int_val, 0, &outlen),
+              SQL_ERROR);
+  is_num(check_sqlstate(hstmt, "22003"), OK);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 2, SQL_C_ULONG, &uint_val, 0, &outlen));
+  is(uint_val == 2147483648U);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 3, SQL_C_LONG, &int_val, 0, &outlen));
+  is_num(int_val, -2147483647 - 1);
+
+  expect_stmt(hstmt, SQLGetData(hstmt, 4, SQL_C_LONG, &int_val, 0, &outlen),
+              SQL_SUCCESS_WITH_INFO);
+  is_num(check_sqlstate(hstmt, "01S07"), OK);
+  is_num(int_val, 12);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 5, SQL_C_SBIGINT, &bigint_val, 0, &outlen));
+  is(bigint_val == 1500);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 6, SQL_C_UBIGINT, &ubigint_val, 0, &outlen));
+  is(ubigint_val == 18446744073709551615ULL);
+
+  expect_stmt(hstmt, SQLGetData(hstmt, 6, SQL_C_SBIGINT, &bigint_val, 0,
+                                &outlen), SQL_ERROR);
+  is_num(check_sqlstate(hstmt, "22003"), OK);
+
+  expect_stmt(hstmt, SQLGetData(hstmt, 7, SQL_C_UBIGINT, &ubigint_val, 0,
+                                &outlen), SQL_ERROR);
+  is_num(check_sqlstate(hstmt, "22003"), OK);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 8, SQL_C_DOUBLE, &double_val, 0, &outlen));
+  is(double_val == 1e300);
+
+  expect_stmt(hstmt, SQLGetData(hstmt, 8, SQL_C_FLOAT, &float_val, 0, &outlen),
+              SQL_ERROR);
+  is_num(check_sqlstate(hstmt, "22003"), OK);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 9, SQL_C_DOUBLE, &double_val, 0, &outlen));
+  is(double_val == 0.1);
+
+  ok_stmt(hstmt, SQLGetData(hstmt, 10, SQL_C_DOUBLE, &double_val, 0, &outlen));
+  is(double_val == -1234.5);
+
+  ok_stmt(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+  return OK;
+}
+
 BEGIN_TESTS
   ADD_TEST(t_wide_character_info)
   ADD_TEST(t_bug28783266)
@@ -1653,6 +1798,7 @@ BEGIN_TESTS
   ADD_TEST(binary_suffix)
   ADD_TEST(t_sqlnum_msdn)
   ADD_TEST(t_sqlnum_from_str)
+  ADD_TEST(t_sqlnum_ssps)
 #endif
   ADD_TEST(t_bug16917)
   ADD_TEST(t_bug16235)
@@ -1668,6 +1814,7 @@ BEGIN_TESTS
   ADD_TEST(t_bug29402)
   ADD_TEST(t_bug67793)
   ADD_TEST(t_bug69545)
+  ADD_TEST(t_numeric_text_conversion)
 END_TESTS
 
 
@@ -599,6 +599,89 @@ DECLARE_TEST(sqldescribecol)
 }
 
 
+/*
+  Column names given out by SQLDescribeColW and SQLColAttributeW are kept
+  converted with the result, asking again gives the same, and a new result
+  on the statement gives its own names.
+*/
+DECLARE_TEST(sqldescribecol_cached)
+{
+  HDBC hdbc1;
+  HSTMT hstmt1;
+  SQLWCHAR wbuff[MAX_ROW_DATA_LEN+1];
+  SQLSMALLINT len;
+  int i;
+
+  ok_env(henv, SQLAllocConnect(henv, &hdbc1));
+  ok_con(hdbc1, SQLConnectW(hdbc1, WC(mydsn), SQL_NTS, WC(myuid), SQL_NTS,
+                            WC(mypwd), SQL_NTS));
+
+  ok_con(hdbc1, SQLAllocStmt(hdbc1, &hstmt1));
+
+  ok_sql(hstmt1, "DROP TABLE IF EXISTS t_desc_cached");
+  ok_stmt(hstmt1, SQLExecDirectW(hstmt1,
+                                 W(L"CREATE TABLE t_desc_cached "
+                                   L"(a\x00e3g INT, b INT)"), SQL_NTS));
+
+  ok_stmt(hstmt1, SQLExecDirectW(hstmt1,
+                                 W(L"SELECT a\x00e3g AS l\x00e3bel, b "
+                                   L"FROM t_desc_cached AS t"), SQL_NTS));
+
+  for (i= 0; i < 2; ++i)
+  {
+    ok_stmt(hstmt1, SQLDescribeColW(hstmt1, 1, wbuff,
+                                    sizeof(wbuff) / sizeof(wbuff[0]), &len,
+                                    NULL, NULL, NULL, NULL));
+    is_num(len, 5);
+    is_wstr(sqlwchar_to_wchar_t(wbuff), L"l\x00e3" L"bel", 6);
+
+    ok_stmt(hstmt1, SQLColAttributeW(hstmt1, 1, SQL_DESC_LABEL,
+                                     wbuff, sizeof(wbuff), &len, NULL));
+    is_num(len, 5 * sizeof(SQLWCHAR));
+    is_wstr(sqlwchar_to_wchar_t(wbuff), L"l\x00e3" L"bel", 6);
+
+    ok_stmt(hstmt1, SQLColAttributeW(hstmt1, 1, SQL_DESC_BASE_COLUMN_NAME,
+                                     wbuff, sizeof(wbuff), &len, NULL));
+    is_num(len, 3 * sizeof(SQLWCHAR));
+    is_wstr(sqlwchar_to_wchar_t(wbuff), L"a\x00e3g", 4);
+
+    ok_stmt(hstmt1, SQLColAttributeW(hstmt1, 1, SQL_DESC_TABLE_NAME,
+                                     wbuff, sizeof(wbuff), &len, NULL));
+    is_num(len, 1 * sizeof(SQLWCHAR));
+    is_wstr(sqlwchar_to_wchar_t(wbuff), L"t", 2);
+
+    /* Truncated from the kept copy */
+    expect_stmt(hstmt1, SQLDescribeColW(hstmt1, 1, wbuff, 3, &len,
+                                        NULL, NULL, NULL, NULL),
+                SQL_SUCCESS_WITH_INFO);
+    is_num(len, 5);
+    is_wstr(sqlwchar_to_wchar_t(wbuff), L"l\x00e3", 3);
+  }
+
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  ok_sql(hstmt1, "SELECT b AS other FROM t_desc_cached");
+  ok_stmt(hstmt1, SQLDescribeColW(hstmt1, 1, wbuff,
+                                  sizeof(wbuff) / sizeof(wbuff[0]), &len,
+                                  NULL, NULL, NULL, NULL));
+  is_num(len, 5);
+  is_wstr(sqlwchar_to_wchar_t(wbuff), L"other", 6);
+  ok_stmt(hstmt1, SQLColAttributeW(hstmt1, 1, SQL_DESC_TABLE_NAME,
+                                   wbuff, sizeof(wbuff), &len, NULL));
+  is_wstr(sqlwchar_to_wchar_t(wbuff), L"t_desc_cached", 14);
+
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_CLOSE));
+
+  ok_sql(hstmt1, "DROP TABLE IF EXISTS t_desc_cached");
+
+  ok_stmt(hstmt1, SQLFreeStmt(hstmt1, SQL_DROP));
+  ok_con(hdbc1, SQLDisconnect(hdbc1));
+  ok_con(hdbc1, SQLFreeConnect(hdbc1));
+
+  return OK;
+}
+
+
 DECLARE_TEST(sqlgetconnectattr)
 {
   HDBC hdbc1;
@@ -1505,6 +1588,7 @@ BEGIN_TESTS
   // ADD_TEST(sqlnativesql) TODO: Fix
   ADD_TEST_UNICODE(sqlcolattribute)
   ADD_TEST_UNICODE(sqldescribecol)
+  ADD_TEST_UNICODE(sqldescribecol_cached)
 #ifndef USE_IODBC
   ADD_TEST(sqlsetcursorname)
   ADD_TEST(sqlgetcursorname)
@@ -192,6 +192,36 @@ static SQLWCHAR W_DFLT_BIGINT_BIND_STR[]=
 static SQLWCHAR W_CLIENT_INTERACTIVE[]=
   {'I','N','T','E','R','A','C','T','I','V','E',0};
 static SQLWCHAR W_PREFETCH[]= {'P','R','E','F','E','T','C','H',0};
+static SQLWCHAR W_MAX_LOB_BUFFER[]=
+  {'M','A','X','_','L','O','B','_','B','U','F','F','E','R',0};
+static SQLWCHAR W_PING_INTERVAL[]=
+  {'P','I','N','G','_','I','N','T','E','R','V','A','L',0};
+static SQLWCHAR W_POOLING[]= {'P','O','O','L','I','N','G',0};
+static SQLWCHAR W_POOL_MIN_IDLE[]=
+  {'P','O','O','L','_','M','I','N','_','I','D','L','E',0};
+static SQLWCHAR W_POOL_MAX_IDLE[]=
+  {'P','O','O','L','_','M','A','X','_','I','D','L','E',0};
+static SQLWCHAR W_POOL_MAX_LIFETIME[]=
+  {'P','O','O','L','_','M','A','X','_','L','I','F','E','T','I','M','E',0};
+static SQLWCHAR W_PIPELINE_WINDOW[]=
+  {'P','I','P','E','L','I','N','E','_','W','I','N','D','O','W',0};
+static SQLWCHAR W_PIPELINE_STOP_ON_ERROR[]=
+  {'P','I','P','E','L','I','N','E','_','S','T','O','P','_','O','N','_',
+   'E','R','R','O','R',0};
+static SQLWCHAR W_BULK_LOAD_ROWS[]=
+  {'B','U','L','K','_','L','O','A','D','_','R','O','W','S',0};
+static SQLWCHAR W_RESULT_CACHE_TTL[]=
+  {'R','E','S','U','L','T','_','C','A','C','H','E','_','T','T','L',0};
+static SQLWCHAR W_RESULT_CACHE_SIZE[]=
+  {'R','E','S','U','L','T','_','C','A','C','H','E','_','S','I','Z','E',0};
+static SQLWCHAR W_MEMORY_SOFT_LIMIT[]=
+  {'M','E','M','O','R','Y','_','S','O','F','T','_','L','I','M','I','T',0};
+static SQLWCHAR W_MEMORY_HARD_LIMIT[]=
+  {'M','E','M','O','R','Y','_','H','A','R','D','_','L','I','M','I','T',0};
+static SQLWCHAR W_PERF_COUNTERS[]=
+  {'P','E','R','F','_','C','O','U','N','T','E','R','S',0};
+static SQLWCHAR W_PERF_DUMP_INTERVAL[]=
+  {'P','E','R','F','_','D','U','M','P','_','I','N','T','E','R','V','A','L',0};
 static SQLWCHAR W_NO_SSPS[]= {'N','O','_','S','S','P','S',0};
 static SQLWCHAR W_CAN_HANDLE_EXP_PWD[]=
   {'C','A','N','_','H','A','N','D','L','E','_','E','X','P','_','P','W','D',0};
@@ -235,6 +265,12 @@ static SQLWCHAR W_OPENTELEMETRY[] =
 { 'O', 'P', 'E', 'N', 'T', 'E', 'L', 'E', 'M', 'E', 'T', 'R', 'Y', 0};
 static SQLWCHAR W_OPENID_TOKEN_FILE[] =
 { 'O', 'P', 'E', 'N', 'I', 'D', '-', 'T', 'O', 'K', 'E', 'N', '-', 'F', 'I', 'L', 'E', 0};
+static SQLWCHAR W_COMPRESSION_ALGORITHMS[] =
+{ 'C', 'O', 'M', 'P', 'R', 'E', 'S', 'S', 'I', 'O', 'N', '-',
+  'A', 'L', 'G', 'O', 'R', 'I', 'T', 'H', 'M', 'S', 0};
+static SQLWCHAR W_ZSTD_COMPRESSION_LEVEL[] =
+{ 'Z', 'S', 'T', 'D', '-', 'C', 'O', 'M', 'P', 'R', 'E', 'S', 'S', 'I', 'O', 'N', '-',
+  'L', 'E', 'V', 'E', 'L', 0};
 
 /* DS_PARAM */
 /* externally used strings */
@@ -910,6 +946,8 @@ void DataSource::reset() {
   BOOL_OPTIONS_LIST(SET_DEFAULT_BOOL_OPTION);
 
   opt_PORT.set_default(3306);
+  opt_PING_INTERVAL.set_default(10);
+  opt_POOL_MAX_IDLE.set_default(8);
   opt_NO_SCHEMA = 1;
 }
 
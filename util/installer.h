@@ -289,12 +289,18 @@ class Driver {
                   X(OCI_CONFIG_FILE) X(OCI_CONFIG_PROFILE)                 \
                       X(AUTHENTICATION_KERBEROS_MODE) X(TLS_VERSIONS)      \
                            X(SSL_CRL) X(SSL_CRLPATH) X(SSLVERIFY)          \
-                              X(OPENTELEMETRY) X(OPENID_TOKEN_FILE)
+                              X(OPENTELEMETRY) X(OPENID_TOKEN_FILE)        \
+                                  X(COMPRESSION_ALGORITHMS)
 
 #define INT_OPTIONS_LIST(X)                                         \
   X(PORT)                                                           \
   X(READTIMEOUT) X(WRITETIMEOUT) X(CLIENT_INTERACTIVE)              \
-      X(PREFETCH)
+      X(PREFETCH) X(MAX_LOB_BUFFER) X(PING_INTERVAL)                \
+          X(POOL_MIN_IDLE) X(POOL_MAX_IDLE) X(POOL_MAX_LIFETIME)    \
+              X(ZSTD_COMPRESSION_LEVEL) X(PIPELINE_WINDOW)          \
+                  X(BULK_LOAD_ROWS) X(RESULT_CACHE_TTL)             \
+                      X(RESULT_CACHE_SIZE) X(MEMORY_SOFT_LIMIT)     \
+                          X(MEMORY_HARD_LIMIT) X(PERF_DUMP_INTERVAL)
 
 // TODO: remove AUTO_RECONNECT when special handling (warning)
 //       is not needed anymore.
@@ -312,7 +318,10 @@ class Driver {
                                   X(NO_TLS_1_2) X(NO_TLS_1_3)                  \
                                       X(NO_DATE_OVERFLOW)                      \
                                           X(ENABLE_LOCAL_INFILE)               \
-                                              X(ENABLE_DNS_SRV) X(MULTI_HOST)
+                                              X(ENABLE_DNS_SRV) X(MULTI_HOST)  \
+                                                  X(POOLING)                   \
+                                                      X(PIPELINE_STOP_ON_ERROR)\
+                                                          X(PERF_COUNTERS)
 
 #define FULL_OPTIONS_LIST(X) \
   STR_OPTIONS_LIST(X) INT_OPTIONS_LIST(X) BOOL_OPTIONS_LIST(X)
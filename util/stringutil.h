@@ -57,6 +57,12 @@ extern "C" {
 
 #define MAX_BYTES_PER_UTF8_CP 4 /* max 4 bytes per utf8 codepoint */
 
+/* Status codes of the length-aware number parsers (numconv.cc) */
+#define MYODBC_NUM_OK         0
+#define MYODBC_NUM_TRUNC_FRAC 1 /* non-zero fractional part was dropped */
+#define MYODBC_NUM_OVERFLOW   2 /* value is out of range of the result type */
+#define MYODBC_NUM_INVALID    3 /* no number at all */
+
 extern myodbc::CHARSET_INFO *utf8_charset_info;
 extern myodbc::CHARSET_INFO *utf16_charset_info;
 extern const char* ansi_default_charset;
@@ -140,6 +146,12 @@ unsigned int get_charset_maxlen(unsigned int num);
 void delocalize_radix(char* buffer);
 double myodbc_strtod(const char *str, int len);
 
+/* numconv.cc */
+long long myodbc_parse_int64(const char *str, size_t len, int *status);
+unsigned long long myodbc_parse_uint64(const char *str, size_t len,
+                                       int *status);
+double myodbc_parse_double(const char *str, size_t len, int *status);
+
 #ifdef __cplusplus
 }
 #endif